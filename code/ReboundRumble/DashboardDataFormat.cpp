@@ -2,208 +2,258 @@
 #include "RobotInfo.h"
 
 DashboardDataFormat::DashboardDataFormat(void)
+    : ioTelemetry(&ioSchema,
+                  &DriverStation::GetInstance()->GetLowPriorityDashboardPacker(),
+                  IO_TELEMETRY_BUDGET)
 {
-    analogModule1 = AnalogModule::GetInstance(1);
-    analogModule2 = AnalogModule::GetInstance(2);
-    digitalModule1 = DigitalModule::GetInstance(1);
-    digitalModule2 = DigitalModule::GetInstance(2);
+    analogSlots[0].module = AnalogModule::GetInstance(1);
+    analogSlots[1].module = AnalogModule::GetInstance(2);
+    digitalSlots[0].module = DigitalModule::GetInstance(1);
+    digitalSlots[1].module = DigitalModule::GetInstance(2);
+    visionRecordKey =
+            SmartDashboard::GetInstance()->GetKeyHandle(VISION_RECORD_KEY);
+    BuildVisionSchema();
+    BuildIOSchema();
+
+    //
+    // A missing module is never sampled, its slots stay zero.
+    //
+    for (int m = 0; m < 2; m++)
+    {
+        if (analogSlots[m].module != NULL)
+        {
+            ioTelemetry.AddGroup(SampleAnalog, &analogSlots[m],
+                                 ANALOG_SAMPLE_PERIOD,
+                                 NUM_ANALOG_CHANNELS*sizeof(float));
+        }
+        if (digitalSlots[m].module != NULL)
+        {
+            ioTelemetry.AddGroup(SampleDIO, &digitalSlots[m],
+                                 DIO_SAMPLE_PERIOD,
+                                 2*sizeof(UINT8) + 2*sizeof(UINT16));
+            ioTelemetry.AddGroup(SamplePWM, &digitalSlots[m],
+                                 PWM_SAMPLE_PERIOD,
+                                 NUM_PWM_CHANNELS*sizeof(UINT8));
+        }
+    }
 }
 
 DashboardDataFormat::~DashboardDataFormat()
 {
 }
 
-void DashboardDataFormat::SendVisionData(
-        vector<ParticleAnalysisReport> *particles,
-        UINT8 currIdx)
+/**
+ * Declare the layout of the vision data once so that sending it is only a
+ * matter of filling in the target rectangles.
+ */
+void DashboardDataFormat::BuildVisionSchema(void)
 {
-    Dashboard &dash =
-            DriverStation::GetInstance()->GetHighPriorityDashboardPacker();
-    
-    //
-    // Vision target Info.
-    //
-    dash.AddCluster();                  //Begin: Target Info
+    visionSchema.AddCluster();                  //Begin: Target Info
+    for (int i = 0; i < VISION_MAX_TARGETS; i++)
     {
-        int targetsSent = 0;
-        //
-        // Loop through all particles, but stop after you send 4
-        //
-        for (unsigned i = 0; i < particles->size() && targetsSent < 4; i++)
+        visionSchema.AddCluster();              //  Begin: Target Rect
         {
-            ParticleAnalysisReport *p = &(particles->at(i));
-            float aspectRatio = p->boundingRect.width/
-                                p->boundingRect.height;
-
-            if (aspectRatio >= MINIMUM_TARGET_ASPECT_RATIO && 
-                aspectRatio <= MAXIMUM_TARGET_ASPECT_RATIO)
-            {
-                targetsSent++;
-                dash.AddCluster();      //  Begin: Target Rect
-                {
-                    //
-                    // The dashboard will select color based on this bool
-                    //
-                    dash.AddBoolean(i == currIdx);  
-                    dash.AddU32(p->boundingRect.left);
-                    dash.AddU32(p->boundingRect.top);
-                    dash.AddU32(p->boundingRect.left +
-                                p->boundingRect.width);
-                    dash.AddU32(p->boundingRect.top +
-                                p->boundingRect.height);
-                }
-                dash.FinalizeCluster(); //  End: Target Rect
-            }
-        }
-        
-        //
-        // If we have less than 4 targets, we need to send null info for
-        // the rest.
-        //
-        while (targetsSent < 4)
-        {
-            targetsSent++;
-            dash.AddCluster();          //  Begin: Target Rect
-            {
-                dash.AddBoolean(false);
-                dash.AddU32(0);
-                dash.AddU32(0);
-                dash.AddU32(0);
-                dash.AddU32(0);
-            }
-            dash.FinalizeCluster();     //  End: Target Rect
+            //
+            // The dashboard will select color based on this bool
+            //
+            targetSlots[i].selected = visionSchema.AddField(Dashboard::kBoolean);
+            targetSlots[i].left = visionSchema.AddField(Dashboard::kU32);
+            targetSlots[i].top = visionSchema.AddField(Dashboard::kU32);
+            targetSlots[i].right = visionSchema.AddField(Dashboard::kU32);
+            targetSlots[i].bottom = visionSchema.AddField(Dashboard::kU32);
         }
+        visionSchema.FinalizeCluster();         //  End: Target Rect
     }
-    dash.FinalizeCluster();             //End: Target Info
-    dash.Finalize();
+    visionSchema.FinalizeCluster();             //End: Target Info
+    visionSchema.Compile();
 }
 
-void DashboardDataFormat::SendIOPortData()
+/**
+ * Declare the layout of the I/O port data once so that sending it is only a
+ * matter of filling in the channel values.
+ */
+void DashboardDataFormat::BuildIOSchema(void)
 {
-    Dashboard &dash =
-            DriverStation::GetInstance()->GetLowPriorityDashboardPacker();
-    dash.AddCluster();
+    ioSchema.AddCluster();
     {
-        dash.AddCluster();
-        { //analog modules 
-            dash.AddCluster();
+        ioSchema.AddCluster();
+        { //analog modules
+            for (int m = 0; m < 2; m++)
             {
-                if (analogModule1 != NULL)
+                ioSchema.AddCluster();
                 {
-                    for (int i = 1; i <= 8; i++)
+                    for (int i = 0; i < NUM_ANALOG_CHANNELS; i++)
                     {
-                        dash.AddFloat(
-                                (float) analogModule1->GetAverageVoltage(i));
-                    }
-                }
-                else
-                {
-                    for (int i = 1; i <= 8; i++)
-                    {
-                        dash.AddFloat(0.0);
-                    }
-                }
-            }
-            dash.FinalizeCluster();
-            dash.AddCluster();
-            {
-                if (analogModule2 != NULL)
-                {
-                    for (int i = 1; i <= 8; i++)
-                    {
-                        dash.AddFloat(
-                                (float) analogModule2->GetAverageVoltage(i));
-                    }
-                }
-                else
-                {
-                    for (int i = 1; i <= 8; i++)
-                    {
-                        dash.AddFloat(0.0);
+                        analogSlots[m].channels[i] =
+                                ioSchema.AddField(Dashboard::kFloat);
                     }
                 }
+                ioSchema.FinalizeCluster();
             }
-            dash.FinalizeCluster();
         }
-        dash.FinalizeCluster();
+        ioSchema.FinalizeCluster();
 
-        dash.AddCluster();
+        ioSchema.AddCluster();
         { //digital modules
-            dash.AddCluster();
+            for (int m = 0; m < 2; m++)
             {
-                if (digitalModule1 != NULL)
+                DigitalSlots *slots = &digitalSlots[m];
+
+                ioSchema.AddCluster();
                 {
-                    dash.AddU8(digitalModule1->GetRelayForward());
-                    dash.AddU8(digitalModule1->GetRelayReverse());
-                    dash.AddU16((short) digitalModule1->GetDIO());
-                    dash.AddU16((short) digitalModule1->GetDIODirection());
-                    dash.AddCluster();
+                    slots->relayForward = ioSchema.AddField(Dashboard::kU8);
+                    slots->relayReverse = ioSchema.AddField(Dashboard::kU8);
+                    slots->dio = ioSchema.AddField(Dashboard::kU16);
+                    slots->dioDirection = ioSchema.AddField(Dashboard::kU16);
+                    ioSchema.AddCluster();
                     {
-                        for (int i = 1; i <= 10; i++)
+                        for (int i = 0; i < NUM_PWM_CHANNELS; i++)
                         {
-                            dash.AddU8(
-                                    (unsigned char) digitalModule1->GetPWM(
-                                            i));
+                            slots->pwm[i] = ioSchema.AddField(Dashboard::kU8);
                         }
                     }
-                    dash.FinalizeCluster();
-                }
-                else
-                {
-                    dash.AddU8(0);
-                    dash.AddU8(0);
-                    dash.AddU16(0);
-                    dash.AddU16(0);
-                    dash.AddCluster();
-                    {
-                        for (int i = 1; i <= 10; i++)
-                            dash.AddU8(0);
-                    }
-                    dash.FinalizeCluster();
+                    ioSchema.FinalizeCluster();
                 }
+                ioSchema.FinalizeCluster();
             }
-            dash.FinalizeCluster();
+        }
+        ioSchema.FinalizeCluster();
+
+        // Can't read solenoids without an instance of the object
+        solenoidSlot = ioSchema.AddField(Dashboard::kU8);
+    }
+    ioSchema.FinalizeCluster();
+    ioSchema.Compile();
+}
+
+void DashboardDataFormat::SendVisionData(
+        ParticleAnalysisReport *particles,
+        int numParticles,
+        UINT8 currIdx)
+{
+    VisionRecord record;
+    int targetsSent = 0;
+
+    memset(&record, 0, sizeof(record));
+    record.selected = VISION_NO_SELECTION;
+
+    //
+    // Loop through all particles, but stop after you send 4
+    //
+    for (int i = 0;
+         i < numParticles && targetsSent < VISION_MAX_TARGETS;
+         i++)
+    {
+        ParticleAnalysisReport *p = &particles[i];
+        float aspectRatio = p->boundingRect.width/
+                            p->boundingRect.height;
+
+        if (aspectRatio >= MINIMUM_TARGET_ASPECT_RATIO &&
+            aspectRatio <= MAXIMUM_TARGET_ASPECT_RATIO)
+        {
+            UINT16 *rect = record.rects[targetsSent];
+            TargetSlots *slots = &targetSlots[targetsSent];
 
-            dash.AddCluster();
+            rect[0] = (UINT16)p->boundingRect.left;
+            rect[1] = (UINT16)p->boundingRect.top;
+            rect[2] = (UINT16)(p->boundingRect.left +
+                               p->boundingRect.width);
+            rect[3] = (UINT16)(p->boundingRect.top +
+                               p->boundingRect.height);
+            if (i == currIdx)
             {
-                if (digitalModule2 != NULL)
-                {
-                    dash.AddU8(digitalModule2->GetRelayForward());
-                    dash.AddU8(digitalModule2->GetRelayForward());
-                    dash.AddU16((short) digitalModule2->GetDIO());
-                    dash.AddU16(digitalModule2->GetDIODirection());
-                    dash.AddCluster();
-                    {
-                        for (int i = 1; i <= 10; i++)
-                        {
-                            dash.AddU8(
-                                    (unsigned char) digitalModule2->GetPWM(
-                                            i));
-                        }
-                    }
-                    dash.FinalizeCluster();
-                }
-                else
-                {
-                    dash.AddU8(0);
-                    dash.AddU8(0);
-                    dash.AddU16(0);
-                    dash.AddU16(0);
-                    dash.AddCluster();
-                    {
-                        for (int i = 1; i <= 10; i++)
-                            dash.AddU8(0);
-                    }
-                    dash.FinalizeCluster();
-                }
+                record.selected = (UINT8)targetsSent;
             }
-            dash.FinalizeCluster();
+
+            visionSchema.SetBoolean(slots->selected, i == currIdx);
+            visionSchema.SetU32(slots->left, p->boundingRect.left);
+            visionSchema.SetU32(slots->top, p->boundingRect.top);
+            visionSchema.SetU32(slots->right,
+                                p->boundingRect.left +
+                                p->boundingRect.width);
+            visionSchema.SetU32(slots->bottom,
+                                p->boundingRect.top +
+                                p->boundingRect.height);
+            targetsSent++;
         }
-        dash.FinalizeCluster();
+    }
 
-        // Can't read solenoids without an instance of the object
-        dash.AddU8((char) 0);
+    record.numTargets = (UINT8)targetsSent;
+
+    //
+    // If we have less than 4 targets, we need to send null info for
+    // the rest.
+    //
+    for (int i = targetsSent; i < VISION_MAX_TARGETS; i++)
+    {
+        TargetSlots *slots = &targetSlots[i];
+
+        visionSchema.SetBoolean(slots->selected, false);
+        visionSchema.SetU32(slots->left, 0);
+        visionSchema.SetU32(slots->top, 0);
+        visionSchema.SetU32(slots->right, 0);
+        visionSchema.SetU32(slots->bottom, 0);
+    }
+
+    visionSchema.Send(
+        DriverStation::GetInstance()->GetHighPriorityDashboardPacker());
+
+    //
+    // Send the same targets to the SmartDashboard as one record instead of
+    // twenty separate values.
+    //
+    SmartDashboard::GetInstance()->PutRecord(visionRecordKey,
+                                             &record,
+                                             sizeof(record));
+}
+
+/**
+ * Sample the average voltages of one analog module.
+ */
+void DashboardDataFormat::SampleAnalog(DashboardSchema *schema, void *param)
+{
+    AnalogSlots *slots = (AnalogSlots *)param;
+
+    for (int i = 0; i < NUM_ANALOG_CHANNELS; i++)
+    {
+        schema->SetFloat(slots->channels[i],
+                         (float)slots->module->GetAverageVoltage(i + 1));
+    }
+}
+
+/**
+ * Sample the relays and DIO of one digital module.
+ */
+void DashboardDataFormat::SampleDIO(DashboardSchema *schema, void *param)
+{
+    DigitalSlots *slots = (DigitalSlots *)param;
+    DigitalModule *module = slots->module;
+
+    schema->SetU8(slots->relayForward, module->GetRelayForward());
+    schema->SetU8(slots->relayReverse, module->GetRelayReverse());
+    schema->SetU16(slots->dio, module->GetDIO());
+    schema->SetU16(slots->dioDirection, module->GetDIODirection());
+}
+
+/**
+ * Sample the PWM outputs of one digital module.
+ */
+void DashboardDataFormat::SamplePWM(DashboardSchema *schema, void *param)
+{
+    DigitalSlots *slots = (DigitalSlots *)param;
+
+    for (int i = 0; i < NUM_PWM_CHANNELS; i++)
+    {
+        schema->SetU8(slots->pwm[i],
+                      (unsigned char)slots->module->GetPWM(i + 1));
     }
-    dash.FinalizeCluster();
-    dash.Finalize();
+}
+
+/**
+ * Send the I/O port data that is due and has changed.  The dashboard keeps
+ * showing the last values sent for everything else.
+ */
+void DashboardDataFormat::SendIOPortData()
+{
+    ioTelemetry.Run();
 }
@@ -3,6 +3,33 @@
 
 #include "WPILib.h"
 
+#define VISION_RECORD_KEY       "VisionTargets"
+#define VISION_MAX_TARGETS      4
+#define VISION_NO_SELECTION     0xff
+#define NUM_ANALOG_CHANNELS     8
+#define NUM_PWM_CHANNELS        10
+
+//
+// I/O port telemetry: the most bytes sampled per loop and the time in seconds
+// between samples of each group.  Groups that have not changed are not sent.
+//
+#define IO_TELEMETRY_BUDGET     48
+#define ANALOG_SAMPLE_PERIOD    0.1
+#define DIO_SAMPLE_PERIOD       0.05
+#define PWM_SAMPLE_PERIOD       0.1
+
+/**
+ * The vision targets as sent to the SmartDashboard in one record: the same
+ * four rectangles and selection sent to the LabVIEW dashboard.  Fields are in
+ * the robot's (big-endian) byte order and the layout has no padding.
+ */
+typedef struct
+{
+	UINT16 rects[VISION_MAX_TARGETS][4];	// left, top, right, bottom
+	UINT8 numTargets;
+	UINT8 selected;							// index into rects
+} VisionRecord;
+
 /**
  * This class is just an example of one way you could organize the data that you want
  * to send to the dashboard.  The PackAndSend method does all the work.  You could
@@ -20,15 +47,54 @@ public:
 	DashboardDataFormat(void);
 	virtual ~DashboardDataFormat();
 	void SendIOPortData(void);
-	void SendVisionData(vector<ParticleAnalysisReport> *particles,
+	void SendVisionData(ParticleAnalysisReport *particles,
+                        int numParticles,
                         UINT8 currIdx);
 
 private:
 	DISALLOW_COPY_AND_ASSIGN(DashboardDataFormat);
-	AnalogModule *analogModule1;
-	AnalogModule *analogModule2;
-	DigitalModule *digitalModule1;
-	DigitalModule *digitalModule2;
+	void BuildVisionSchema(void);
+	void BuildIOSchema(void);
+	static void SampleAnalog(DashboardSchema *schema, void *param);
+	static void SampleDIO(DashboardSchema *schema, void *param);
+	static void SamplePWM(DashboardSchema *schema, void *param);
+
+	// Slots of one target rectangle in the vision schema
+	typedef struct
+	{
+		DashboardSchema::Slot selected;
+		DashboardSchema::Slot left;
+		DashboardSchema::Slot top;
+		DashboardSchema::Slot right;
+		DashboardSchema::Slot bottom;
+	} TargetSlots;
+
+	// One analog module and its slots in the I/O schema
+	typedef struct
+	{
+		AnalogModule *module;
+		DashboardSchema::Slot channels[NUM_ANALOG_CHANNELS];
+	} AnalogSlots;
+
+	// One digital module and its slots in the I/O schema
+	typedef struct
+	{
+		DigitalModule *module;
+		DashboardSchema::Slot relayForward;
+		DashboardSchema::Slot relayReverse;
+		DashboardSchema::Slot dio;
+		DashboardSchema::Slot dioDirection;
+		DashboardSchema::Slot pwm[NUM_PWM_CHANNELS];
+	} DigitalSlots;
+
+	NetworkTables::Key *visionRecordKey;
+	DashboardSchema visionSchema;
+	TargetSlots targetSlots[VISION_MAX_TARGETS];
+	DashboardSchema ioSchema;
+	AnalogSlots analogSlots[2];
+	DigitalSlots digitalSlots[2];
+	DashboardSchema::Slot solenoidSlot;
+	DashboardTelemetry ioTelemetry;
 };
 
 #endif // __DashboardDataFormat_h__
@@ -857,6 +857,12 @@ public:
         m_Ki *= 100000000.0;
         m_Kd *= 100000000.0;
         //
+        // Run vision at full rate while turning to the target.
+        //
+        m_visionTarget->SetFastTracking(
+            m_shooterSM.IsEnabled() &&
+            (m_shooterSM.GetCurrentState() == SMSTATE_TURN_TO_TARGET));
+        //
         // Update target information.
         //
         if (m_visionTarget->GetTargetInfo(m_targetID, &m_targetInfo))
@@ -62,6 +62,16 @@ private:
     // VisionTarget Subsystem.
     //
     VisionTarget        m_visionTarget;
+#ifdef _BENCH_PERF
+    //
+    // NetworkTables benchmark.
+    //
+    NetTablesBench      m_netTablesBench;
+    //
+    // LCD text formatting benchmark.
+    //
+    FormatBench         m_formatBench;
+#endif
     //
     // Shoot Subsystem.
     //
@@ -124,7 +134,11 @@ public:
          , m_driveBase(&m_leftFrontMotor, &m_leftRearMotor,
                        &m_rightFrontMotor, &m_rightRearMotor)
          , m_driveEvent()
-         , m_visionTarget(&m_dashboardDataFormat)
+         , m_visionTarget(&m_dashboardDataFormat, this)
+#ifdef _BENCH_PERF
+         , m_netTablesBench()
+         , m_formatBench()
+#endif
          , m_shooter(&m_visionTarget, &m_driveBase, &m_pickup, &m_ballgate)
          , m_shooterEvent()
          , m_ballgate(SOL_BALLGATE_CLOSE, SOL_BALLGATE_OPEN, SOL_MODULE2)
@@ -160,6 +160,7 @@
 
 #define MINIMUM_TARGET_ASPECT_RATIO     0.50
 #define MAXIMUM_TARGET_ASPECT_RATIO     2.00
+#define VISION_CPU_BUDGET               0.30            //portion of CPU
 
 //
 //
@@ -27,6 +27,8 @@ typedef struct _targetInfo
     float distance;
     float height;
     float angle;
+    UINT32 frameNumber;
+    UINT32 frameTime;
 } TARGETINFO, *PTARGETINFO;
 
 /**
@@ -36,14 +38,28 @@ typedef struct _targetInfo
  * returns a list of target objects.
  */
 class VisionTarget: public CoopTask
+#ifdef _BENCH_PERF
+                  , public VisionBenchNotify
+#endif
 {
 private:
     DashboardDataFormat*m_dashboardDataFormat;
+    CoopMTRobot        *m_robot;
+#ifdef _BENCH_PERF
+    CameraBench         m_cameraBench;
+#endif
     AxisCamera&         m_camera;
     Relay               m_ringLightPower;
     Threshold           m_colorThresholds;
     VisionTask          m_visionTask;
+#ifdef _BENCH_PERF
+    VisionBench         m_visionBench;
+#endif
     ParticleFilterCriteria2 m_filterCriteria[2];
+    INT32               m_opPoint;
+    float               m_procTime;
+    float               m_latency;
+    UINT32              m_dashFrameNumber;
 
 public:
     void SetRingLightOn(bool fOn)
@@ -58,14 +74,39 @@ public:
         }
     }   //SetRingLightOn
 
+    /**
+     * This function runs vision at full rate while the robot is tracking a
+     * target.
+     *
+     * @param fEnable If true, enables fast tracking, disables otherwise.
+     */
+    void SetFastTracking(bool fEnable)
+    {
+        m_visionTask.SetFastTracking(fEnable);
+    }   //SetFastTracking
+
     /**
      * Constructor for the class object.
      * Create instances of all the components.
+     *
+     * @param dashboardDataFormat Points to the dashboard data object.
+     * @param robot Points to the robot object for main loop timing.
      */
     VisionTarget(
-        DashboardDataFormat *dashboardDataFormat
+        DashboardDataFormat *dashboardDataFormat,
+        CoopMTRobot *robot
         ): m_dashboardDataFormat(dashboardDataFormat)
+         , m_robot(robot)
+#ifdef _BENCH_PERF
+        //
+        // The camera is reached through the relay of the camera bench so
+        // that faults can be injected into the image stream.
+        //
+         , m_cameraBench(CAMERA_IP)
+         , m_camera(AxisCamera::GetInstance(CB_RELAY_IP, CB_RELAY_PORT))
+#else
          , m_camera(AxisCamera::GetInstance(CAMERA_IP))
+#endif
          , m_ringLightPower(RELAY_RINGLIGHT_POWER, Relay::kForwardOnly)
         //
         // Good green values: RGB(0/100, 80/140, 40/140)
@@ -78,6 +119,13 @@ public:
                         2,
                         m_filterCriteria,
                         ARRAYSIZE(m_filterCriteria))
+#ifdef _BENCH_PERF
+         , m_visionBench(&m_visionTask, this)
+#endif
+         , m_opPoint(0)
+         , m_procTime(0.0)
+         , m_latency(0.0)
+         , m_dashFrameNumber(0)
     {
         TLevel( INIT);
         TEnter();
@@ -107,8 +155,23 @@ public:
         m_filterCriteria[2].calibrated = false;
         m_filterCriteria[2].exclude = false;
 #endif
-
-        RegisterTask(MOD_NAME, TASK_START_MODE | TASK_STOP_MODE);
+        //
+        // Let the vision task trade frame rate and resolution for CPU time
+        // as the load changes.
+        //
+        m_visionTask.SetAdaptiveRate(true, VISION_CPU_BUDGET);
+
+#ifdef _LOGDATA_VISION
+        DataLogger *dataLogger = DataLogger::GetInstance();
+        dataLogger->AddDataPoint(MOD_NAME, "", "OpPoint", "%d",
+                                 DataInt32, &m_opPoint);
+        dataLogger->AddDataPoint(MOD_NAME, "", "ProcTime", "%5.1f",
+                                 DataFloat, &m_procTime);
+        dataLogger->AddDataPoint(MOD_NAME, "", "Latency", "%5.1f",
+                                 DataFloat, &m_latency);
+#endif
+        RegisterTask(MOD_NAME,
+                     TASK_START_MODE | TASK_STOP_MODE | TASK_POST_PERIODIC);
 
         TExit();
     }   //VisionTarget
@@ -170,6 +233,29 @@ public:
         TExit();
     }   //TaskStopMode
 
+    /**
+     * This function is called by the TaskMgr after the periodic function to
+     * feed the main loop load to the vision task and publish its operating
+     * point.
+     * 
+     * @param mode Specifies the calling mode (autonomous or teleop).
+     */
+    void
+    TaskPostPeriodic(
+        UINT32 mode
+        )
+    {
+        TLevel(TASK);
+        TEnterMsg(("mode=%d", mode));
+
+        m_visionTask.SetLoopLoad(m_robot->GetLoopLoad());
+        m_opPoint = m_visionTask.GetOperatingPoint();
+        m_procTime = (float)m_visionTask.GetProcessTime()/1000.0;
+        m_latency = (float)m_visionTask.GetLatency()/1000.0;
+
+        TExit();
+    }   //TaskPostPeriodic
+
     /**
      * This function returns the target info with the given target ID.
      * 
@@ -183,23 +269,47 @@ public:
         int targetID,
         TARGETINFO *targetInfo
         )
+    {
+        return FindTarget(targetID, targetInfo, true);
+    }   //GetTargetInfo
+
+private:
+    /**
+     * This function finds the target with the given target ID in the latest
+     * vision results.
+     * 
+     * @param targetID Specifies which target we want the info for.
+     * @param targetInfo Points to the TARGETINFO structure to be filled in. 
+     * @param fSendDashboard If true, sends the vision results of a new frame
+     *        to the dashboard.
+     *
+     * @return Returns true if target info is available, false otherwise.
+     */
+    bool
+    FindTarget(
+        int targetID,
+        TARGETINFO *targetInfo,
+        bool fSendDashboard
+        )
     {
         bool fSuccess = false;
-        vector<ParticleAnalysisReport> *particles;
+        VISION_TARGETS targets;
+        ParticleAnalysisReport *particles = targets.targets;
 
         TLevel(API);
-        TEnterMsg(("targetID=%d,info=%p", targetID, targetInfo));
+        TEnterMsg(("targetID=%d,info=%p,fSend=%d",
+                   targetID, targetInfo, fSendDashboard));
 
-        particles = m_visionTask.VisionGetTargets();
-        if ((particles != NULL) && (particles->size() > 0))
+        if (m_visionTask.VisionGetTargets(&targets) &&
+            (targets.numTargets > 0))
         {
             int particleIdx = -1;
             double recX = 0.0;
             double recY = 0.0;
 
-            for (unsigned i = 0; i < particles->size(); i++)
+            for (int i = 0; i < targets.numTargets; i++)
             {
-                ParticleAnalysisReport *tParticle = &(particles->at(i));
+                ParticleAnalysisReport *tParticle = &particles[i];
                 float aspectRatio = tParticle->boundingRect.width/
                                     tParticle->boundingRect.height; 
 
@@ -252,8 +362,17 @@ public:
                 }
             }
 
-            m_dashboardDataFormat->SendVisionData(particles,
-                                                  (UINT8)particleIdx);
+            //
+            // Other callers may read the same frame, only send it to the
+            // dashboard once.
+            //
+            if (fSendDashboard && (targets.frameNumber != m_dashFrameNumber))
+            {
+                m_dashboardDataFormat->SendVisionData(particles,
+                                                      targets.numTargets,
+                                                      (UINT8)particleIdx);
+                m_dashFrameNumber = targets.frameNumber;
+            }
 
             if (particleIdx != -1)
             {
@@ -265,14 +384,14 @@ public:
                 //
                 targetInfo->distance =
                     TARGET_DISTANCE_CONSTANT/
-                    (float)particles->at(particleIdx).boundingRect.height;
+                    (float)particles[particleIdx].boundingRect.height;
 
                 //
                 // Calculate target height. 
                 //
                 double currKdh =
                          targetInfo->distance*
-                         ((double)particles->at(particleIdx).center_mass_y -
+                         ((double)particles[particleIdx].center_mass_y -
                           SCREEN_CENTER_Y);
                 float difLow = fabs(currKdh - TARGET_KDH_LOW);
                 float difMid = fabs(currKdh - TARGET_KDH_MID);
@@ -299,7 +418,7 @@ public:
                 // angle = atan(w2/f)
                 //
                 targetInfo->angle = 
-                    atan((float)(particles->at(particleIdx).center_mass_x - 
+                    atan((float)(particles[particleIdx].center_mass_x - 
                                  SCREEN_CENTER_X)/
                          FOCAL_LENGTH);
                 //
@@ -307,14 +426,16 @@ public:
                 //
                 targetInfo->angle *= 180.0; //convert to degrees from radians
                 targetInfo->angle /= PI;
+                targetInfo->frameNumber = targets.frameNumber;
+                targetInfo->frameTime = targets.frameTime;
                 fSuccess = true;
 #ifdef _DEBUG_TARGET
                 TInfo(("\n[%d]\tx=%3d, y=%3d, w=%3d, h=%3d\n",
                        particleIdx,
-                       particles->at(particleIdx).center_mass_x,
-                       particles->at(particleIdx).center_mass_y,
-                       particles->at(particleIdx).boundingRect.width,
-                       particles->at(particleIdx).boundingRect.height));
+                       particles[particleIdx].center_mass_x,
+                       particles[particleIdx].center_mass_y,
+                       particles[particleIdx].boundingRect.width,
+                       particles[particleIdx].boundingRect.height));
                 TInfo(("\tangle=%5.1f, dist=%5.1f, ht=%5.1f\n",
                        targetInfo->angle,
                        targetInfo->distance,
@@ -324,11 +445,11 @@ public:
                 LCDPrintf((LCD_LINE3, "dist=%5.1f, ht=%5.1f",
                            targetInfo->distance, targetInfo->height));
                 LCDPrintf((LCD_LINE4, "x=%3d, y=%3d",
-                           particles->at(particleIdx).center_mass_x,
-                           particles->at(particleIdx).center_mass_y));
+                           particles[particleIdx].center_mass_x,
+                           particles[particleIdx].center_mass_y));
                 LCDPrintf((LCD_LINE5, "w=%3d, h=%3d",
-                           particles->at(particleIdx).boundingRect.width,
-                           particles->at(particleIdx).boundingRect.height));
+                           particles[particleIdx].boundingRect.width,
+                           particles[particleIdx].boundingRect.height));
                 LCDPrintf((LCD_LINE6, "Kdh=%5.1f", currKdh));
 #endif
             }
@@ -348,10 +469,46 @@ public:
 #endif
         }
 
-        SAFE_DELETE(particles);
-
         TExitMsg(("=%d", fSuccess));
         return fSuccess;
-    }   //GetTargetInfo
+    }   //FindTarget
+
+public:
+#ifdef _BENCH_PERF
+    /**
+     * This function is called by the vision benchmark after each recorded
+     * image is processed. It returns the top target info the same way the
+     * shooter gets it, without sending it to the dashboard.
+     *
+     * @param results Points to the array to hold the detection results.
+     * @param maxResults Specifies the size of the results array.
+     *
+     * @return Returns the number of detection results.
+     */
+    int
+    GetBenchResults(
+        float *results,
+        int    maxResults
+        )
+    {
+        TARGETINFO targetInfo = {0.0, 0.0, 0.0, 0, 0};
+        int numResults = 0;
+
+        TLevel(CALLBK);
+        TEnterMsg(("results=%p,max=%d", results, maxResults));
+
+        if (maxResults >= 4)
+        {
+            results[0] = FindTarget(TARGET_TOP, &targetInfo, false)? 1.0: 0.0;
+            results[1] = targetInfo.distance;
+            results[2] = targetInfo.height;
+            results[3] = targetInfo.angle;
+            numResults = 4;
+        }
+
+        TExitMsg(("=%d", numResults));
+        return numResults;
+    }   //GetBenchResults
+#endif
 
 }; //class VisionTarget
@@ -35,9 +35,12 @@
 //#define _LOGDATA_SHOOTER
 //#define _LOGDATA_DRIVEBASE
 //#define _LOGDATA_JOYSTICK
+//#define _LOGDATA_VISION
 //#define _ENABLE_DATALOGGER
 
 //#define _CANJAG_PERF
+//#define _LATENCY_DUMP
+//#define _BENCH_PERF
 #ifdef _CANJAG_PERF
   #define _PERFDATA_LOOP
 #endif
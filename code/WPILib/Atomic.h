@@ -0,0 +1,44 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __ATOMIC_H__
+#define __ATOMIC_H__
+
+#include <vxWorks.h>
+
+/**
+ * Order the memory accesses before the barrier with the ones after it, so data
+ * shared between tasks without a lock is seen in the order it was written.
+ */
+static inline void MemoryBarrier()
+{
+	__asm__ __volatile__ ("sync" : : : "memory");
+}
+
+/**
+ * Atomically swap a new value into a word shared with another task.
+ * The leading sync orders earlier stores before the swap and the trailing isync keeps
+ * later loads after it.
+ * @param address The word to swap.
+ * @param value The new value of the word.
+ * @return The old value of the word.
+ */
+static inline INT32 AtomicExchange(volatile INT32 *address, INT32 value)
+{
+	INT32 old;
+	__asm__ __volatile__ (
+		"sync\n"
+		"1:	lwarx	%0,0,%2\n"
+		"	stwcx.	%3,0,%2\n"
+		"	bne-	1b\n"
+		"	isync"
+		: "=&r" (old), "+m" (*address)
+		: "r" (address), "r" (value)
+		: "cc", "memory");
+	return old;
+}
+
+#endif
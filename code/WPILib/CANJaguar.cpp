@@ -9,6 +9,7 @@
 #include "ChipObject/NiFpga.h"
 #include "CAN/JaguarCANDriver.h"
 #include "CAN/can_proto.h"
+#include "ControlLatency.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "WPIErrors.h"
 #include <stdio.h>
@@ -161,6 +162,7 @@ void CANJaguar::Set(float outputValue, UINT8 syncGroup)
 		dataSize++;
 	}
 	setTransaction(messageID, dataBuffer, dataSize);
+	ControlLatency::MarkOutput();
 	if (m_safetyHelper) m_safetyHelper->Feed();
 }
 
@@ -0,0 +1,264 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "ControlLatency.h"
+#include "ErrorBase.h"
+#include "Utility.h"
+#include "WPIErrors.h"
+#include <string.h>
+
+extern "C" int Priv_SetWriteFileAllowed(UINT32 enable);
+
+const UINT32 ControlLatency::kBucketWidth;
+const UINT32 ControlLatency::kNumBuckets;
+const UINT32 ControlLatency::kNoPacket;
+bool ControlLatency::m_enabled = true;
+ControlLatency::Histogram ControlLatency::m_histograms[kNumStages];
+UINT32 ControlLatency::m_packets = 0;
+UINT32 ControlLatency::m_lostPackets = 0;
+UINT32 ControlLatency::m_unreadPackets = 0;
+UINT32 ControlLatency::m_lastArrival = 0;
+UINT32 ControlLatency::m_publishedPacket = kNoPacket;
+UINT32 ControlLatency::m_statusPacket = kNoPacket;
+volatile UINT32 ControlLatency::m_readPacket = kNoPacket;
+UINT32 ControlLatency::m_readArrival = 0;
+volatile UINT32 ControlLatency::m_outputPacket = kNoPacket;
+volatile UINT32 ControlLatency::m_outputArrival = 0;
+
+static const char *kStageNames[ControlLatency::kNumStages] =
+	{"published", "read", "output", "status", "gap"};
+
+/**
+ * Clear all of the histograms and counters.
+ *
+ * The DS task keeps recording while this runs, so the first few samples after a
+ * reset can be incomplete.
+ */
+void ControlLatency::Reset()
+{
+	memset(m_histograms, 0, sizeof(m_histograms));
+	m_packets = 0;
+	m_lostPackets = 0;
+	m_unreadPackets = 0;
+	m_lastArrival = 0;
+	m_publishedPacket = kNoPacket;
+	m_statusPacket = kNoPacket;
+	m_readPacket = kNoPacket;
+	m_outputPacket = kNoPacket;
+}
+
+/**
+ * Get a summary of one histogram.
+ * @param stage The histogram to summarize.
+ * @param stats Filled in with the summary.  All zero if nothing was recorded.
+ */
+void ControlLatency::GetStats(Stage stage, Stats *stats)
+{
+	if (stats == NULL)
+	{
+		wpi_setGlobalWPIError(NullParameter);
+		return;
+	}
+	memset(stats, 0, sizeof(*stats));
+	if (stage < kPublished || stage >= kNumStages)
+	{
+		wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange, "stage");
+		return;
+	}
+
+	const Histogram &histogram = m_histograms[stage];
+	if (histogram.count == 0)
+		return;
+	stats->count = histogram.count;
+	stats->min = histogram.min;
+	stats->max = histogram.max;
+	stats->mean = (UINT32)(histogram.total / histogram.count);
+	stats->p50 = GetPercentile(stage, 50);
+	stats->p90 = GetPercentile(stage, 90);
+	stats->p99 = GetPercentile(stage, 99);
+}
+
+/**
+ * Get a percentile of one histogram.
+ * @param stage The histogram to look at.
+ * @param percent The percentile to find, from 0 to 100.
+ * @return The top of the bucket holding the percentile in microseconds, or the
+ * longest time recorded if it is past the last bucket.
+ */
+UINT32 ControlLatency::GetPercentile(Stage stage, UINT32 percent)
+{
+	if (stage < kPublished || stage >= kNumStages || percent > 100)
+	{
+		wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange, "stage or percent");
+		return 0;
+	}
+
+	const Histogram &histogram = m_histograms[stage];
+	// Round up so the 99th percentile of 10 samples is the 10th, not the 9th
+	UINT32 target = (UINT32)(((UINT64)histogram.count * percent + 99) / 100);
+	UINT32 seen = 0;
+	for (UINT32 i = 0; i < kNumBuckets; i++)
+	{
+		seen += histogram.buckets[i];
+		if (seen >= target)
+			return (i + 1) * kBucketWidth;
+	}
+	return histogram.max;
+}
+
+/**
+ * Write the counters, a summary of each histogram and the histograms themselves.
+ * @param file The file to write to, for example stdout.
+ */
+void ControlLatency::Dump(FILE *file)
+{
+	if (file == NULL)
+	{
+		wpi_setGlobalWPIError(NullParameter);
+		return;
+	}
+
+	fprintf(file, "# packets=%u lost=%u unread=%u\n",
+		m_packets, m_lostPackets, m_unreadPackets);
+	fprintf(file, "# status includes the wait for the next packet, about one gap longer than output\n");
+	fprintf(file, "stage,count,min_us,mean_us,p50_us,p90_us,p99_us,max_us\n");
+	for (INT32 stage = 0; stage < kNumStages; stage++)
+	{
+		Stats stats;
+		GetStats((Stage)stage, &stats);
+		fprintf(file, "%s,%u,%u,%u,%u,%u,%u,%u\n", kStageNames[stage],
+			stats.count, stats.min, stats.mean, stats.p50, stats.p90, stats.p99, stats.max);
+	}
+
+	fprintf(file, "bucket_us");
+	for (INT32 stage = 0; stage < kNumStages; stage++)
+		fprintf(file, ",%s", kStageNames[stage]);
+	fprintf(file, "\n");
+	for (UINT32 i = 0; i <= kNumBuckets; i++)
+	{
+		fprintf(file, "%u", i * kBucketWidth);
+		for (INT32 stage = 0; stage < kNumStages; stage++)
+			fprintf(file, ",%u", m_histograms[stage].buckets[i]);
+		fprintf(file, "\n");
+	}
+}
+
+/**
+ * Write everything Dump() writes to a file on the cRIO.
+ * @param fileName The name of the file, for example "/c/latency.csv".
+ * @return True if the file was written.
+ */
+bool ControlLatency::DumpToFile(const char *fileName)
+{
+	if (fileName == NULL)
+	{
+		wpi_setGlobalWPIError(NullParameter);
+		return false;
+	}
+
+	Priv_SetWriteFileAllowed(1);
+	FILE *file = fopen(fileName, "w");
+	if (file == NULL)
+	{
+		wpi_setGlobalWPIErrorWithContext(FileWriteError, fileName);
+		return false;
+	}
+	Dump(file);
+	fclose(file);
+	return true;
+}
+
+/**
+ * Note that a packet arrived.  Called by the DS task as soon as it wakes up.
+ * @param arrivalTime The FPGA time the packet arrived.
+ */
+void ControlLatency::MarkArrival(UINT32 arrivalTime)
+{
+	if (!m_enabled)
+		return;
+	if (m_packets > 0)
+		Record(kGap, arrivalTime - m_lastArrival);
+	m_lastArrival = arrivalTime;
+	m_packets++;
+}
+
+/**
+ * Note that a packet is ready for the robot code.  Called by the DS task.
+ * @param packetNumber The packet number the driver station sent.
+ * @param arrivalTime The FPGA time the packet arrived.
+ */
+void ControlLatency::MarkPublished(UINT32 packetNumber, UINT32 arrivalTime)
+{
+	if (!m_enabled)
+		return;
+	Record(kPublished, GetFPGATime() - arrivalTime);
+
+	if (m_publishedPacket != kNoPacket)
+	{
+		// The packet number is 16 bits on the wire
+		UINT32 skipped = ((packetNumber - m_publishedPacket) & 0xFFFF) - 1;
+		if (skipped < 0x8000)
+			m_lostPackets += skipped;
+		// Once the robot code is reading, every packet it passes over is counted
+		if (m_readPacket != kNoPacket && m_readPacket != m_publishedPacket)
+			m_unreadPackets++;
+	}
+	m_publishedPacket = packetNumber;
+}
+
+/**
+ * Note that the status packet is being handed to the FRC communication layer.
+ * Called by the DS task just before setStatusData(), which it only calls when the
+ * next packet arrives, so the time recorded includes about one packet period.
+ */
+void ControlLatency::MarkStatusSent()
+{
+	UINT32 packet = m_outputPacket;
+	if (!m_enabled || packet == kNoPacket || packet == m_statusPacket)
+		return;
+	UINT32 arrivalTime = m_outputArrival;
+	// Skip the sample if the robot code moved on to another packet meanwhile
+	if (packet != m_outputPacket)
+		return;
+	m_statusPacket = packet;
+	Record(kStatus, GetFPGATime() - arrivalTime);
+}
+
+/**
+ * Add one time to a histogram.
+ * @param stage The histogram to add to.
+ * @param time The time in microseconds.
+ */
+void ControlLatency::Record(Stage stage, UINT32 time)
+{
+	Histogram &histogram = m_histograms[stage];
+	UINT32 bucket = time / kBucketWidth;
+	if (bucket > kNumBuckets)
+		bucket = kNumBuckets;
+	histogram.buckets[bucket]++;
+	if (histogram.count == 0 || time < histogram.min)
+		histogram.min = time;
+	if (time > histogram.max)
+		histogram.max = time;
+	histogram.total += time;
+	histogram.count++;
+}
+
+void ControlLatency::RecordRead(UINT32 packetNumber, UINT32 arrivalTime)
+{
+	m_readArrival = arrivalTime;
+	m_readPacket = packetNumber;
+	Record(kRead, GetFPGATime() - arrivalTime);
+}
+
+void ControlLatency::RecordOutput()
+{
+	UINT32 packet = m_readPacket;
+	m_outputArrival = m_readArrival;
+	m_outputPacket = packet;
+	if (m_enabled)
+		Record(kOutput, GetFPGATime() - m_outputArrival);
+}
@@ -0,0 +1,115 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __CONTROL_LATENCY_H__
+#define __CONTROL_LATENCY_H__
+
+#include <stdio.h>
+#include <vxWorks.h>
+
+/**
+ * Measure how long a driver station packet takes to turn into actuator outputs.
+ *
+ * Every packet is stamped with the FPGA time it arrived.  The time from arrival is
+ * recorded in a histogram at each point the packet passes:
+ * - kPublished: the DS task has converted the packet for the robot code.
+ * - kRead: the robot code first read the packet.
+ * - kOutput: the first actuator write after the robot code read the packet.
+ * - kStatus: the status packet carrying those outputs was handed to the FRC
+ *   communication layer.  The DS task only sends status in reply to a packet, so
+ *   this includes the wait for the next packet and is about one packet period
+ *   (20 ms) longer than kOutput.
+ * The time between packet arrivals goes into the kGap histogram, and packets that
+ * never arrived or that the robot code never read are counted.
+ *
+ * If kOutput is regularly close to a whole packet period, the robot loop is
+ * reading its inputs a packet late.
+ *
+ * The DriverStation and the actuator classes do the recording.  Outputs are
+ * credited to the last packet the robot code read, so with more than one task
+ * writing actuators a few samples may be attributed to the wrong packet.
+ */
+class ControlLatency
+{
+public:
+	enum Stage {kPublished = 0, kRead, kOutput, kStatus, kGap, kNumStages};
+	static const UINT32 kBucketWidth = 250;		// microseconds per histogram bucket
+	static const UINT32 kNumBuckets = 200;		// plus one more for everything longer
+
+	struct Stats
+	{
+		UINT32 count;
+		UINT32 min;		// all times in microseconds
+		UINT32 max;
+		UINT32 mean;
+		UINT32 p50;		// percentiles are the top of their histogram bucket
+		UINT32 p90;
+		UINT32 p99;
+	};
+
+	static void SetEnabled(bool enabled) { m_enabled = enabled; }
+	static bool IsEnabled() { return m_enabled; }
+	static void Reset();
+
+	static void GetStats(Stage stage, Stats *stats);
+	static UINT32 GetPercentile(Stage stage, UINT32 percent);
+	static UINT32 GetPacketCount() { return m_packets; }
+	static UINT32 GetLostPackets() { return m_lostPackets; }
+	static UINT32 GetUnreadPackets() { return m_unreadPackets; }
+	static void Dump(FILE *file);
+	static bool DumpToFile(const char *fileName);
+
+	// Called by the DS task
+	static void MarkArrival(UINT32 arrivalTime);
+	static void MarkPublished(UINT32 packetNumber, UINT32 arrivalTime);
+	static void MarkStatusSent();
+
+	/**
+	 * Note that the robot code read a packet.  Only the first read of each packet
+	 * is recorded, so this is a single compare on every later read.
+	 */
+	static void MarkRead(UINT32 packetNumber, UINT32 arrivalTime)
+		{ if (packetNumber != m_readPacket && m_enabled) RecordRead(packetNumber, arrivalTime); }
+	/**
+	 * Note that an actuator was written.  Only the first write after each read is
+	 * recorded, so this is a single compare on every later write.
+	 */
+	static void MarkOutput()
+		{ if (m_outputPacket != m_readPacket) RecordOutput(); }
+
+private:
+	ControlLatency();
+
+	struct Histogram
+	{
+		UINT32 buckets[kNumBuckets + 1];
+		UINT32 count;
+		UINT32 min;
+		UINT32 max;
+		UINT64 total;
+	};
+
+	static const UINT32 kNoPacket = 0xFFFFFFFF;
+
+	static void Record(Stage stage, UINT32 time);
+	static void RecordRead(UINT32 packetNumber, UINT32 arrivalTime);
+	static void RecordOutput();
+
+	static bool m_enabled;
+	static Histogram m_histograms[kNumStages];
+	static UINT32 m_packets;
+	static UINT32 m_lostPackets;
+	static UINT32 m_unreadPackets;
+	static UINT32 m_lastArrival;				// written by the DS task
+	static UINT32 m_publishedPacket;
+	static UINT32 m_statusPacket;
+	static volatile UINT32 m_readPacket;		// written by the robot code
+	static UINT32 m_readArrival;
+	static volatile UINT32 m_outputPacket;
+	static volatile UINT32 m_outputArrival;
+};
+
+#endif
@@ -5,6 +5,7 @@
 /*----------------------------------------------------------------------------*/
 
 #include "Dashboard.h"
+#include "Atomic.h"
 #include "DriverStation.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "Synchronized.h"
@@ -12,23 +13,30 @@
 #include <strLib.h>
 
 const INT32 Dashboard::kMaxDashboardDataSize;
+const INT32 Dashboard::kStatusBuffers;
+const INT32 Dashboard::kStatusIndexMask;
+const INT32 Dashboard::kStatusFresh;
 
 /**
  * Dashboard contructor.
  * 
  * This is only called once when the DriverStation constructor is called.
  */
-Dashboard::Dashboard(SEM_ID statusDataSem)
-	: m_userStatusData (NULL)
-	, m_userStatusDataSize (0)
+Dashboard::Dashboard()
+	: m_backIndex (0)
+	, m_frontIndex (1)
+	, m_readyIndex (2)
 	, m_localBuffer (NULL)
 	, m_localPrintBuffer (NULL)
 	, m_packPtr (NULL)
 	, m_printSemaphore (0)
-	, m_statusDataSemaphore (statusDataSem)
 {
-	m_userStatusData = new char[kMaxDashboardDataSize];
-	m_localBuffer = new char[kMaxDashboardDataSize];
+	for (INT32 i = 0; i < kStatusBuffers; i++)
+	{
+		m_statusBuffers[i] = new char[kMaxDashboardDataSize];
+		m_statusSizes[i] = 0;
+	}
+	m_localBuffer = m_statusBuffers[m_backIndex];
 	m_localPrintBuffer = new char[kMaxDashboardDataSize * 2];
 	m_localPrintBuffer[0] = 0;
 	m_packPtr = m_localBuffer;
@@ -46,10 +54,12 @@ Dashboard::~Dashboard()
 	m_packPtr = NULL;
 	delete [] m_localPrintBuffer;
 	m_localPrintBuffer = NULL;
-	delete [] m_localBuffer;
 	m_localBuffer = NULL;
-	delete [] m_userStatusData;
-	m_userStatusData = NULL;
+	for (INT32 i = 0; i < kStatusBuffers; i++)
+	{
+		delete [] m_statusBuffers[i];
+		m_statusBuffers[i] = NULL;
+	}
 }
 
 /**
@@ -286,6 +296,42 @@ void Dashboard::Printf(const char *writeFmt, ...)
 	va_end (args);
 }
 
+/**
+ * Add preformatted text to the UserData text on the Dashboard.
+ * 
+ * This is the same as Printf() without formatting, so use a TextFormatter to build
+ * the text when Printf() is too slow for a periodic loop.
+ * @param text The text to add.  It does not need to be NULL terminated.
+ * @param length The number of characters of text.
+ */
+void Dashboard::Print(const char *text, INT32 length)
+{
+	INT32 size;
+
+	// Check if the buffer has already been used for packing.
+	if (m_packPtr != m_localBuffer)
+	{
+		wpi_setWPIError(DashboardDataCollision);
+		return;
+	}
+	if (length < 0)
+		length = 0;
+	{
+		Synchronized sync(m_printSemaphore);
+		size = strlen(m_localPrintBuffer);
+		// Unlike Printf(), never run past the end of the print buffer
+		if (size + length > kMaxDashboardDataSize * 2 - 1)
+			length = kMaxDashboardDataSize * 2 - 1 - size;
+		memcpy(m_localPrintBuffer + size, text, length);
+		size += length;
+		m_localPrintBuffer[size] = 0;
+	}
+	if (size > kMaxDashboardDataSize)
+	{
+		wpi_setWPIError(DashboardDataOverflow);
+	}
+}
+
 /**
  * Indicate that the packing is complete and commit the buffer to the DriverStation.
  * 
@@ -310,42 +356,98 @@ INT32 Dashboard::Finalize()
 		reported = true;
 	}
 
-	Synchronized sync(m_statusDataSemaphore);
+	// Packed Dashboard Data was packed straight into the back buffer
+	return PublishStatusBuffer(m_packPtr - m_localBuffer);
+}
 
-	// Sequence number
-	DriverStation::GetInstance()->IncrementUpdateNumber();
+/**
+ * Commit data that was packed elsewhere, e.g. by a DashboardSchema, to the DriverStation.
+ * 
+ * The data must already be in the packed dashboard format.  It is copied straight into
+ * the buffer sent to the DriverStation, so it must not be mixed with the Add methods or
+ * Printf() in the same packet.
+ * @param packedData The packed dashboard data.
+ * @param size The number of bytes of packed data.
+ * @return The total size of the data packed into the userData field of the status packet.
+ */
+INT32 Dashboard::FinalizePacked(const char *packedData, INT32 size)
+{
+	if (packedData == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return 0;
+	}
+	if (size > kMaxDashboardDataSize)
+	{
+		wpi_setWPIError(DashboardDataOverflow);
+		return 0;
+	}
+	if (m_packPtr != m_localBuffer || m_localPrintBuffer[0] != 0)
+	{
+		wpi_setWPIError(DashboardDataCollision);
+		return 0;
+	}
 
-	// Packed Dashboard Data
-	m_userStatusDataSize = m_packPtr - m_localBuffer;
-	memcpy(m_userStatusData, m_localBuffer, m_userStatusDataSize);
-	m_packPtr = m_localBuffer;
+	static bool reported = false;
+	if (!reported)
+	{
+		nUsageReporting::report(nUsageReporting::kResourceType_Dashboard, 0);
+		reported = true;
+	}
+
+	memcpy(m_localBuffer, packedData, size);
+	return PublishStatusBuffer(size);
+}
 
-	return m_userStatusDataSize;
+/**
+ * Hand the back buffer over to the DS task and take the buffer it replaces to pack into next.
+ * 
+ * The DS task never waits on this, and this never waits on the DS task.
+ * @param size The number of bytes packed into the back buffer.
+ * @return The number of bytes handed over.
+ */
+INT32 Dashboard::PublishStatusBuffer(INT32 size)
+{
+	m_statusSizes[m_backIndex] = size;
+	m_backIndex = AtomicExchange(&m_readyIndex, m_backIndex | kStatusFresh) & kStatusIndexMask;
+	m_localBuffer = m_statusBuffers[m_backIndex];
+	m_packPtr = m_localBuffer;
+	return size;
 }
 
 /**
  * Called by the DriverStation class to retrieve buffers, sizes, etc. for writing
  *   to the NetworkCommunication task.
- * This function is called while holding the m_statusDataSemaphore.
+ * This function is only called from the DS task and never blocks.  If a new buffer has
+ *   been handed over it becomes the front buffer, otherwise the last one is sent again.
  */
 void Dashboard::GetStatusBuffer(char **userStatusData, INT32* userStatusDataSize)
 {
-	// User printed strings
-	if (m_localPrintBuffer[0] != 0)
+	if (m_readyIndex & kStatusFresh)
+	{
+		// Sequence number
+		DriverStation::GetInstance()->IncrementUpdateNumber();
+
+		m_frontIndex = AtomicExchange(&m_readyIndex, m_frontIndex) & kStatusIndexMask;
+	}
+
+	// User printed strings.  If the user is in the middle of a Printf(), they go with the next packet.
+	if (m_localPrintBuffer[0] != 0 && semTake(m_printSemaphore, NO_WAIT) == OK)
 	{
 		// Sequence number
 		DriverStation::GetInstance()->IncrementUpdateNumber();
 
-		INT32 printSize;
-		Synchronized syncPrint(m_printSemaphore);
-		printSize = strlen(m_localPrintBuffer);
-		m_userStatusDataSize = printSize;
-		memcpy(m_userStatusData, m_localPrintBuffer, m_userStatusDataSize);
+		INT32 printSize = strlen(m_localPrintBuffer);
+		if (printSize > kMaxDashboardDataSize)
+			printSize = kMaxDashboardDataSize;
+		m_statusSizes[m_frontIndex] = printSize;
+		memcpy(m_statusBuffers[m_frontIndex], m_localPrintBuffer, printSize);
 		m_localPrintBuffer[0] = 0;
+		semGive(m_printSemaphore);
 	}
 
-	*userStatusData = m_userStatusData;
-	*userStatusDataSize = m_userStatusDataSize;
+	*userStatusData = m_statusBuffers[m_frontIndex];
+	*userStatusDataSize = m_statusSizes[m_frontIndex];
 }
 
 /**
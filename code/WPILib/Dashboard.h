@@ -20,7 +20,7 @@
 class Dashboard : public DashboardBase
 {
 public:
-	explicit Dashboard(SEM_ID statusDataSemaphore);
+	Dashboard();
 	virtual ~Dashboard();
 
 	enum Type {kI8, kI16, kI32, kU8, kU16, kU32, kFloat, kDouble, kBoolean, kString, kOther};
@@ -44,22 +44,36 @@ public:
 	void FinalizeCluster();
 
 	void Printf(const char *writeFmt, ...);
+	void Print(const char *text, INT32 length);
 
 	INT32 Finalize();
+	INT32 FinalizePacked(const char *packedData, INT32 size);
 	void GetStatusBuffer(char** userStatusData, INT32* userStatusDataSize);
 	void Flush() {}
-private:
+
 	static const INT32 kMaxDashboardDataSize = USER_STATUS_DATA_SIZE - sizeof(UINT32) * 3 - sizeof(UINT8); // 13 bytes needed for 3 size parameters and the sequence number
 
+private:
 	// Usage Guidelines...
 	DISALLOW_COPY_AND_ASSIGN(Dashboard);
 
+	static const INT32 kStatusBuffers = 3;
+	static const INT32 kStatusIndexMask = 0x3;
+	static const INT32 kStatusFresh = 0x4;
+
 	bool ValidateAdd(INT32 size);
 	void AddedElement(Type type);
 	bool IsArrayRoot();
+	INT32 PublishStatusBuffer(INT32 size);
 
-	char *m_userStatusData;
-	INT32 m_userStatusDataSize;
+	// Status buffers handed from the user to the DS task without a lock.  The user
+	// packs into the back buffer, the DS task sends the front buffer, and the third
+	// is the one most recently handed over.  Only indexes change hands.
+	char *m_statusBuffers[kStatusBuffers];
+	INT32 m_statusSizes[kStatusBuffers];
+	INT32 m_backIndex;
+	INT32 m_frontIndex;
+	volatile INT32 m_readyIndex;
 	char *m_localBuffer;
 	char *m_localPrintBuffer;
 	char *m_packPtr;
@@ -68,7 +82,6 @@ private:
 	std::vector<INT32*> m_arraySizePtr;
 	std::stack<ComplexType> m_complexTypeStack;
 	SEM_ID m_printSemaphore;
-	SEM_ID m_statusDataSemaphore;
 };
 
 #endif
@@ -0,0 +1,214 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "DashboardSchema.h"
+#include "WPIErrors.h"
+
+const DashboardSchema::Slot DashboardSchema::kInvalidSlot;
+
+/**
+ * DashboardSchema constructor.
+ *
+ * The schema starts out empty.  Declare its layout and then call Compile().
+ */
+DashboardSchema::DashboardSchema()
+	: m_image (NULL)
+	, m_size (0)
+	, m_clusterDepth (0)
+	, m_compiled (false)
+	, m_changed (false)
+{
+	m_image = new char[Dashboard::kMaxDashboardDataSize];
+	memset(m_image, 0, Dashboard::kMaxDashboardDataSize);
+}
+
+DashboardSchema::~DashboardSchema()
+{
+	delete [] m_image;
+	m_image = NULL;
+}
+
+/**
+ * Get the number of bytes a value of the given type takes in the packed data.
+ * @param type The type of the value.
+ * @return The size of the value, or 0 if the type does not have a fixed size.
+ */
+INT32 DashboardSchema::GetTypeSize(Dashboard::Type type)
+{
+	switch (type)
+	{
+	case Dashboard::kI8:
+	case Dashboard::kU8:
+	case Dashboard::kBoolean:
+		return sizeof(INT8);
+	case Dashboard::kI16:
+	case Dashboard::kU16:
+		return sizeof(INT16);
+	case Dashboard::kI32:
+	case Dashboard::kU32:
+		return sizeof(INT32);
+	case Dashboard::kFloat:
+		return sizeof(float);
+	case Dashboard::kDouble:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Declare a single value in the layout.
+ * @param type The type of the value.  It must have a fixed size.
+ * @return The slot to fill the value in, or kInvalidSlot if it could not be added.
+ */
+DashboardSchema::Slot DashboardSchema::AddField(Dashboard::Type type)
+{
+	INT32 size = GetTypeSize(type);
+	if (size == 0)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "type must have a fixed size");
+		return kInvalidSlot;
+	}
+	return Reserve(size);
+}
+
+/**
+ * Declare an array with a fixed number of elements of the same type.
+ *
+ * The element count is packed once here.  Use GetElementSlot() to find each element.
+ * @param type The type of every element.  It must have a fixed size.
+ * @param count The number of elements in the array.
+ * @return The slot of the first element, or kInvalidSlot if it could not be added.
+ */
+DashboardSchema::Slot DashboardSchema::AddArray(Dashboard::Type type, INT32 count)
+{
+	INT32 size = GetTypeSize(type);
+	if (size == 0)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "type must have a fixed size");
+		return kInvalidSlot;
+	}
+	if (count < 0)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "count must not be negative");
+		return kInvalidSlot;
+	}
+
+	Slot countSlot = Reserve(sizeof(INT32));
+	if (countSlot == kInvalidSlot)
+		return kInvalidSlot;
+	SetI32(countSlot, count);
+
+	return Reserve(size * count);
+}
+
+/**
+ * Start a cluster in the layout.
+ *
+ * Clusters do not take any room in the packed data, so this only checks that every
+ * AddCluster() has a matching FinalizeCluster().
+ */
+void DashboardSchema::AddCluster()
+{
+	if (m_compiled)
+	{
+		wpi_setWPIErrorWithContext(IncompatibleState, "schema is already compiled");
+		return;
+	}
+	m_clusterDepth++;
+}
+
+/**
+ * Indicate the end of a cluster in the layout.
+ */
+void DashboardSchema::FinalizeCluster()
+{
+	if (m_compiled)
+	{
+		wpi_setWPIErrorWithContext(IncompatibleState, "schema is already compiled");
+		return;
+	}
+	if (m_clusterDepth == 0)
+	{
+		wpi_setWPIError(MismatchedComplexTypeClose);
+		return;
+	}
+	m_clusterDepth--;
+}
+
+/**
+ * Indicate that the layout is complete.
+ *
+ * After this, values can be filled in and sent but the layout can no longer change.
+ * @return True if the layout is complete and consistent.
+ */
+bool DashboardSchema::Compile()
+{
+	if (m_clusterDepth != 0)
+	{
+		wpi_setWPIError(MismatchedComplexTypeClose);
+		return false;
+	}
+	if (StatusIsFatal())
+		return false;
+	m_compiled = true;
+	// The dashboard has not seen any of the layout yet
+	m_changed = true;
+	return true;
+}
+
+/**
+ * Send the current values to the dashboard.
+ * @param dashboard The dashboard packer to commit the values to.
+ * @return The total size of the data packed into the userData field of the status packet.
+ */
+INT32 DashboardSchema::Send(Dashboard &dashboard)
+{
+	if (!m_compiled)
+	{
+		wpi_setWPIErrorWithContext(IncompatibleState, "schema is not compiled");
+		return 0;
+	}
+	m_changed = false;
+	return dashboard.FinalizePacked(m_image, m_size);
+}
+
+/**
+ * Send the current values to the dashboard only if any of them changed since the last send.
+ *
+ * The dashboard packer keeps sending the last packed data, so a value the dashboard
+ * already has does not need to be packed again.
+ * @param dashboard The dashboard packer to commit the values to.
+ * @return The total size of the data packed, or 0 if nothing changed.
+ */
+INT32 DashboardSchema::SendIfChanged(Dashboard &dashboard)
+{
+	if (!m_changed)
+		return 0;
+	return Send(dashboard);
+}
+
+/**
+ * Reserve room at the end of the layout.
+ * @param size The number of bytes to reserve.
+ * @return The slot of the reserved room, or kInvalidSlot if it does not fit.
+ */
+DashboardSchema::Slot DashboardSchema::Reserve(INT32 size)
+{
+	if (m_compiled)
+	{
+		wpi_setWPIErrorWithContext(IncompatibleState, "schema is already compiled");
+		return kInvalidSlot;
+	}
+	if (m_size + size > Dashboard::kMaxDashboardDataSize)
+	{
+		wpi_setWPIError(DashboardDataOverflow);
+		return kInvalidSlot;
+	}
+	Slot slot = m_size;
+	m_size += size;
+	return slot;
+}
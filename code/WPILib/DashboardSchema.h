@@ -0,0 +1,91 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __DASHBOARD_SCHEMA_H__
+#define __DASHBOARD_SCHEMA_H__
+
+#include "Dashboard.h"
+#include "ErrorBase.h"
+#include <string.h>
+#include <vxWorks.h>
+
+/**
+ * A fixed dashboard layout that is declared once and then filled in every loop.
+ *
+ * Declare the layout with the Add methods in the same order the Dashboard would
+ * pack it, then call Compile().  Each Add returns the slot (byte offset) of the
+ * value in the packed image.  Clusters and arrays are checked while the layout is
+ * built, so filling in a slot is a single store and sending the image is a single
+ * copy into the Dashboard.
+ *
+ * Only fixed size values can be part of a schema, so strings are not supported.
+ */
+class DashboardSchema : public ErrorBase
+{
+public:
+	typedef INT32 Slot;
+	static const Slot kInvalidSlot = -1;
+
+	DashboardSchema();
+	virtual ~DashboardSchema();
+
+	Slot AddField(Dashboard::Type type);
+	Slot AddArray(Dashboard::Type type, INT32 count);
+	void AddCluster();
+	void FinalizeCluster();
+	bool Compile();
+	bool IsCompiled() { return m_compiled; }
+
+	static INT32 GetTypeSize(Dashboard::Type type);
+
+	/**
+	 * Get the slot of one element of an array declared with AddArray().
+	 * @param array The slot returned by AddArray().
+	 * @param type The element type the array was declared with.
+	 * @param index The index of the element.
+	 */
+	static Slot GetElementSlot(Slot array, Dashboard::Type type, INT32 index)
+		{ return array == kInvalidSlot ? kInvalidSlot : array + index * GetTypeSize(type); }
+
+	void SetI8(Slot slot, INT8 value) { Store(slot, &value, sizeof(value)); }
+	void SetI16(Slot slot, INT16 value) { Store(slot, &value, sizeof(value)); }
+	void SetI32(Slot slot, INT32 value) { Store(slot, &value, sizeof(value)); }
+	void SetU8(Slot slot, UINT8 value) { Store(slot, &value, sizeof(value)); }
+	void SetU16(Slot slot, UINT16 value) { Store(slot, &value, sizeof(value)); }
+	void SetU32(Slot slot, UINT32 value) { Store(slot, &value, sizeof(value)); }
+	void SetFloat(Slot slot, float value) { Store(slot, &value, sizeof(value)); }
+	void SetDouble(Slot slot, double value) { Store(slot, &value, sizeof(value)); }
+	void SetBoolean(Slot slot, bool value) { UINT8 b = value ? 1 : 0; Store(slot, &b, sizeof(b)); }
+
+	INT32 Send(Dashboard &dashboard);
+	INT32 SendIfChanged(Dashboard &dashboard);
+	bool HasChanged() { return m_changed; }
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(DashboardSchema);
+
+	/**
+	 * Copy a value into its slot and note whether it changed.  The fixed size lets the
+	 * compiler turn this into one compare and one store.
+	 */
+	void Store(Slot slot, const void *value, INT32 size)
+	{
+		if (slot != kInvalidSlot && memcmp(m_image + slot, value, size) != 0)
+		{
+			memcpy(m_image + slot, value, size);
+			m_changed = true;
+		}
+	}
+	Slot Reserve(INT32 size);
+
+	char *m_image;
+	INT32 m_size;
+	INT32 m_clusterDepth;
+	bool m_compiled;
+	bool m_changed;
+};
+
+#endif
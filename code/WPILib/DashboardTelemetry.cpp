@@ -0,0 +1,100 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "DashboardTelemetry.h"
+#include "Utility.h"
+#include "WPIErrors.h"
+
+/**
+ * DashboardTelemetry constructor.
+ * @param schema The compiled schema the groups fill in.
+ * @param dashboard The dashboard packer the schema is sent with, usually the low priority one.
+ * @param budget The most bytes to sample in one call to Run().
+ */
+DashboardTelemetry::DashboardTelemetry(DashboardSchema *schema, Dashboard *dashboard, INT32 budget)
+	: m_schema (schema)
+	, m_dashboard (dashboard)
+	, m_budget (budget)
+	, m_nextGroup (0)
+{
+	if (schema == NULL || dashboard == NULL)
+		wpi_setWPIError(NullParameter);
+}
+
+DashboardTelemetry::~DashboardTelemetry()
+{
+}
+
+/**
+ * Add a group of values to sample.
+ * @param handler The function that reads the values and fills in their slots in the schema.
+ * @param param A parameter to pass to the handler.
+ * @param period The time in seconds between samples of this group.
+ * @param size The number of bytes of the schema the handler fills in.
+ */
+void DashboardTelemetry::AddGroup(TelemetrySampleHandler handler, void *param, double period, INT32 size)
+{
+	if (handler == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return;
+	}
+	if (period < 0.0 || size < 0)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "period and size must not be negative");
+		return;
+	}
+
+	Group group;
+	group.handler = handler;
+	group.param = param;
+	group.period = (UINT32)(period * 1e6);
+	group.nextSample = GetFPGATime();
+	group.size = size;
+	m_groups.push_back(group);
+}
+
+/**
+ * Set the most bytes to sample in one call to Run().
+ * @param budget The number of bytes.
+ */
+void DashboardTelemetry::SetBudget(INT32 budget)
+{
+	m_budget = budget;
+}
+
+/**
+ * Sample the groups that are due and send the schema if anything changed.
+ *
+ * Call this once per loop.  At least one due group is sampled on every call, so a
+ * group larger than the budget still gets its turn.
+ * @return The total size of the data packed, or 0 if nothing changed.
+ */
+INT32 DashboardTelemetry::Run()
+{
+	if (m_schema == NULL || m_dashboard == NULL)
+		return 0;
+
+	UINT32 now = GetFPGATime();
+	UINT32 count = m_groups.size();
+	INT32 sampled = 0;
+	for (UINT32 i = 0; i < count; i++)
+	{
+		Group &group = m_groups[m_nextGroup];
+		// The FPGA time wraps every 71 minutes, so compare the difference
+		if ((INT32)(now - group.nextSample) >= 0)
+		{
+			if (sampled > 0 && sampled + group.size > m_budget)
+				break;
+			group.handler(m_schema, group.param);
+			group.nextSample = now + group.period;
+			sampled += group.size;
+		}
+		m_nextGroup = (m_nextGroup + 1) % count;
+	}
+
+	return m_schema->SendIfChanged(*m_dashboard);
+}
@@ -0,0 +1,55 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __DASHBOARD_TELEMETRY_H__
+#define __DASHBOARD_TELEMETRY_H__
+
+#include "DashboardSchema.h"
+#include "ErrorBase.h"
+#include <vector>
+#include <vxWorks.h>
+
+typedef void (*TelemetrySampleHandler)(DashboardSchema *schema, void *param);
+
+/**
+ * Keep a DashboardSchema up to date without sampling every value on every loop.
+ *
+ * The values in the schema are split into groups.  Each group has a handler that
+ * reads its values and fills in their slots, and a period between samples.  Run()
+ * samples the groups that are due, but stops once the bytes sampled in this call
+ * would exceed the budget.  Groups left over are first in line on the next call.
+ * The schema is only sent when a sampled value actually changed.
+ */
+class DashboardTelemetry : public ErrorBase
+{
+public:
+	DashboardTelemetry(DashboardSchema *schema, Dashboard *dashboard, INT32 budget);
+	virtual ~DashboardTelemetry();
+
+	void AddGroup(TelemetrySampleHandler handler, void *param, double period, INT32 size);
+	void SetBudget(INT32 budget);
+	INT32 Run();
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(DashboardTelemetry);
+
+	struct Group
+	{
+		TelemetrySampleHandler handler;
+		void *param;
+		UINT32 period;		// microseconds between samples
+		UINT32 nextSample;	// FPGA time of the next sample
+		INT32 size;			// bytes the group fills in
+	};
+
+	DashboardSchema *m_schema;
+	Dashboard *m_dashboard;
+	INT32 m_budget;
+	std::vector<Group> m_groups;
+	UINT32 m_nextGroup;
+};
+
+#endif
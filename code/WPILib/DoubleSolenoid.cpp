@@ -5,6 +5,7 @@
 /*----------------------------------------------------------------------------*/
 
 #include "DoubleSolenoid.h"
+#include "ControlLatency.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "WPIErrors.h"
 
@@ -102,6 +103,7 @@ DoubleSolenoid::~DoubleSolenoid()
 void DoubleSolenoid::Set(Value value)
 {
 	if (StatusIsFatal()) return;
+	ControlLatency::MarkOutput();
 	UINT8 rawValue = 0x00;
 
 	switch(value)
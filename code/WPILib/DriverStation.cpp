@@ -6,6 +6,7 @@
 
 #include "DriverStation.h"
 #include "AnalogChannel.h"
+#include "Atomic.h"
 #include "Synchronized.h"
 #include "Timer.h"
 #include "NetworkCommunication/FRCComm.h"
@@ -14,11 +15,14 @@
 #include "Utility.h"
 #include "WPIErrors.h"
 #include <strLib.h>
+#include <sysLib.h>
+#include <tickLib.h>
 
 const UINT32 DriverStation::kBatteryModuleNumber;
 const UINT32 DriverStation::kBatteryChannel;
 const UINT32 DriverStation::kJoystickPorts;
 const UINT32 DriverStation::kJoystickAxes;
+const UINT32 DriverStation::kAnalogInChannels;
 const float DriverStation::kUpdatePeriod;
 DriverStation* DriverStation::m_instance = NULL;
 UINT8 DriverStation::m_updateNumber = 0;
@@ -30,18 +34,22 @@ UINT8 DriverStation::m_updateNumber = 0;
  */
 DriverStation::DriverStation()
 	: m_controlData (NULL)
+	, m_controlWriteSeq (0)
+	, m_controlPublishSeq (0)
+	, m_packetArrivalTime (0)
 	, m_digitalOut (0)
 	, m_batteryChannel (NULL)
-	, m_statusDataSemaphore (semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE))
+	, m_batteryVoltage (0.0)
 	, m_task ("DriverStation", (FUNCPTR)DriverStation::InitTask)
-	, m_dashboardHigh(m_statusDataSemaphore)
-	, m_dashboardLow(m_statusDataSemaphore)
+	, m_dashboardHigh()
+	, m_dashboardLow()
 	, m_dashboardInUseHigh(&m_dashboardHigh)
 	, m_dashboardInUseLow(&m_dashboardLow)
 	, m_newControlData (false)
 	, m_packetDataAvailableSem (0)
 	, m_enhancedIO()
 	, m_waitForDataSem(0)
+	, m_newDataSem(0)
 	, m_approxMatchTimeOffset(-1.0)
 	, m_userInDisabled(false)
 	, m_userInAutonomous(false)
@@ -55,6 +63,7 @@ DriverStation::DriverStation()
 	setNewDataSem(m_packetDataAvailableSem);
 
 	m_waitForDataSem = semBCreate (SEM_Q_PRIORITY, SEM_EMPTY);
+	m_newDataSem = semBCreate (SEM_Q_PRIORITY, SEM_EMPTY);
 
 	m_controlData = new FRCCommonControlData;
 
@@ -83,7 +92,12 @@ DriverStation::DriverStation()
 	m_controlData->analog4 = 0;
 	m_controlData->dsDigitalIn = 0;
 
+	// Both buffers start out neutral so the getters are valid before the first packet
+	memset(m_controlBuffers, 0, sizeof(m_controlBuffers));
+	m_controlBuffers[0].alliance = m_controlBuffers[1].alliance = kInvalid;
+
 	m_batteryChannel = new AnalogChannel(kBatteryModuleNumber, kBatteryChannel);
+	m_batteryVoltage = ReadBatteryVoltage();
 
 	AddToSingletonList();
 
@@ -96,11 +110,11 @@ DriverStation::DriverStation()
 DriverStation::~DriverStation()
 {
 	m_task.Stop();
-	semDelete(m_statusDataSemaphore);
 	delete m_batteryChannel;
 	delete m_controlData;
 	m_instance = NULL;
 	semDelete(m_waitForDataSem);
+	semDelete(m_newDataSem);
 	// Unregister our semaphore.
 	setNewDataSem(0);
 	semDelete(m_packetDataAvailableSem);
@@ -117,13 +131,17 @@ void DriverStation::Run()
 	while (true)
 	{
 		semTake(m_packetDataAvailableSem, WAIT_FOREVER);
+		m_packetArrivalTime = GetFPGATime();
+		ControlLatency::MarkArrival(m_packetArrivalTime);
 		SetData();
 		m_enhancedIO.UpdateData();
 		GetData();
 		semFlush(m_waitForDataSem);
+		semGive(m_newDataSem);
 		if (++period >= 4)
 		{
 			MotorSafetyHelper::CheckMotors();
+			m_batteryVoltage = ReadBatteryVoltage();
 			period = 0;
 		}
 		if (m_userInDisabled)
@@ -156,24 +174,118 @@ void DriverStation::GetData()
 {
 	static bool lastEnabled = false;
 	getCommonControlData(m_controlData, WAIT_FOREVER);
-	if (!lastEnabled && IsEnabled()) 
+	PublishControlData();
+	ControlLatency::MarkPublished(m_controlData->packetIndex, m_packetArrivalTime);
+	bool enabled = GetPublishedControlData().enabled;
+	if (!lastEnabled && enabled) 
 	{
 		// If starting teleop, assume that autonomous just took up 15 seconds
-		if (IsAutonomous())
+		if (m_controlData->autonomous)
 			m_approxMatchTimeOffset = Timer::GetFPGATimestamp();
 		else
 			m_approxMatchTimeOffset = Timer::GetFPGATimestamp() - 15.0;
 	}
-	else if (lastEnabled && !IsEnabled())
+	else if (lastEnabled && !enabled)
 	{
 		m_approxMatchTimeOffset = -1.0;
 	}
-	lastEnabled = IsEnabled();
+	lastEnabled = enabled;
 	m_newControlData = true;
 }
 
+// 5V divided by 10 bits
+#define kDSAnalogInScaling ((float)(5.0 / 1023.0))
+
+/**
+ * Convert the packet just received into the control buffer the user is not reading
+ * and publish it.
+ * Only the DS task writes the buffers, and it never touches the one last published,
+ * so a reader always sees one whole packet without taking a lock.
+ */
+void DriverStation::PublishControlData()
+{
+	UINT32 seq = m_controlPublishSeq + 1;
+	m_controlWriteSeq = seq;
+	MemoryBarrier();
+
+	ControlData *data = &m_controlBuffers[seq & 1];
+	data->packetNumber = m_controlData->packetIndex;
+	data->arrivalTime = m_packetArrivalTime;
+	data->enabled = m_controlData->enabled;
+	data->autonomous = m_controlData->autonomous;
+	data->fmsAttached = m_controlData->fmsAttached;
+	if (m_controlData->dsID_Alliance == 'R')
+		data->alliance = kRed;
+	else if (m_controlData->dsID_Alliance == 'B')
+		data->alliance = kBlue;
+	else
+		data->alliance = kInvalid;
+	if (m_controlData->dsID_Position >= '1' && m_controlData->dsID_Position <= '3')
+		data->location = m_controlData->dsID_Position - '0';
+	else
+		data->location = 0;
+	data->teamNumber = m_controlData->teamID;
+	data->digitalIn = m_controlData->dsDigitalIn;
+
+	data->analogIn[0] = kDSAnalogInScaling * m_controlData->analog1;
+	data->analogIn[1] = kDSAnalogInScaling * m_controlData->analog2;
+	data->analogIn[2] = kDSAnalogInScaling * m_controlData->analog3;
+	data->analogIn[3] = kDSAnalogInScaling * m_controlData->analog4;
+
+	const INT8 *axes[kJoystickPorts] = {
+		m_controlData->stick0Axes, m_controlData->stick1Axes,
+		m_controlData->stick2Axes, m_controlData->stick3Axes};
+	for (UINT32 stick = 0; stick < kJoystickPorts; stick++)
+	{
+		for (UINT32 axis = 0; axis < kJoystickAxes; axis++)
+		{
+			// -128 maps to -1.0 and 127 to 1.0, so the result never needs clamping
+			INT8 value = axes[stick][axis];
+			if (value < 0)
+				data->stickAxes[stick][axis] = ((float) value) / 128.0;
+			else
+				data->stickAxes[stick][axis] = ((float) value) / 127.0;
+		}
+	}
+	data->stickButtons[0] = m_controlData->stick0Buttons;
+	data->stickButtons[1] = m_controlData->stick1Buttons;
+	data->stickButtons[2] = m_controlData->stick2Buttons;
+	data->stickButtons[3] = m_controlData->stick3Buttons;
+
+	MemoryBarrier();
+	m_controlPublishSeq = seq;
+}
+
+/**
+ * Copy the latest driver station packet without taking any lock.
+ * Every field in the copy comes from the same packet, so a loop that reads its
+ * inputs from one copy never mixes two packets.
+ * @param data Filled in with the converted control data.
+ */
+void DriverStation::GetControlData(ControlData *data)
+{
+	if (data == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return;
+	}
+
+	UINT32 seq;
+	do
+	{
+		seq = m_controlPublishSeq;
+		MemoryBarrier();
+		*data = m_controlBuffers[seq & 1];
+		MemoryBarrier();
+		// Retry only if the DS task has come back around to the buffer just copied
+	} while (m_controlWriteSeq - seq >= 2);
+	ControlLatency::MarkRead(data->packetNumber, data->arrivalTime);
+}
+
 /**
  * Copy status data from the DS task for the user.
+ * The packers hand over finished buffers without a lock, so user code packing a
+ * dashboard never holds up the DS task and the DS task never holds up the user.
  */
 void DriverStation::SetData()
 {
@@ -182,17 +294,29 @@ void DriverStation::SetData()
 	char *userStatusDataLow;
 	INT32 userStatusDataLowSize;
 
-	Synchronized sync(m_statusDataSemaphore);
-
 	m_dashboardInUseHigh->GetStatusBuffer(&userStatusDataHigh, &userStatusDataHighSize);
 	m_dashboardInUseLow->GetStatusBuffer(&userStatusDataLow, &userStatusDataLowSize);
-	setStatusData(GetBatteryVoltage(), m_digitalOut, m_updateNumber,
+	ControlLatency::MarkStatusSent();
+	setStatusData(m_batteryVoltage, m_digitalOut, m_updateNumber,
 		userStatusDataHigh, userStatusDataHighSize, userStatusDataLow, userStatusDataLowSize, WAIT_FOREVER);
 	
 	m_dashboardInUseHigh->Flush();
 	m_dashboardInUseLow->Flush();
 }
 
+/**
+ * Get the battery voltage.
+ * 
+ * The DS task reads the voltage every fourth packet (about every 80ms), so this
+ * does not touch the analog module.
+ * 
+ * @return The battery voltage.
+ */
+float DriverStation::GetBatteryVoltage()
+{
+	return m_batteryVoltage;
+}
+
 /**
  * Read the battery voltage from the specified AnalogChannel.
  * 
@@ -201,10 +325,13 @@ void DriverStation::SetData()
  * 
  * @return The battery voltage.
  */
-float DriverStation::GetBatteryVoltage()
+float DriverStation::ReadBatteryVoltage()
 {
 	if (m_batteryChannel == NULL)
+	{
 		wpi_setWPIError(NullParameter);
+		return 0.0;
+	}
 
 	// The Analog bumper has a voltage divider on the battery source.
 	// Vbatt *--/\/\/\--* Vsample *--/\/\/\--* Gnd
@@ -227,38 +354,14 @@ float DriverStation::GetStickAxis(UINT32 stick, UINT32 axis)
 		wpi_setWPIError(BadJoystickAxis);
 		return 0.0;
 	}
-
-	INT8 value;
-	switch (stick)
+	if (stick < 1 || stick > kJoystickPorts)
 	{
-		case 1:
-			value = m_controlData->stick0Axes[axis-1];
-			break;
-		case 2:
-			value = m_controlData->stick1Axes[axis-1];
-			break;
-		case 3:
-			value = m_controlData->stick2Axes[axis-1];
-			break;
-		case 4:
-			value = m_controlData->stick3Axes[axis-1];
-			break;
-		default:
-			wpi_setWPIError(BadJoystickIndex);
-			return 0.0;
+		wpi_setWPIError(BadJoystickIndex);
+		return 0.0;
 	}
-	
-	float result;
-	if (value < 0)
-		result = ((float) value) / 128.0;
-	else
-		result = ((float) value) / 127.0;
-	wpi_assert(result <= 1.0 && result >= -1.0);
-	if (result > 1.0)
-		result = 1.0;
-	else if (result < -1.0)
-		result = -1.0;
-	return result;
+
+	MarkRead();
+	return GetPublishedControlData().stickAxes[stick-1][axis-1];
 }
 
 /**
@@ -270,25 +373,15 @@ float DriverStation::GetStickAxis(UINT32 stick, UINT32 axis)
  */
 short DriverStation::GetStickButtons(UINT32 stick)
 {
-	if (stick < 1 || stick > 4)
-		wpi_setWPIErrorWithContext(ParameterOutOfRange, "stick must be between 1 and 4");
-
-	switch (stick)
+	if (stick < 1 || stick > kJoystickPorts)
 	{
-	case 1:
-		return m_controlData->stick0Buttons;
-	case 2:
-		return m_controlData->stick1Buttons;
-	case 3:
-		return m_controlData->stick2Buttons;
-	case 4:
-		return m_controlData->stick3Buttons;
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "stick must be between 1 and 4");
+		return 0;
 	}
-	return 0;
-}
 
-// 5V divided by 10 bits
-#define kDSAnalogInScaling ((float)(5.0 / 1023.0))
+	MarkRead();
+	return GetPublishedControlData().stickButtons[stick-1];
+}
 
 /**
  * Get an analog voltage from the Driver Station.
@@ -301,8 +394,11 @@ short DriverStation::GetStickButtons(UINT32 stick)
  */
 float DriverStation::GetAnalogIn(UINT32 channel)
 {
-	if (channel < 1 || channel > 4)
+	if (channel < 1 || channel > kAnalogInChannels)
+	{
 		wpi_setWPIErrorWithContext(ParameterOutOfRange, "channel must be between 1 and 4");
+		return 0.0;
+	}
 
 	static UINT8 reported_mask = 0;
 	if (!(reported_mask & (1 >> channel)))
@@ -311,18 +407,7 @@ float DriverStation::GetAnalogIn(UINT32 channel)
 		reported_mask |= (1 >> channel);
 	}
 
-	switch (channel)
-	{
-	case 1:
-		return kDSAnalogInScaling * m_controlData->analog1;
-	case 2:
-		return kDSAnalogInScaling * m_controlData->analog2;
-	case 3:
-		return kDSAnalogInScaling * m_controlData->analog3;
-	case 4:
-		return kDSAnalogInScaling * m_controlData->analog4;
-	}
-	return 0.0;
+	return GetPublishedControlData().analogIn[channel-1];
 }
 
 /**
@@ -343,7 +428,7 @@ bool DriverStation::GetDigitalIn(UINT32 channel)
 		reported_mask |= (1 >> channel);
 	}
 
-	return ((m_controlData->dsDigitalIn >> (channel-1)) & 0x1) ? true : false;
+	return ((GetPublishedControlData().digitalIn >> (channel-1)) & 0x1) ? true : false;
 }
 
 /**
@@ -386,22 +471,22 @@ bool DriverStation::GetDigitalOut(UINT32 channel)
 
 bool DriverStation::IsEnabled()
 {
-	return m_controlData->enabled;
+	return GetPublishedControlData().enabled;
 }
 
 bool DriverStation::IsDisabled()
 {
-	return !m_controlData->enabled;
+	return !GetPublishedControlData().enabled;
 }
 
 bool DriverStation::IsAutonomous()
 {
-	return m_controlData->autonomous;
+	return GetPublishedControlData().autonomous;
 }
 
 bool DriverStation::IsOperatorControl()
 {
-	return !m_controlData->autonomous;
+	return !GetPublishedControlData().autonomous;
 }
 
 /**
@@ -414,6 +499,8 @@ bool DriverStation::IsNewControlData()
 {
 	bool newData = m_newControlData;
 	m_newControlData = false;
+	if (newData)
+		MarkRead();
 	return newData;
 }
 
@@ -424,7 +511,7 @@ bool DriverStation::IsNewControlData()
  */
 bool DriverStation::IsFMSAttached()
 {
-	return m_controlData->fmsAttached;
+	return GetPublishedControlData().fmsAttached;
 }
 
 /**
@@ -435,7 +522,7 @@ bool DriverStation::IsFMSAttached()
  */
 UINT32 DriverStation::GetPacketNumber()
 {
-	return m_controlData->packetIndex;
+	return GetPublishedControlData().packetNumber;
 }
 
 /**
@@ -445,10 +532,9 @@ UINT32 DriverStation::GetPacketNumber()
  */
 DriverStation::Alliance DriverStation::GetAlliance()
 {
-	if (m_controlData->dsID_Alliance == 'R') return kRed;
-	if (m_controlData->dsID_Alliance == 'B') return kBlue;
-	wpi_assert(false);
-	return kInvalid;
+	Alliance alliance = GetPublishedControlData().alliance;
+	wpi_assert(alliance != kInvalid);
+	return alliance;
 }
 
 /**
@@ -458,8 +544,9 @@ DriverStation::Alliance DriverStation::GetAlliance()
  */
 UINT32 DriverStation::GetLocation()
 {
-	wpi_assert ((m_controlData->dsID_Position >= '1') && (m_controlData->dsID_Position <= '3'));
-	return m_controlData->dsID_Position - '0';
+	UINT32 location = GetPublishedControlData().location;
+	wpi_assert (location >= 1 && location <= 3);
+	return location;
 }
 
 /**
@@ -470,6 +557,58 @@ UINT32 DriverStation::GetLocation()
 void DriverStation::WaitForData()
 {
 	semTake(m_waitForDataSem, WAIT_FOREVER);
+	MarkRead();
+}
+
+/**
+ * Wait until a packet newer than the one last seen has been published, or until the timeout.
+ * 
+ * Unlike WaitForData(), a packet published just before the call is not missed, because the
+ * wait is on the control sequence rather than on the moment the packet arrives.  Keep the
+ * sequence this returns and pass it back in to wake up once for every packet.
+ * Only one task at a time should use this; other tasks can use WaitForData().
+ * 
+ * @param lastSequence The control sequence of the last packet seen, from GetControlSequence()
+ * or from the previous call.
+ * @param timeout The most time to wait in seconds.  0 only checks, less than 0 waits forever.
+ * @param sequence Set to the control sequence of the latest packet, if not NULL.
+ * @return True if a new packet was published, false if the timeout expired first.
+ */
+bool DriverStation::WaitForNewData(UINT32 lastSequence, double timeout, UINT32 *sequence)
+{
+	INT32 ticks = WAIT_FOREVER;
+	if (timeout >= 0.0)
+	{
+		ticks = (INT32)((double)sysClkRateGet() * timeout);
+		// Never turn a short wait into a poll
+		if (ticks == 0 && timeout > 0.0)
+			ticks = 1;
+	}
+	UINT32 deadline = tickGet() + ticks;
+
+	while (true)
+	{
+		UINT32 current = m_controlPublishSeq;
+		if (sequence != NULL)
+			*sequence = current;
+		if (current != lastSequence)
+		{
+			MarkRead();
+			return true;
+		}
+
+		// The semaphore is given for every packet, so it may already hold one that was
+		// seen above.  Then this returns at once and the loop checks again.
+		INT32 wait = ticks;
+		if (ticks != WAIT_FOREVER)
+		{
+			wait = (INT32)(deadline - tickGet());
+			if (wait < 0)
+				wait = NO_WAIT;
+		}
+		if (semTake(m_newDataSem, wait) != OK)
+			return false;
+	}
 }
 
 /**
@@ -495,5 +634,5 @@ double DriverStation::GetMatchTime()
  */
 UINT16 DriverStation::GetTeamNumber()
 {
-	return m_controlData->teamID;
+	return GetPublishedControlData().teamNumber;
 }
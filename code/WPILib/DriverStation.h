@@ -7,6 +7,7 @@
 #ifndef __DRIVER_STATION_H__
 #define __DRIVER_STATION_H__
 
+#include "ControlLatency.h"
 #include "Dashboard.h"
 #include "DriverStationEnhancedIO.h"
 #include "SensorBase.h"
@@ -30,7 +31,29 @@ public:
 	static const UINT32 kBatteryChannel = 8;
 	static const UINT32 kJoystickPorts = 4;
 	static const UINT32 kJoystickAxes = 6;
-
+	static const UINT32 kAnalogInChannels = 4;
+
+	/**
+	 * One driver station packet, already converted to the units the getters return.
+	 * Take a copy with GetControlData() to read many inputs from the same packet.
+	 */
+	struct ControlData
+	{
+		UINT32 packetNumber;
+		UINT32 arrivalTime;		// FPGA time in microseconds the packet arrived
+		bool enabled;
+		bool autonomous;
+		bool fmsAttached;
+		Alliance alliance;
+		UINT32 location;
+		UINT16 teamNumber;
+		UINT8 digitalIn;
+		float analogIn[kAnalogInChannels];
+		float stickAxes[kJoystickPorts][kJoystickAxes];
+		short stickButtons[kJoystickPorts];
+	};
+
+	void GetControlData(ControlData *data);
 	float GetStickAxis(UINT32 stick, UINT32 axis);
 	short GetStickButtons(UINT32 stick);
 
@@ -50,6 +73,9 @@ public:
 	Alliance GetAlliance();
 	UINT32 GetLocation();
 	void WaitForData();
+	bool WaitForNewData(UINT32 lastSequence, double timeout, UINT32 *sequence = NULL);
+	/** The number of packets published so far.  Pass it to WaitForNewData(). */
+	UINT32 GetControlSequence() { return m_controlPublishSeq; }
 	double GetMatchTime();
 	float GetBatteryVoltage();
 	UINT16 GetTeamNumber();
@@ -74,7 +100,6 @@ public:
 	DriverStationEnhancedIO& GetEnhancedIO() { return m_enhancedIO; }
 
 	void IncrementUpdateNumber() { m_updateNumber++; }
-	SEM_ID GetUserStatusDataSem() { return m_statusDataSemaphore; }
 
 	/** Only to be used to tell the Driver Station what code you claim to be executing
 	 *   for diagnostic purposes only
@@ -103,11 +128,20 @@ private:
 	static const float kUpdatePeriod = 0.02;
 
 	void Run();
+	float ReadBatteryVoltage();
+	void PublishControlData();
+	const ControlData &GetPublishedControlData() { return m_controlBuffers[m_controlPublishSeq & 1]; }
+	void MarkRead()
+		{ const ControlData &data = GetPublishedControlData(); ControlLatency::MarkRead(data.packetNumber, data.arrivalTime); }
 
 	struct FRCCommonControlData *m_controlData;
+	ControlData m_controlBuffers[2];
+	volatile UINT32 m_controlWriteSeq;
+	volatile UINT32 m_controlPublishSeq;
+	UINT32 m_packetArrivalTime;
 	UINT8 m_digitalOut;
 	AnalogChannel *m_batteryChannel;
-	SEM_ID m_statusDataSemaphore;
+	float m_batteryVoltage;
 	Task m_task;
 	Dashboard m_dashboardHigh;  // the default dashboard packers
 	Dashboard m_dashboardLow;
@@ -117,6 +151,7 @@ private:
 	SEM_ID m_packetDataAvailableSem;
 	DriverStationEnhancedIO m_enhancedIO;
 	SEM_ID m_waitForDataSem;
+	SEM_ID m_newDataSem;
 	double m_approxMatchTimeOffset;
 	bool m_userInDisabled;
 	bool m_userInAutonomous;
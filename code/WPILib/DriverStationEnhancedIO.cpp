@@ -10,6 +10,8 @@
 #include "WPIErrors.h"
 #include <strLib.h>
 
+const UINT32 DriverStationEnhancedIO::kOutputRefreshPackets;
+
 /**
  * DriverStationEnhancedIO contructor.
  * 
@@ -20,6 +22,8 @@ DriverStationEnhancedIO::DriverStationEnhancedIO()
 	, m_outputValid (false)
 	, m_configChanged (false)
 	, m_requestEnhancedEnable (false)
+	, m_outputDirty (false)
+	, m_packetsSinceOutput (0)
 {
 	bzero((char*)&m_inputData, sizeof(m_inputData));
 	bzero((char*)&m_outputData, sizeof(m_outputData));
@@ -48,6 +52,7 @@ DriverStationEnhancedIO::~DriverStationEnhancedIO()
  * Called by the DriverStation class when data is available.
  * This function will set any modified configuration / output,
  * then read the input and configuration from the IO.
+ * Outputs that have not changed are only sent again every kOutputRefreshPackets packets.
  */
 void DriverStationEnhancedIO::UpdateData()
 {
@@ -55,7 +60,8 @@ void DriverStationEnhancedIO::UpdateData()
 	{
 		status_block_t tempOutputData;
 		Synchronized sync(m_outputDataSemaphore);
-		if (m_outputValid || m_configChanged || m_requestEnhancedEnable)
+		bool outputDue = m_outputDirty || ++m_packetsSinceOutput >= kOutputRefreshPackets;
+		if ((m_outputValid && outputDue) || m_configChanged || m_requestEnhancedEnable)
 		{
 			m_outputData.flags = kStatusValid;
 			if (m_requestEnhancedEnable)
@@ -73,6 +79,8 @@ void DriverStationEnhancedIO::UpdateData()
 				m_outputData.flags |= kStatusConfigChanged;
 			}
 			overrideIOConfig((char*)&m_outputData, 5);
+			m_outputDirty = false;
+			m_packetsSinceOutput = 0;
 		}
 		retVal = getDynamicControlData(kOutputBlockID, (char*)&tempOutputData, sizeof(status_block_t), 5);
 		if (retVal == 0)
@@ -290,8 +298,13 @@ void DriverStationEnhancedIO::SetAnalogOut(UINT32 channel, double value)
 		reported_mask |= (1 >> channel);
 	}
 
+	UINT8 dac = (UINT8)(value / kAnalogOutputReference * kAnalogOutputResolution);
 	Synchronized sync(m_outputDataSemaphore);
-	m_outputData.data.dac[channel-1] = (UINT8)(value / kAnalogOutputReference * kAnalogOutputResolution);
+	if (m_outputData.data.dac[channel-1] != dac)
+	{
+		m_outputData.data.dac[channel-1] = dac;
+		m_outputDirty = true;
+	}
 }
 
 /**
@@ -377,7 +390,11 @@ void DriverStationEnhancedIO::SetLED(UINT32 channel, bool value)
 	leds &= ~(1 << (channel-1));
 	if (value) leds |= 1 << (channel-1);
 
-	m_outputData.data.leds = leds;
+	if (m_outputData.data.leds != leds)
+	{
+		m_outputData.data.leds = leds;
+		m_outputDirty = true;
+	}
 }
 
 /**
@@ -394,7 +411,11 @@ void DriverStationEnhancedIO::SetLEDs(UINT8 value)
 	}
 	nUsageReporting::report(nUsageReporting::kResourceType_DriverStationEIO, 0, nUsageReporting::kDriverStationEIO_LED);
 	Synchronized sync(m_outputDataSemaphore);
-	m_outputData.data.leds = value;
+	if (m_outputData.data.leds != value)
+	{
+		m_outputData.data.leds = value;
+		m_outputDirty = true;
+	}
 }
 
 /**
@@ -474,7 +495,11 @@ void DriverStationEnhancedIO::SetDigitalOutput(UINT32 channel, bool value)
 		digital &= ~(1 << (channel-1));
 		if (value) digital |= 1 << (channel-1);
 	
-		m_outputData.data.digital = digital;
+		if (m_outputData.data.digital != digital)
+		{
+			m_outputData.data.digital = digital;
+			m_outputDirty = true;
+		}
 	}
 	else
 	{
@@ -773,7 +798,11 @@ void DriverStationEnhancedIO::SetFixedDigitalOutput(UINT32 channel, bool value)
 	digital &= ~(1 << (channel-1));
 	if (value) digital |= 1 << (channel-1);
 
-	m_outputData.data.fixed_digital_out = digital;
+	if (m_outputData.data.fixed_digital_out != digital)
+	{
+		m_outputData.data.fixed_digital_out = digital;
+		m_outputDirty = true;
+	}
 }
 
 /**
@@ -968,7 +997,149 @@ void DriverStationEnhancedIO::SetPWMOutput(UINT32 channel, double value)
 	if (value > 1.0) value = 1.0;
 	else if (value < 0.0) value = 0.0;
 	Synchronized sync(m_outputDataSemaphore);
-	m_outputData.data.pwm_compare[channel - 1] = (UINT16)(value * (double)m_outputData.data.pwm_period[(channel - 1) >> 1]);
+	UINT16 compare = (UINT16)(value * (double)m_outputData.data.pwm_period[(channel - 1) >> 1]);
+	if (m_outputData.data.pwm_compare[channel - 1] != compare)
+	{
+		m_outputData.data.pwm_compare[channel - 1] = compare;
+		m_outputDirty = true;
+	}
+}
+
+/**
+ * Read all of the inputs from the IO board at once.
+ * 
+ * All of the values come from the same packet and the input lock is taken only once,
+ * so this is cheaper than calling the individual Get methods for each channel.
+ * 
+ * @param inputs Filled in with the current inputs.
+ * @return True if the inputs are valid, false if Enhanced mode is not available.
+ */
+bool DriverStationEnhancedIO::GetInputs(Inputs *inputs)
+{
+	if (inputs == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return false;
+	}
+	if (!m_inputValid)
+	{
+		wpi_setWPIError(EnhancedIOMissing);
+		return false;
+	}
+
+	input_t data;
+	INT16 encoderOffsets[2];
+	{
+		Synchronized sync(m_inputDataSemaphore);
+		data = m_inputData.data;
+		encoderOffsets[0] = m_encoderOffsets[0];
+		encoderOffsets[1] = m_encoderOffsets[1];
+	}
+
+	for (UINT32 i = 0; i < 8; i++)
+	{
+		inputs->analogIn[i] = data.analog[i] / kAnalogInputResolution * kAnalogInputReference;
+	}
+	for (UINT32 i = 0; i < 3; i++)
+	{
+		inputs->acceleration[i] = (data.accel[i] - kAccelOffset) / kAccelScale;
+	}
+	inputs->encoders[0] = data.quad[0] - encoderOffsets[0];
+	inputs->encoders[1] = data.quad[1] - encoderOffsets[1];
+	inputs->digitals = data.digital;
+	inputs->buttons = data.buttons;
+	inputs->touchSlider = data.capsense_slider == 255 ? -1.0 : data.capsense_slider / 254.0;
+	return true;
+}
+
+/**
+ * Read all of the outputs currently staged for the IO board at once.
+ * 
+ * Use this with SetOutputs() to change several outputs while taking the output lock
+ * only once each way.
+ * 
+ * @param outputs Filled in with the current outputs.
+ * @return True if the outputs are valid, false if Enhanced mode is not available.
+ */
+bool DriverStationEnhancedIO::GetOutputs(Outputs *outputs)
+{
+	if (outputs == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return false;
+	}
+	if (!m_outputValid)
+	{
+		wpi_setWPIError(EnhancedIOMissing);
+		return false;
+	}
+
+	output_t data;
+	{
+		Synchronized sync(m_outputDataSemaphore);
+		data = m_outputData.data;
+	}
+
+	outputs->leds = data.leds;
+	outputs->digitals = data.digital & data.digital_oe;
+	outputs->fixedDigitals = data.fixed_digital_out;
+	for (UINT32 i = 0; i < 2; i++)
+	{
+		outputs->analogOut[i] = data.dac[i] * kAnalogOutputReference / kAnalogOutputResolution;
+	}
+	for (UINT32 i = 0; i < 4; i++)
+	{
+		outputs->pwmOutput[i] = (double)data.pwm_compare[i] / (double)data.pwm_period[i >> 1];
+	}
+	return true;
+}
+
+/**
+ * Stage all of the outputs for the IO board at once.
+ * 
+ * The output lock is taken only once.  Digital lines that are not configured as outputs
+ * are left alone.  A new output packet is only sent to the IO board if something changed.
+ * 
+ * @param outputs The outputs to set, usually read with GetOutputs() and then modified.
+ */
+void DriverStationEnhancedIO::SetOutputs(const Outputs &outputs)
+{
+	if (!m_outputValid)
+	{
+		wpi_setWPIError(EnhancedIOMissing);
+		return;
+	}
+
+	UINT8 dac[2];
+	for (UINT32 i = 0; i < 2; i++)
+	{
+		double value = outputs.analogOut[i];
+		if (value < 0.0) value = 0.0;
+		if (value > kAnalogOutputReference) value = kAnalogOutputReference;
+		dac[i] = (UINT8)(value / kAnalogOutputReference * kAnalogOutputResolution);
+	}
+
+	Synchronized sync(m_outputDataSemaphore);
+	output_t data = m_outputData.data;
+
+	data.leds = outputs.leds;
+	data.digital = (data.digital & ~data.digital_oe) | (outputs.digitals & data.digital_oe);
+	data.fixed_digital_out = outputs.fixedDigitals & 0x3;
+	data.dac[0] = dac[0];
+	data.dac[1] = dac[1];
+	for (UINT32 i = 0; i < 4; i++)
+	{
+		double value = outputs.pwmOutput[i];
+		if (value > 1.0) value = 1.0;
+		else if (value < 0.0) value = 0.0;
+		data.pwm_compare[i] = (UINT16)(value * (double)data.pwm_period[i >> 1]);
+	}
+
+	if (memcmp(&data, &m_outputData.data, sizeof(data)) != 0)
+	{
+		m_outputData.data = data;
+		m_outputDirty = true;
+	}
 }
 
 /**
@@ -99,6 +99,31 @@ public:
 	enum tAccelChannel {kAccelX = 0, kAccelY = 1, kAccelZ = 2};
 	enum tPWMPeriodChannels {kPWMChannels1and2, kPWMChannels3and4};
 
+	/** All of the inputs from one packet, in the units the individual Get methods return. */
+	struct Inputs
+	{
+		double analogIn[8];		// volts
+		double acceleration[3];	// Gs, indexed by tAccelChannel
+		INT16 encoders[2];
+		UINT16 digitals;		// DIO1 is lsb
+		UINT8 buttons;			// Button1 is lsb
+		double touchSlider;		// -1.0 if not touched
+	};
+
+	/** All of the outputs that can be staged at once. */
+	struct Outputs
+	{
+		UINT8 leds;				// LED1 is lsb
+		UINT16 digitals;		// DIO1 is lsb, only lines configured as outputs are driven
+		UINT8 fixedDigitals;	// 2 lsb
+		double analogOut[2];	// volts
+		double pwmOutput[4];	// duty-cycle [0.0,1.0]
+	};
+
+	bool GetInputs(Inputs *inputs);
+	bool GetOutputs(Outputs *outputs);
+	void SetOutputs(const Outputs &outputs);
+
 	double GetAcceleration(tAccelChannel channel);
 	double GetAnalogIn(UINT32 channel);
 	double GetAnalogInRatio(UINT32 channel);
@@ -129,6 +154,8 @@ public:
 private:
 	DriverStationEnhancedIO();
 	virtual ~DriverStationEnhancedIO();
+	static const UINT32 kOutputRefreshPackets = 25;
+
 	void UpdateData();
 	void MergeConfigIntoOutput(const status_block_t &dsOutputBlock, status_block_t &localCache);
 	bool IsConfigEqual(const status_block_t &dsOutputBlock, const status_block_t &localCache);
@@ -144,6 +171,8 @@ private:
 	bool m_outputValid;
 	bool m_configChanged;
 	bool m_requestEnhancedEnable;
+	bool m_outputDirty;
+	UINT32 m_packetsSinceOutput;
 	INT16 m_encoderOffsets[2];
 };
 
@@ -9,6 +9,7 @@
 #include "NetworkCommunication/UsageReporting.h"
 #include "Synchronized.h"
 #include "WPIErrors.h"
+#include <algorithm>
 #include <strLib.h>
 
 const UINT32 DriverStationLCD::kSyncTimeout_ms;
@@ -146,6 +147,65 @@ void DriverStationLCD::PrintfLine(Line line, const char *writeFmt, ...)
 	va_end (args);
 }
 
+/**
+ * Copy preformatted text to the Driver Station LCD text buffer.
+ * 
+ * This is the same as Printf() without formatting, so use a TextFormatter to build
+ * the text when Printf() is too slow for a periodic loop.
+ * 
+ * @param line The line on the LCD to print to.
+ * @param startingColumn The column to start printing to.  This is a 1-based number.
+ * @param text The text to print.  It does not need to be NULL terminated.
+ * @param length The number of characters of text.
+ */
+void DriverStationLCD::Print(Line line, INT32 startingColumn, const char *text, INT32 length)
+{
+	if (startingColumn < 1 || startingColumn > kLineLength)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "startingColumn");
+		return;
+	}
+
+	if (line < kMain_Line6 || line > kUser_Line6)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "line");
+		return;
+	}
+
+	UINT32 start = startingColumn - 1;
+	length = std::max(0, std::min(length, (INT32)(kLineLength - start)));
+
+	Synchronized sync(m_textBufferSemaphore);
+	memcpy(m_textBuffer + start + line * kLineLength + sizeof(UINT16), text, length);
+}
+
+/**
+ * Copy preformatted text to the Driver Station LCD text buffer. This function 
+ * pads the line with empty spaces. 
+ * 
+ * This is the same as PrintfLine() without formatting, so use a TextFormatter to
+ * build the text when PrintfLine() is too slow for a periodic loop.
+ * 
+ * @param line The line on the LCD to print to.
+ * @param text The text to print.  It does not need to be NULL terminated.
+ * @param length The number of characters of text.
+ */
+void DriverStationLCD::PrintLine(Line line, const char *text, INT32 length)
+{
+	if (line < kMain_Line6 || line > kUser_Line6)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "line");
+		return;
+	}
+
+	length = std::max(0, std::min(length, kLineLength));
+	char *lineBuffer = m_textBuffer + line * kLineLength + sizeof(UINT16);
+
+	Synchronized sync(m_textBufferSemaphore);
+	memcpy(lineBuffer, text, length);
+	memset(lineBuffer + length, ' ', kLineLength - length);
+}
+
 /**
  *  Clear all lines on the LCD.
  */
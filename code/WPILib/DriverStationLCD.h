@@ -30,6 +30,8 @@ public:
 	void UpdateLCD();
 	void Printf(Line line, INT32 startingColumn, const char *writeFmt, ...);
 	void PrintfLine(Line line, const char *writeFmt, ...);
+	void Print(Line line, INT32 startingColumn, const char *text, INT32 length);
+	void PrintLine(Line line, const char *text, INT32 length);
  
 	void Clear();
 
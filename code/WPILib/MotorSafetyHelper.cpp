@@ -9,13 +9,17 @@
 #include "DriverStation.h"
 #include "MotorSafety.h"
 #include "Synchronized.h"
-#include "Timer.h"
+#include "Utility.h"
 #include "WPIErrors.h"
 
 #include <stdio.h>
 
-MotorSafetyHelper *MotorSafetyHelper::m_headHelper = NULL;
-SEM_ID MotorSafetyHelper::m_listMutex = NULL;
+const UINT32 MotorSafetyHelper::kMaxHelpers;
+const UINT32 MotorSafetyHelper::kMaxGroups;
+MotorSafetyHelper::Entry MotorSafetyHelper::m_entries[kMaxHelpers];
+UINT32 MotorSafetyHelper::m_numEntries = 0;
+UINT32 MotorSafetyHelper::m_groupExpirations[kMaxGroups];
+SEM_ID MotorSafetyHelper::m_listMutex = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
 
 /**
  * The constructor for a MotorSafetyHelper object.
@@ -27,54 +31,52 @@ SEM_ID MotorSafetyHelper::m_listMutex = NULL;
  * to call the Stop() method on the motor.
  */
 MotorSafetyHelper::MotorSafetyHelper(MotorSafety *safeObject)
+	: m_entry (NULL)
+	, m_safeObject (safeObject)
 {
-	if (m_listMutex == NULL)
-		m_listMutex = semMCreate(SEM_Q_PRIORITY | SEM_DELETE_SAFE | SEM_INVERSION_SAFE);
-	m_safeObject = safeObject;
-	m_enabled = false;
-	m_expiration = DEFAULT_SAFETY_EXPIRATION;
-	m_stopTime = Timer::GetFPGATimestamp();
-
 	Synchronized sync(m_listMutex);
-	m_nextHelper = m_headHelper;
-	m_headHelper = this;
+	for (UINT32 i = 0; i < kMaxHelpers; i++)
+	{
+		if (m_entries[i].helper == NULL)
+		{
+			m_entry = &m_entries[i];
+			if (i >= m_numEntries)
+				m_numEntries = i + 1;
+			break;
+		}
+	}
+	if (m_entry == NULL)
+	{
+		// Still a working helper, but CheckMotors() will not see it
+		wpi_setWPIErrorWithContext(NoAvailableResources, "too many MotorSafetyHelpers, this motor will not be checked");
+		m_entry = &m_unlistedEntry;
+	}
+	m_entry->enabled = false;
+	m_entry->group = 0;
+	m_entry->expiration = (UINT32)(DEFAULT_SAFETY_EXPIRATION * 1e6);
+	// Start out expired until the motor is fed for the first time
+	m_entry->feedTime = GetFPGATime() - m_entry->expiration - 1;
+	m_entry->helper = this;
 }
 
 
 MotorSafetyHelper::~MotorSafetyHelper()
 {
-	semTake(m_listMutex, WAIT_FOREVER);
-	if (m_headHelper == this)
-	{
-		m_headHelper = m_nextHelper;
-	}
-	else
-	{
-		MotorSafetyHelper *prev = NULL;
-		MotorSafetyHelper *cur = m_headHelper;
-		while (cur != this && cur != NULL)
-			prev = cur, cur = cur->m_nextHelper;
-		if (cur == this)
-			prev->m_nextHelper = cur->m_nextHelper;
-	}
-	if (m_headHelper == NULL)
-	{
-		semDelete(m_listMutex);
-		m_listMutex = NULL;
-	}
-	else
-	{
-		semGive(m_listMutex);
-	}
+	Synchronized sync(m_listMutex);
+	m_entry->enabled = false;
+	m_entry->helper = NULL;
+	while (m_numEntries > 0 && m_entries[m_numEntries - 1].helper == NULL)
+		m_numEntries--;
 }
 
 /*
  * Feed the motor safety object.
  * Resets the timer on this object that is used to do the timeouts.
+ * This is a single store of the FPGA time, so it takes no locks.
  */
 void MotorSafetyHelper::Feed()
 {
-	m_stopTime = Timer::GetFPGATimestamp() + m_expiration;
+	m_entry->feedTime = GetFPGATime();
 }
 
 /*
@@ -83,7 +85,7 @@ void MotorSafetyHelper::Feed()
  */
 void MotorSafetyHelper::SetExpiration(float expirationTime)
 {
-	m_expiration = expirationTime;
+	m_entry->expiration = (UINT32)(expirationTime * 1e6);
 }
 
 /**
@@ -92,7 +94,7 @@ void MotorSafetyHelper::SetExpiration(float expirationTime)
  */
 float MotorSafetyHelper::GetExpiration()
 {
-	return m_expiration;
+	return m_entry->expiration * 1e-6;
 }
 
 /**
@@ -101,7 +103,7 @@ float MotorSafetyHelper::GetExpiration()
  */
 bool MotorSafetyHelper::IsAlive()
 {
-	return !m_enabled || m_stopTime > Timer::GetFPGATimestamp();
+	return !m_entry->enabled || !IsExpired(*m_entry, GetFPGATime());
 }
 
 /**
@@ -112,17 +114,10 @@ bool MotorSafetyHelper::IsAlive()
  */
 void MotorSafetyHelper::Check()
 {
-	if (!m_enabled) return;
+	if (!m_entry->enabled) return;
 	if (DriverStation::GetInstance()->IsDisabled()) return;
-	if (m_stopTime < Timer::GetFPGATimestamp())
-	{
-		char buf[128];
-		char desc[64];
-		m_safeObject->GetDescription(desc);
-		snprintf(buf, 128, "%s... Output not updated often enough.", desc);
-		wpi_setWPIErrorWithContext(Timeout, buf);
-		m_safeObject->StopMotor();
-	}
+	if (IsExpired(*m_entry, GetFPGATime()))
+		Expire();
 }
 
 /**
@@ -132,7 +127,7 @@ void MotorSafetyHelper::Check()
  */
 void MotorSafetyHelper::SetSafetyEnabled(bool enabled)
 {
-	m_enabled = enabled;
+	m_entry->enabled = enabled;
 }
 
 /**
@@ -142,20 +137,106 @@ void MotorSafetyHelper::SetSafetyEnabled(bool enabled)
  */
 bool MotorSafetyHelper::IsSafetyEnabled()
 {
-	return m_enabled;
+	return m_entry->enabled;
+}
+
+/**
+ * Put this motor in a group.
+ * If the group has an expiration set with SetGroupExpiration(), it is used instead of
+ * this motor's own expiration.  This lets a set of motors, e.g. a drive train, share one
+ * timeout that can be changed at once.
+ * @param group The group number [1..kMaxGroups-1], or 0 to use only this motor's expiration.
+ */
+void MotorSafetyHelper::SetGroup(UINT32 group)
+{
+	if (group >= kMaxGroups)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "group must be less than kMaxGroups");
+		return;
+	}
+	m_entry->group = group;
+}
+
+/**
+ * Return the group this motor is in.
+ * @returns The group number, 0 if the motor is not in a group.
+ */
+UINT32 MotorSafetyHelper::GetGroup()
+{
+	return m_entry->group;
+}
+
+/**
+ * Set the expiration time shared by all the motors in a group.
+ * @param group The group number [1..kMaxGroups-1].
+ * @param expirationTime The timeout value in seconds, or 0 to have each motor use its own.
+ */
+void MotorSafetyHelper::SetGroupExpiration(UINT32 group, float expirationTime)
+{
+	if (group == 0 || group >= kMaxGroups)
+	{
+		wpi_setGlobalWPIErrorWithContext(ParameterOutOfRange, "group must be between 1 and kMaxGroups-1");
+		return;
+	}
+	m_groupExpirations[group] = (UINT32)(expirationTime * 1e6);
+}
+
+/**
+ * Retrieve the expiration time shared by all the motors in a group.
+ * @param group The group number [1..kMaxGroups-1].
+ * @returns The timeout value in seconds, 0 if the group does not have one.
+ */
+float MotorSafetyHelper::GetGroupExpiration(UINT32 group)
+{
+	if (group == 0 || group >= kMaxGroups)
+		return 0.0;
+	return m_groupExpirations[group] * 1e-6;
 }
 
 /**
  * Check the motors to see if any have timed out.
  * This static  method is called periodically to poll all the motors and stop any that have
- * timed out.
+ * timed out.  It is one pass over the array of entries, and the lock is only taken once per
+ * pass to keep helpers from being destroyed while they are checked.
  */
-//TODO: these should be synchronized with the setting methods in case it's called from a different thread
 void MotorSafetyHelper::CheckMotors()
 {
+	if (m_numEntries == 0) return;
+	if (DriverStation::GetInstance()->IsDisabled()) return;
+
 	Synchronized sync(m_listMutex);
-	for (MotorSafetyHelper *msh = m_headHelper; msh != NULL; msh = msh->m_nextHelper)
+	UINT32 now = GetFPGATime();
+	for (UINT32 i = 0; i < m_numEntries; i++)
 	{
-		msh->Check();
+		const Entry &entry = m_entries[i];
+		if (entry.enabled && entry.helper != NULL && IsExpired(entry, now))
+			entry.helper->Expire();
 	}
 }
+
+/**
+ * Has the motor gone longer than its expiration without being fed?
+ * The FPGA clock wraps every 71 minutes, so the time since the last feed is taken as a difference.
+ * The difference is signed because a task may feed the motor after now was read, e.g. while
+ * CheckMotors() is blocked stopping another motor, and that feed must not count as expired.
+ */
+bool MotorSafetyHelper::IsExpired(const Entry &entry, UINT32 now)
+{
+	UINT32 expiration = entry.expiration;
+	if (entry.group != 0 && m_groupExpirations[entry.group] != 0)
+		expiration = m_groupExpirations[entry.group];
+	return (INT32)(now - entry.feedTime) > (INT32)expiration;
+}
+
+/**
+ * Report the timeout and stop the motor.
+ */
+void MotorSafetyHelper::Expire()
+{
+	char buf[128];
+	char desc[64];
+	m_safeObject->GetDescription(desc);
+	snprintf(buf, 128, "%s... Output not updated often enough.", desc);
+	wpi_setWPIErrorWithContext(Timeout, buf);
+	m_safeObject->StopMotor();
+}
@@ -15,6 +15,9 @@ class MotorSafety;
 class MotorSafetyHelper : public ErrorBase
 {
 public:
+	static const UINT32 kMaxHelpers = 128;
+	static const UINT32 kMaxGroups = 8;
+
 	MotorSafetyHelper(MotorSafety *safeObject);
 	~MotorSafetyHelper();
 	void Feed();
@@ -24,15 +27,32 @@ public:
 	void Check();
 	void SetSafetyEnabled(bool enabled);
 	bool IsSafetyEnabled();
+	void SetGroup(UINT32 group);
+	UINT32 GetGroup();
+	static void SetGroupExpiration(UINT32 group, float expirationTime);
+	static float GetGroupExpiration(UINT32 group);
 	static void CheckMotors();
 private:
-	double m_expiration;			// the expiration time for this object
-	bool m_enabled;					// true if motor safety is enabled for this motor
-	double m_stopTime; 				// the FPGA clock value when this motor has expired
+	// Everything CheckMotors() looks at for one helper, kept together in one array
+	struct Entry
+	{
+		volatile UINT32 feedTime;	// the FPGA clock value when this motor was last fed
+		UINT32 expiration;			// the expiration time for this object in microseconds
+		UINT32 group;				// the group whose expiration overrides this one, 0 for none
+		bool enabled;				// true if motor safety is enabled for this motor
+		MotorSafetyHelper *helper;	// the helper using this entry, NULL if the entry is free
+	};
+
+	static bool IsExpired(const Entry &entry, UINT32 now);
+	void Expire();
+
+	Entry *m_entry;					// this helper's entry in the array of entries
+	Entry m_unlistedEntry;			// used instead if the array of entries is full
 	MotorSafety *m_safeObject;		// the object that is using the helper
-	MotorSafetyHelper *m_nextHelper; // next object in the list of MotorSafetyHelpers
-	static MotorSafetyHelper *m_headHelper; // the head of the list of MotorSafetyHelper objects
-	static SEM_ID m_listMutex;		// protect accesses to the list of helpers
+	static Entry m_entries[kMaxHelpers]; // the entries of all MotorSafetyHelper objects
+	static UINT32 m_numEntries;		// the entries in use are all below this index
+	static UINT32 m_groupExpirations[kMaxGroups]; // the expiration of each group in microseconds, 0 if not set
+	static SEM_ID m_listMutex;		// protect adding and removing entries
 };
 
 #endif
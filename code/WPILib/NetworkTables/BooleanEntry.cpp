@@ -6,15 +6,28 @@
 
 #include "NetworkTables/BooleanEntry.h"
 #include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
 
 namespace NetworkTables
 {
 
+FreeList BooleanEntry::_freeList("BooleanEntry", sizeof(BooleanEntry));
+
 BooleanEntry::BooleanEntry(bool value) :
 	m_value(value)
 {
 }
 
+void *BooleanEntry::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void BooleanEntry::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
 NetworkTables_Types BooleanEntry::GetType()
 {
 	return kNetworkTables_Types_BOOLEAN;
@@ -32,4 +45,9 @@ bool BooleanEntry::GetBoolean()
 	return m_value;
 }
 
+bool BooleanEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((BooleanEntry *)other)->m_value == m_value;
+}
+
 } // namespace
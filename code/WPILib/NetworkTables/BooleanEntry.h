@@ -17,16 +17,22 @@ namespace NetworkTables
 {
 
 class Buffer;
+class FreeList;
 
 class BooleanEntry : public Entry {
 public:
 	BooleanEntry(bool value);
+	static void *operator new(size_t size);
+	static void operator delete(void *block, size_t size);
 	virtual NetworkTables_Types GetType();
 	virtual void Encode(Buffer *buffer);
 	virtual bool GetBoolean();
+	virtual bool Equals(Entry *other);
 
 private:
 	bool m_value;
+
+	static FreeList _freeList;
 };
 
 } // namespace
@@ -16,7 +16,9 @@ namespace NetworkTables
 Buffer::Buffer(UINT32 capacity) :
 	m_buffer (NULL),
 	m_size (0),
-	m_capacity (capacity)
+	m_capacity (capacity),
+	m_overflowed (false),
+	m_writeCalls (0)
 {
 	m_buffer = new UINT8[capacity];
 }
@@ -84,14 +86,21 @@ void Buffer::WriteByte(UINT8 entry)
 {
 	if (m_size >= m_capacity)
 	{
-		wpi_setWPIError(NetworkTablesBufferFull);
+		// The writer decides whether to flush and retry or report the error
+		m_overflowed = true;
 		return;
 	}
 	m_buffer[m_size++] = entry;
 }
 
-void Buffer::Flush(int socket)
+/**
+ * Write the buffer to the socket, retrying until all of it is sent.
+ * @return True if everything was written, false on a socket error.
+ */
+bool Buffer::Flush(int socket)
 {
+	UINT32 sent = 0;
+
 #ifdef DEBUG
 	if (m_size != 1 || m_buffer[0] != kNetworkTables_PING)
 	{
@@ -99,7 +108,8 @@ void Buffer::Flush(int socket)
 		char buf[128];
 		char *pbuf = buf;
 		pbuf = pbuf + snprintf(pbuf, 128 - (pbuf - buf), "\nO:");
-		for (i=0; i<m_size; i++)
+		// Batches can be larger than the dump buffer, so only show the start
+		for (i=0; i<m_size && pbuf - buf < 128 - 3; i++)
 		{
 			pbuf = pbuf + snprintf(pbuf, 128 - (pbuf - buf), "%02X", m_buffer[i]);
 		}
@@ -107,13 +117,48 @@ void Buffer::Flush(int socket)
 		printf(buf);
 	}
 #endif
-	write(socket, (char *)m_buffer, m_size);
+	while (sent < m_size)
+	{
+		int retval = write(socket, (char *)m_buffer + sent, m_size - sent);
+		m_writeCalls++;
+		if (retval == ERROR)
+			break;
+		sent += retval;
+	}
+	bool complete = sent == m_size;
 	Clear();
+	return complete;
 }
 
 void Buffer::Clear()
 {
-	m_size = 0;
+	Rewind(0);
+}
+
+/**
+ * Discard everything written after the given size.
+ * Used to take back an entry that did not fit.
+ */
+void Buffer::Rewind(UINT32 size)
+{
+	if (size < m_size)
+		m_size = size;
+	m_overflowed = false;
+}
+
+/**
+ * Grow the buffer to hold at least the given number of bytes.
+ * The contents are kept.
+ */
+void Buffer::Reserve(UINT32 capacity)
+{
+	if (capacity <= m_capacity)
+		return;
+	UINT8 *buffer = new UINT8[capacity];
+	memcpy(buffer, m_buffer, m_size);
+	delete [] m_buffer;
+	m_buffer = buffer;
+	m_capacity = capacity;
 }
 
 void Buffer::WriteVariableSize(UINT32 tag, UINT32 id)
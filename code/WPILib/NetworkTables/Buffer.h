@@ -28,8 +28,15 @@ public:
 	void WriteTableId(UINT32 id);
 	void WriteBytes(UINT32 length, const UINT8 *entries);
 	void WriteByte(UINT8 entry);
-	void Flush(int socket);
+	bool Flush(int socket);
 	void Clear();
+	UINT32 GetSize() {return m_size;}
+	UINT32 GetCapacity() {return m_capacity;}
+	const UINT8 *GetData() {return m_buffer;}
+	void Reserve(UINT32 capacity);
+	void Rewind(UINT32 size);
+	bool IsOverflowed() {return m_overflowed;}
+	UINT32 GetWriteCalls() {return m_writeCalls;}
 
 private:
 	void WriteVariableSize(UINT32 tag, UINT32 id);
@@ -37,6 +44,9 @@ private:
 	UINT8 *m_buffer;
 	UINT32 m_size;
 	UINT32 m_capacity;
+	bool m_overflowed;
+	/** The number of write() calls made by this buffer, for benchmarking */
+	UINT32 m_writeCalls;
 };
 
 } // namespace
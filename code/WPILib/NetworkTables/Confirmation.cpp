@@ -6,16 +6,29 @@
 
 #include "NetworkTables/Confirmation.h"
 #include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
 #include "NetworkTables/InterfaceConstants.h"
 
 namespace NetworkTables
 {
 
+FreeList Confirmation::_freeList("Confirmation", sizeof(Confirmation));
+
 Confirmation::Confirmation(int count) :
 	m_count(count)
 {
 }
 
+void *Confirmation::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void Confirmation::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
 void Confirmation::Encode(Buffer *buffer)
 {
 	for (int i = m_count; i > 0; i -= kNetworkTables_CONFIRMATION - 1)
@@ -8,21 +8,27 @@
 #define __CONFIRMATION_H__
 
 #include "NetworkTables/Data.h"
+#include <vxWorks.h>
 
 namespace NetworkTables
 {
 
 class Buffer;
+class FreeList;
 
 class Confirmation : public Data
 {
 public:
 	Confirmation(int count);
+	static void *operator new(size_t size);
+	static void operator delete(void *block, size_t size);
 	virtual void Encode(Buffer *buffer);
 private:
 	static Confirmation *Combine(Confirmation *a, Confirmation *b);
 
 	int m_count;
+
+	static FreeList _freeList;
 };
 
 } // namespace
@@ -18,14 +18,18 @@
 #include "NetworkTables/NetworkTable.h"
 #include "NetworkTables/OldData.h"
 #include "NetworkTables/Reader.h"
+#include "NetworkTables/Snapshot.h"
 #include "NetworkTables/TableAssignment.h"
 #include "NetworkTables/TableEntry.h"
 #include "NetworkTables/TransactionEnd.h"
 #include "NetworkTables/TransactionStart.h"
 #include "Synchronized.h"
 #include "Timer.h"
+#include "Utility.h"
 #include "WPIErrors.h"
+#include <algorithm>
 #include <inetLib.h>
+#include <selectLib.h>
 #include <semLib.h>
 #include <sockLib.h>
 #include <string>
@@ -35,35 +39,50 @@ namespace NetworkTables
 {
 
 const UINT32 Connection::kWriteDelay;
+const UINT32 Connection::kWriteBufferSize;
 const UINT32 Connection::kTimeout;
+const UINT32 Connection::kMaxFieldId;
 
 Connection::Connection(int socket) :
 	m_socket(socket),
+	m_wakeupSocket(ERROR),
 	m_dataLock(NULL),
-	m_dataAvailable(NULL),
-	m_watchdogLock(NULL),
-	m_watchdogFood(NULL),
 	m_queue(NULL),
 	m_transaction(NULL),
 	m_connected(true),
 	m_inTransaction(false),
 	m_denyTransaction(false),
-	m_watchdogActive(false),
-	m_watchdogFed(false),
-	m_readTask("NetworkTablesReadTask", (FUNCPTR)Connection::InitReadTask),
-	m_writeTask("NetworkTablesWriteTask", (FUNCPTR)Connection::InitWriteTask),
-	m_watchdogTask("NetworkTablesWatchdogTask", (FUNCPTR)Connection::InitWatchdogTask),
+	m_wakeupPending(false),
+	m_writeCalls(0),
+	m_recvCalls(0),
+	m_ioTask("NetworkTablesIoTask", (FUNCPTR)Connection::InitIoTask),
 	m_transactionStart(NULL),
 	m_transactionEnd(NULL)
 {
 	m_dataLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
-	m_dataAvailable = semBCreate (SEM_Q_PRIORITY, SEM_EMPTY);
-	m_watchdogLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
-	m_watchdogFood = semBCreate (SEM_Q_PRIORITY, SEM_EMPTY);
 	m_queue = new NetworkQueue();
 	m_transaction = new NetworkQueue();
 	m_transactionStart = new TransactionStart();
 	m_transactionEnd = new TransactionEnd();
+
+	// A datagram socket connected to itself, so queuing data can wake the select() in the I/O task
+	struct sockaddr_in wakeupAddr;
+	int sockAddrSize = sizeof(wakeupAddr);
+	bzero((char *)&wakeupAddr, sockAddrSize);
+	wakeupAddr.sin_len = (u_char)sockAddrSize;
+	wakeupAddr.sin_family = AF_INET;
+	wakeupAddr.sin_port = htons(0);
+	wakeupAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if ((m_wakeupSocket = ::socket(AF_INET, SOCK_DGRAM, 0)) == ERROR
+		|| bind(m_wakeupSocket, (struct sockaddr *)&wakeupAddr, sockAddrSize) == ERROR
+		|| getsockname(m_wakeupSocket, (struct sockaddr *)&wakeupAddr, &sockAddrSize) == ERROR
+		|| connect(m_wakeupSocket, (struct sockaddr *)&wakeupAddr, sockAddrSize) == ERROR)
+	{
+		wpi_setErrnoErrorWithContext("Could not create NetworkTables wakeup socket");
+		if (m_wakeupSocket != ERROR)
+			close(m_wakeupSocket);
+		m_wakeupSocket = ERROR;
+	}
 }
 
 Connection::~Connection()
@@ -72,10 +91,8 @@ Connection::~Connection()
 	delete m_transactionStart;
 	delete m_transaction;
 	delete m_queue;
-	semDelete(m_watchdogFood);
-	semTake(m_watchdogLock, WAIT_FOREVER);
-	semDelete(m_watchdogLock);
-	semDelete(m_dataAvailable);
+	if (m_wakeupSocket != ERROR)
+		close(m_wakeupSocket);
 	semTake(m_dataLock, WAIT_FOREVER);
 	semDelete(m_dataLock);
 }
@@ -102,7 +119,7 @@ void Connection::OfferTransaction(NetworkQueue *transaction)
 		m_queue->Offer(it->first);
 	}
 	m_queue->Offer(m_transactionEnd);
-	semGive(m_dataAvailable);
+	Wakeup();
 }
 
 void Connection::Offer(Data *data)
@@ -116,7 +133,7 @@ void Connection::Offer(Data *data)
 			table->AddConnection(this);
 		}
 		m_queue->Offer(data);
-		semGive(m_dataAvailable);
+		Wakeup();
 	}
 }
 
@@ -129,349 +146,462 @@ void Connection::Offer(std::auto_ptr<Data> autoData)
 		table->AddConnection(this);
 	}
 	m_queue->Offer(autoData);
-	semGive(m_dataAvailable);
+	Wakeup();
+}
+
+/**
+ * Tell the I/O task that there is data to send.
+ * Only one wakeup is outstanding at a time, so the socket can never fill up.
+ */
+void Connection::Wakeup()
+{
+	Synchronized sync(m_dataLock);
+	if (!m_wakeupPending)
+	{
+		char wakeup = 0;
+		m_wakeupPending = true;
+		send(m_wakeupSocket, &wakeup, sizeof(wakeup), 0);
+	}
 }
 
 void Connection::Start()
 {
-	m_watchdogTask.Start((UINT32)this);
-	m_readTask.Start((UINT32)this);
-	m_writeTask.Start((UINT32)this);
+	if (m_wakeupSocket == ERROR)
+	{
+		Close();
+		return;
+	}
+	m_ioTask.Start((UINT32)this);
 }
 
-void Connection::ReadTaskRun()
+/**
+ * Reads, writes and keeps the connection alive from a single select() loop.
+ * Pings are sent after kWriteDelay without writing anything, and the connection
+ * is dropped after kTimeout without receiving anything once the peer has spoken.
+ * Values the tables held back to honor their minimum publish interval are sent
+ * from here once the interval expires.
+ */
+void Connection::IoTaskRun()
 {
 	Reader input(this, m_socket);
-	int value;
-	
-	value = input.Read();
+	std::auto_ptr<Buffer> buffer = std::auto_ptr<Buffer>(new Buffer(kWriteBufferSize));
+	bool watchdogActive = false;
+	UINT32 lastRead = GetFPGATime();
+	UINT32 lastWrite = lastRead;
+
 	while (m_connected)
 	{
-		WatchdogFeed();
-		WatchdogActivate();
+		// Send the values held back by a publish interval that are due, and
+		// wake up again in time for the next one
+		UINT32 wait = NetworkTable::PublishPending();
+		UINT32 now = GetFPGATime();
+		wait = std::min(wait, kWriteDelay * 1000 - std::min(now - lastWrite, kWriteDelay * 1000));
+		if (watchdogActive)
+			wait = std::min(wait, kTimeout * 1000 - std::min(now - lastRead, kTimeout * 1000));
+
+		struct timeval timeout;
+		timeout.tv_sec = wait / 1000000;
+		timeout.tv_usec = wait % 1000000;
+		fd_set fdSet;
+		FD_ZERO(&fdSet);
+		FD_SET(m_socket, &fdSet);
+		FD_SET(m_wakeupSocket, &fdSet);
+		if (select(FD_SETSIZE, &fdSet, NULL, NULL, &timeout) == ERROR)
+		{
+			if (m_connected)
+				wpi_setErrnoErrorWithContext("NetworkTables select");
+			Close();
+			return;
+		}
 
-		if (value >= kNetworkTables_ID || value == kNetworkTables_OLD_DATA)
+		if (FD_ISSET(m_socket, &fdSet))
 		{
-			bool oldData = value == kNetworkTables_OLD_DATA;
-			UINT32 id = input.ReadId(!oldData);
-			if (!m_connected)
-				break;
-			Key *key = Key::GetKey(m_fieldMap[id]);
+			// Decode everything that arrived before answering it
+			do
+			{
+				ReadMessage(input);
+				if (!m_connected)
+					return;
+			} while (input.HasBufferedData());
+			watchdogActive = true;
+			lastRead = GetFPGATime();
+		}
+
+		if (FD_ISSET(m_wakeupSocket, &fdSet))
+		{
+			char wakeup;
+			Synchronized sync(m_dataLock);
+			recv(m_wakeupSocket, &wakeup, sizeof(wakeup), 0);
+			m_wakeupPending = false;
+		}
+
+		now = GetFPGATime();
+		if (WriteQueued(buffer.get()))
+		{
+			lastWrite = now;
+		}
+		else if (now - lastWrite >= kWriteDelay * 1000)
+		{
+			buffer->WriteByte(kNetworkTables_PING);
+			buffer->Flush(m_socket);
+			lastWrite = now;
+		}
+
+		if (watchdogActive && now - lastRead >= kTimeout * 1000)
+		{
+			wpi_setWPIErrorWithContext(Timeout, "NetworkTables watchdog expired... disconnecting");
+			Close();
+			return;
+		}
+
+		m_writeCalls = buffer->GetWriteCalls();
+		m_recvCalls = input.GetRecvCalls();
+	}
+}
+
+/**
+ * Read and handle one message, waiting for the rest of it if necessary.
+ * @param input the reader for this connection's socket
+ */
+void Connection::ReadMessage(Reader &input)
+{
+	int value = input.Read();
+	if (!m_connected)
+		return;
+
+	if (value >= kNetworkTables_ID || value == kNetworkTables_OLD_DATA)
+	{
+		bool oldData = value == kNetworkTables_OLD_DATA;
+		UINT32 id = input.ReadId(!oldData);
+		if (!m_connected)
+			return;
+		Key *key = Key::GetKey(id < m_fieldMap.size() ? m_fieldMap[id] : 0);
+		if (key == NULL)
+		{
+			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Unexpected ID");
+			Close();
+			return;
+		}
 #ifdef DEBUG
-			char pbuf[64];
-			snprintf(pbuf, 64, "Update field \"%s\" value remote=%d local=%d\n", key->GetName().c_str(), id, m_fieldMap[id]);
-			printf(pbuf);
+		char pbuf[64];
+		snprintf(pbuf, 64, "Update field \"%s\" value remote=%d local=%d\n", key->GetName().c_str(), id, key->GetId());
+		printf(pbuf);
 #endif
 
-			if (key == NULL)
-			{
-				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Unexpected ID");
-				Close();
-				return;
-			}
+		value = input.Read();
+		if (!m_connected)
+			return;
 
-			value = input.Read();
+		if (ConnectionManager::GetInstance()->IsServer() && ConfirmationsContainsKey(key))
+		{
+			if (m_inTransaction)
+				m_denyTransaction = true;
+			else
+				Offer(std::auto_ptr<Data>(new Denial(1)));
+			if (value >= kNetworkTables_TABLE_ID)
+				input.ReadTableId(true);
+			else
+				input.ReadEntry(true);
+		}
+		else if (value >= kNetworkTables_TABLE_ID)
+		{
+			UINT32 tableId = input.ReadTableId(true);
 			if (!m_connected)
-				break;
-
-			if (ConnectionManager::GetInstance()->IsServer() && ConfirmationsContainsKey(key))
-			{
-				if (m_inTransaction)
-					m_denyTransaction = true;
-				else
-					Offer(std::auto_ptr<Data>(new Denial(1)));
-				if (value >= kNetworkTables_TABLE_ID)
-					input.ReadTableId(true);
-				else
-					input.ReadEntry(true);
-			}
-			else if (value >= kNetworkTables_TABLE_ID)
+				return;
+			if (oldData && key->HasEntry())
 			{
-				UINT32 tableId = input.ReadTableId(true);
-				if (!m_connected)
-					break;
-				if (oldData && key->HasEntry())
-				{
-					Offer(std::auto_ptr<Data>(new Denial(1)));
-				}
-				else
-				{
-					NetworkTable *table = GetTable(false, tableId);
-					Entry *tableEntry = new TableEntry(table);
-					tableEntry->SetSource(this);
-					tableEntry->SetKey(key);
-					if (m_inTransaction)
-					{
-						m_transaction->Offer(std::auto_ptr<Data>(tableEntry));
-					}
-					else
-					{
-						key->GetTable()->Got(false, key, std::auto_ptr<Entry>(tableEntry));
-						Offer(std::auto_ptr<Data>(new Confirmation(1)));
-					}
-				}
+				Offer(std::auto_ptr<Data>(new Denial(1)));
 			}
 			else
 			{
-				std::auto_ptr<Entry> entry = input.ReadEntry(true);
-				if (!m_connected)
-					break;
-
-				if (entry.get() == NULL)
-				{
-					wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Unable to parse entry");
-					Close();
-					return;
-				}
-				else if (oldData && key->HasEntry())
+				NetworkTable *table = GetTable(false, tableId);
+				Entry *tableEntry = new TableEntry(table);
+				tableEntry->SetSource(this);
+				tableEntry->SetKey(key);
+				if (m_inTransaction)
 				{
-					Offer(std::auto_ptr<Data>(new Denial(1)));
+					m_transaction->Offer(std::auto_ptr<Data>(tableEntry));
 				}
 				else
 				{
-					entry->SetSource(this);
-					entry->SetKey(key);
-					if (m_inTransaction)
-					{
-						m_transaction->Offer(std::auto_ptr<Data>(entry.release()));
-					}
-					else
-					{
-						key->GetTable()->Got(false, key, entry);
-						Offer(std::auto_ptr<Data>(new Confirmation(1)));
-					}
+					key->GetTable()->Got(false, key, std::auto_ptr<Entry>(tableEntry));
+					Offer(std::auto_ptr<Data>(new Confirmation(1)));
 				}
 			}
 		}
-		else if (value >= kNetworkTables_CONFIRMATION)
+		else
 		{
-			int count = input.ReadConfirmations(true);
+			std::auto_ptr<Entry> entry = input.ReadEntry(true);
 			if (!m_connected)
-				break;
-			while (count-- > 0)
+				return;
+
+			if (entry.get() == NULL)
 			{
-				if (m_confirmations.empty())
-				{
-					wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Too many confirmations");
-					Close();
-					return;
-				}
-				Entry *entry = m_confirmations.front();
-				m_confirmations.pop_front();
-				// TransactionStart
-				if (entry == NULL)
+				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Unable to parse entry");
+				Close();
+				return;
+			}
+			else if (oldData && key->HasEntry())
+			{
+				Offer(std::auto_ptr<Data>(new Denial(1)));
+			}
+			else
+			{
+				entry->SetSource(this);
+				entry->SetKey(key);
+				if (m_inTransaction)
 				{
-					if (ConnectionManager::GetInstance()->IsServer())
-					{
-						while (!m_confirmations.empty() && m_confirmations.front() != NULL)
-							m_confirmations.pop_front();
-					}
-					else
-					{
-						while (!m_confirmations.empty() && m_confirmations.front() != NULL)
-						{
-							m_transaction->Offer(m_confirmations.front());
-							m_confirmations.pop_front();
-						}
-
-						if (!m_transaction->IsEmpty())
-							((Entry *)m_transaction->Peek())->GetKey()->GetTable()->ProcessTransaction(true, m_transaction);
-					}
+					m_transaction->Offer(std::auto_ptr<Data>(entry.release()));
 				}
-				else if (!ConnectionManager::GetInstance()->IsServer())
+				else
 				{
-					entry->GetKey()->GetTable()->Got(true, entry->GetKey(), std::auto_ptr<Entry>(entry));
+					key->GetTable()->Got(false, key, entry);
+					Offer(std::auto_ptr<Data>(new Confirmation(1)));
 				}
 			}
 		}
-		else if (value >= kNetworkTables_DENIAL)
+	}
+	else if (value >= kNetworkTables_CONFIRMATION)
+	{
+		int count = input.ReadConfirmations(true);
+		if (!m_connected)
+			return;
+		while (count-- > 0)
 		{
-			if (ConnectionManager::GetInstance()->IsServer())
+			if (m_confirmations.empty())
 			{
-				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Server can not be denied");
+				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Too many confirmations");
 				Close();
 				return;
 			}
-			int count = input.ReadDenials(m_connected);
-			if (!m_connected)
-				break;
-			while (count-- > 0)
+			Key *key = m_confirmations.front();
+			m_confirmations.pop_front();
+			// TransactionStart
+			if (key == NULL)
 			{
-				if (m_confirmations.empty())
-				{
-					wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Excess denial");
-					Close();
-					return;
-				}
-				else if (m_confirmations.front() == NULL)
+				while (!m_confirmations.empty() && m_confirmations.front() != NULL)
 				{
-					m_confirmations.pop_front();
-					// Skip the transaction
-					while (!m_confirmations.empty() && m_confirmations.front() != NULL)
-					{
-						delete m_confirmations.front();
-						m_confirmations.pop_front();
-					}
-				}
-				else
-				{
-					delete m_confirmations.front();
+					if (!ConnectionManager::GetInstance()->IsServer())
+						m_confirmations.front()->GetTable()->Confirmed(m_confirmations.front());
 					m_confirmations.pop_front();
 				}
 			}
+			else if (!ConnectionManager::GetInstance()->IsServer())
+			{
+				key->GetTable()->Confirmed(key);
+			}
 		}
-		else if (value == kNetworkTables_TABLE_REQUEST)
+	}
+	else if (value >= kNetworkTables_DENIAL)
+	{
+		if (ConnectionManager::GetInstance()->IsServer())
 		{
-			if (!ConnectionManager::GetInstance()->IsServer())
+			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Server can not be denied");
+			Close();
+			return;
+		}
+		int count = input.ReadDenials(m_connected);
+		if (!m_connected)
+			return;
+		while (count-- > 0)
+		{
+			if (m_confirmations.empty())
 			{
-				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Server requesting table");
+				wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Excess denial");
 				Close();
 				return;
 			}
-			std::string name = input.ReadString();
-			if (!m_connected)
-				break;
-			UINT32 id = input.ReadTableId(false);
-			if (!m_connected)
-				break;
-#ifdef DEBUG
-			char pbuf[128];
-			snprintf(pbuf, 128, "Request table: %s (%d)\n", name.c_str(), id);
-			printf(pbuf);
-#endif
-
-			NetworkTable *table = NetworkTable::GetTable(name.c_str());
-
+			else if (m_confirmations.front() == NULL)
 			{
-				Synchronized sync(m_dataLock);
-				Offer(std::auto_ptr<Data>(new TableAssignment(table, id)));
-				table->AddConnection(this);
+				m_confirmations.pop_front();
+				// Skip the transaction
+				while (!m_confirmations.empty() && m_confirmations.front() != NULL)
+					m_confirmations.pop_front();
+			}
+			else
+			{
+				m_confirmations.pop_front();
 			}
-
-			m_tableMap.insert(IDMap_t::value_type(id, table->GetId()));
 		}
-		else if (value == kNetworkTables_TABLE_ASSIGNMENT)
+	}
+	else if (value == kNetworkTables_TABLE_REQUEST)
+	{
+		if (!ConnectionManager::GetInstance()->IsServer())
 		{
-			UINT32 localTableId = input.ReadTableId(false);
-			if (!m_connected)
-				break;
-			UINT32 remoteTableId = input.ReadTableId(false);
-			if (!m_connected)
-				break;
+			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Server requesting table");
+			Close();
+			return;
+		}
+		std::string name = input.ReadString();
+		if (!m_connected)
+			return;
+		UINT32 id = input.ReadTableId(false);
+		if (!m_connected)
+			return;
 #ifdef DEBUG
-			char pbuf[64];
-			snprintf(pbuf, 64, "Table Assignment: local=%d remote=%d\n", localTableId, remoteTableId);
-			printf(pbuf);
+		char pbuf[128];
+		snprintf(pbuf, 128, "Request table: %s (%d)\n", name.c_str(), id);
+		printf(pbuf);
 #endif
-			m_tableMap.insert(IDMap_t::value_type(remoteTableId, localTableId));
-		}
-		else if (value == kNetworkTables_ASSIGNMENT)
+
+		NetworkTable *table = NetworkTable::GetTable(name.c_str());
+
 		{
-			UINT32 tableId = input.ReadTableId(false);
-			if (!m_connected)
-				break;
-			NetworkTable *table = GetTable(false, tableId);
-			std::string keyName = input.ReadString();
-			if (!m_connected)
-				break;
-			Key *key = table->GetKey(keyName.c_str());
-			UINT32 id = input.ReadId(false);
-			if (!m_connected)
-				break;
+			Synchronized sync(m_dataLock);
+			Offer(std::auto_ptr<Data>(new TableAssignment(table, id)));
+			table->AddConnection(this);
+		}
+
+		m_tableMap.insert(IDMap_t::value_type(id, table->GetId()));
+	}
+	else if (value == kNetworkTables_TABLE_ASSIGNMENT)
+	{
+		UINT32 localTableId = input.ReadTableId(false);
+		if (!m_connected)
+			return;
+		UINT32 remoteTableId = input.ReadTableId(false);
+		if (!m_connected)
+			return;
 #ifdef DEBUG
-			char pbuf[64];
-			snprintf(pbuf, 64, "Field Assignment: table %d \"%s\" local=%d remote=%d\n", tableId, keyName.c_str(), key->GetId(), id);
-			printf(pbuf);
+		char pbuf[64];
+		snprintf(pbuf, 64, "Table Assignment: local=%d remote=%d\n", localTableId, remoteTableId);
+		printf(pbuf);
 #endif
-			m_fieldMap.insert(IDMap_t::value_type(id, key->GetId()));
-		}
-		else if (value == kNetworkTables_TRANSACTION)
+		m_tableMap.insert(IDMap_t::value_type(remoteTableId, localTableId));
+	}
+	else if (value == kNetworkTables_ASSIGNMENT)
+	{
+		UINT32 tableId = input.ReadTableId(false);
+		if (!m_connected)
+			return;
+		NetworkTable *table = GetTable(false, tableId);
+		std::string keyName = input.ReadString();
+		if (!m_connected)
+			return;
+		Key *key = table->GetKey(keyName.c_str());
+		UINT32 id = input.ReadId(false);
+		if (!m_connected)
+			return;
+#ifdef DEBUG
+		char pbuf[64];
+		snprintf(pbuf, 64, "Field Assignment: table %d \"%s\" local=%d remote=%d\n", tableId, keyName.c_str(), key->GetId(), id);
+		printf(pbuf);
+#endif
+		if (id > kMaxFieldId)
 		{
+			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Field ID out of range");
+			Close();
+			return;
+		}
+		if (id >= m_fieldMap.size())
+			m_fieldMap.resize(id + 1, 0);
+		m_fieldMap[id] = key->GetId();
+	}
+	else if (value == kNetworkTables_TRANSACTION)
+	{
 #ifdef DEBUG
-			printf("Transaction Start\n");
+		printf("Transaction Start\n");
 #endif
-			m_inTransaction = !m_inTransaction;
-			// Finishing a transaction
-			if (!m_inTransaction)
+		m_inTransaction = !m_inTransaction;
+		// Finishing a transaction
+		if (!m_inTransaction)
+		{
+			if (m_denyTransaction)
 			{
-				if (m_denyTransaction)
-				{
-					Offer(std::auto_ptr<Data>(new Denial(1)));
-				}
-				else
-				{
-					if (!m_transaction->IsEmpty())
-						((Entry *)m_transaction->Peek())->GetKey()->GetTable()->ProcessTransaction(false, m_transaction);
-					Offer(std::auto_ptr<Data>(new Confirmation(1)));
-				}
-				m_denyTransaction = false;
+				Offer(std::auto_ptr<Data>(new Denial(1)));
 			}
+			else
+			{
+				if (!m_transaction->IsEmpty())
+					((Entry *)m_transaction->Peek())->GetKey()->GetTable()->ProcessTransaction(false, m_transaction);
+				Offer(std::auto_ptr<Data>(new Confirmation(1)));
+			}
+			m_denyTransaction = false;
+		}
 #ifdef DEBUG
-			printf("Transaction End\n");
+		printf("Transaction End\n");
 #endif
-		}
-		else
-		{
+	}
+	else
+	{
 #ifdef DEBUG
-			char buf[64];
-			snprintf(buf, 64, "Don't know how to interpret marker byte (%02X)", value);
-			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, buf);
+		char buf[64];
+		snprintf(buf, 64, "Don't know how to interpret marker byte (%02X)", value);
+		wpi_setWPIErrorWithContext(NetworkTablesCorrupt, buf);
 #else
-			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Don't know how to interpret marker byte");
+		wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "Don't know how to interpret marker byte");
 #endif
-			Close();
-			return;
-		}
-		value = input.Read();
+		Close();
+		return;
 	}
 }
 
-void Connection::WriteTaskRun()
+/**
+ * Send everything that is queued, batching it into as few writes as possible.
+ * @param buffer the buffer to encode into
+ * @return true if anything was sent
+ */
+bool Connection::WriteQueued(Buffer *buffer)
 {
-	std::auto_ptr<Buffer> buffer = std::auto_ptr<Buffer>(new Buffer(2048));
-	bool sentData = true;
-	while (m_connected)
+	std::pair<Data *, bool> data;
 	{
-		std::pair<Data *, bool> data;
-		{
-			Synchronized sync(m_dataLock);
-			data = m_queue->Poll();
-			// Check if there is no data to send
-			if (data.first == NULL)
-			{
-				// Ping if necessary
-				if (sentData)
-				{
-					sentData = false;
-				}
-				else
-				{
-					buffer->WriteByte(kNetworkTables_PING);
-					buffer->Flush(m_socket);
-				}
-				semGive(m_dataLock);
-				semTake(m_dataAvailable, kWriteDelay);
-				semTake(m_dataLock, WAIT_FOREVER);
-				continue;
-			}
-		}
-
-		// If there is data, send it
-		sentData = true;
+		Synchronized sync(m_dataLock);
+		data = m_queue->Poll();
+	}
+	if (data.first == NULL)
+		return false;
 
+	while (data.first != NULL)
+	{
+		// Keep the keys rather than the entries, which a later Put may free
+		// before the peer confirms them
 		if (data.first->IsEntry())
-			m_confirmations.push_back((Entry *)data.first);
+			m_confirmations.push_back(((Entry *)data.first)->GetKey());
 		else if (data.first->IsOldData())
-			m_confirmations.push_back(((OldData *)data.first)->GetEntry());
+			m_confirmations.push_back(((OldData *)data.first)->GetEntry()->GetKey());
 		else if (data.first->IsTransaction())
-			m_confirmations.push_back((Entry *)NULL);
+			m_confirmations.push_back((Key *)NULL);
 
-		data.first->Encode(buffer.get());
-		buffer->Flush(m_socket);
+		if (data.first->IsSnapshot())
+		{
+			// Send the batch so far, then the whole snapshot in one pass
+			Snapshot *snapshot = (Snapshot *)data.first;
+			m_confirmations.insert(m_confirmations.end(),
+				snapshot->GetKeys().begin(), snapshot->GetKeys().end());
+			if (!buffer->Flush(m_socket) && m_connected)
+				wpi_setErrnoErrorWithContext("NetworkTables write");
+			if (!snapshot->Flush(m_socket) && m_connected)
+				wpi_setErrnoErrorWithContext("NetworkTables write");
+		}
+		else
+		{
+			UINT32 mark = buffer->GetSize();
+			data.first->Encode(buffer);
+			if (buffer->IsOverflowed() && mark > 0)
+			{
+				// Send the batch so far and start the next one with this data
+				buffer->Rewind(mark);
+				if (!buffer->Flush(m_socket) && m_connected)
+					wpi_setErrnoErrorWithContext("NetworkTables write");
+				data.first->Encode(buffer);
+			}
+			if (buffer->IsOverflowed())
+			{
+				// Too big to ever fit; the truncated data goes out as before
+				wpi_setWPIError(NetworkTablesBufferFull);
+				buffer->Rewind(buffer->GetSize());
+			}
+		}
 		// Noone else wants this data and it used to be auto_ptr'd, so delete it
 		if (data.second)
 			delete data.first;
+
+		Synchronized sync(m_dataLock);
+		data = m_queue->Poll();
 	}
+	if (!buffer->Flush(m_socket) && m_connected)
+		wpi_setErrnoErrorWithContext("NetworkTables write");
+	return true;
 }
 
 void Connection::Close()
@@ -480,7 +610,6 @@ void Connection::Close()
 	{
 		m_connected = false;
 		close(m_socket);
-		WatchdogFeed();
 		IDMap_t::iterator it = m_tableMap.begin();
 		IDMap_t::iterator end = m_tableMap.end();
 		for (; it != end; it++)
@@ -536,56 +665,13 @@ NetworkTable *Connection::GetTable(bool local, UINT32 id)
 
 bool Connection::ConfirmationsContainsKey(Key *key)
 {
-	std::deque<Entry *>::iterator it = m_confirmations.begin();
-	std::deque<Entry *>::iterator end = m_confirmations.end();
+	std::deque<Key *>::iterator it = m_confirmations.begin();
+	std::deque<Key *>::iterator end = m_confirmations.end();
 	for (; it != end; it++)
-		if ((*it)->GetKey() == key)
+		if (*it == key)
 			return true;
 
 	return false;
 }
 
-void Connection::WatchdogTaskRun()
-{
-	Synchronized sync(m_watchdogLock);
-	while (m_connected)
-	{
-		while(!m_watchdogActive)
-		{
-			semGive(m_watchdogLock);
-			semTake(m_watchdogFood, WAIT_FOREVER);
-			semTake(m_watchdogLock, WAIT_FOREVER);
-		}
-		m_watchdogFed = false;
-		semGive(m_watchdogLock);
-		int retval = semTake(m_watchdogFood, kTimeout);
-		semTake(m_watchdogLock, WAIT_FOREVER);
-		if (retval == ERROR && !m_watchdogFed)
-		{
-			wpi_setWPIErrorWithContext(Timeout, "NetworkTables watchdog expired... disconnecting");
-			break;
-		}
-	}
-
-	Close();
-}
-
-void Connection::WatchdogActivate()
-{
-	Synchronized sync(m_watchdogLock);
-	if (!m_watchdogActive)
-	{
-		m_watchdogActive = true;
-		semGive(m_watchdogFood);
-	}
-}
-
-void Connection::WatchdogFeed()
-{
-	Synchronized sync(m_watchdogLock);
-	m_watchdogActive = false;
-	m_watchdogFed = true;
-	semGive(m_watchdogFood);
-}
-
 } // namespace
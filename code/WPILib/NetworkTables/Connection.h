@@ -11,15 +11,18 @@
 #include "Task.h"
 #include <map>
 #include <deque>
+#include <vector>
 
 class NetworkTable;
 
 namespace NetworkTables
 {
+class Buffer;
 class Data;
 class Entry;
 class Key;
 class NetworkQueue;
+class Reader;
 class TransactionEnd;
 class TransactionStart;
 
@@ -29,8 +32,12 @@ class Connection : public ErrorBase
 	friend class NetworkTable;
 	friend class Reader;
 public:
+	/** Milliseconds without sending anything before a ping is sent */
 	static const UINT32 kWriteDelay = 250;
+	static const UINT32 kWriteBufferSize = 2048;
+	/** Milliseconds without receiving anything before the connection is dropped */
 	static const UINT32 kTimeout = 1000;
+	static const UINT32 kMaxFieldId = 0xFFFF;
 
 private:
 	Connection(int socket);
@@ -39,39 +46,38 @@ private:
 	void Offer(Data *data);
 	void Offer(std::auto_ptr<Data> autoData);
 	void Start();
-	void ReadTaskRun();
-	void WriteTaskRun();
+	void IoTaskRun();
+	void ReadMessage(Reader &input);
+	bool WriteQueued(Buffer *buffer);
+	void Wakeup();
 	void Close();
 	bool IsConnected() {return m_connected;}
 	NetworkTable *GetTable(bool local, UINT32 id);
 	bool ConfirmationsContainsKey(Key *key);
-	void WatchdogActivate();
-	void WatchdogFeed();
-	void WatchdogTaskRun();
 
-	static int InitReadTask(Connection *obj) {obj->ReadTaskRun();return 0;}
-	static int InitWriteTask(Connection *obj) {obj->WriteTaskRun();return 0;}
-	static int InitWatchdogTask(Connection *obj) {obj->WatchdogTaskRun();return 0;}
+	static int InitIoTask(Connection *obj) {obj->IoTaskRun();return 0;}
 
 	int m_socket;
+	/** Loopback datagram socket used to wake the I/O task when data is queued */
+	int m_wakeupSocket;
 	SEM_ID m_dataLock;
-	SEM_ID m_dataAvailable;
-	SEM_ID m_watchdogLock;
-	SEM_ID m_watchdogFood;
 	typedef std::map<UINT32, UINT32> IDMap_t;
 	IDMap_t m_tableMap;
-	IDMap_t m_fieldMap;
+	/** Local key ids indexed by the remote id (0 if unassigned) */
+	std::vector<UINT32> m_fieldMap;
 	NetworkQueue *m_queue;
-	std::deque<Entry *> m_confirmations;
+	/** The keys of the values sent and not yet confirmed (NULL starts a transaction) */
+	std::deque<Key *> m_confirmations;
 	NetworkQueue *m_transaction;
 	bool m_connected;
 	bool m_inTransaction;
 	bool m_denyTransaction;
-	bool m_watchdogActive;
-	bool m_watchdogFed;
-	Task m_readTask;
-	Task m_writeTask;
-	Task m_watchdogTask;
+	/** A wakeup has been sent and not yet received (protected by m_dataLock) */
+	bool m_wakeupPending;
+	/** Socket calls made by the I/O task, for benchmarking (written only by that task) */
+	UINT32 m_writeCalls;
+	UINT32 m_recvCalls;
+	Task m_ioTask;
 	TransactionStart *m_transactionStart;
 	TransactionEnd *m_transactionEnd;
 };
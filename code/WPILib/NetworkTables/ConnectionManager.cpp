@@ -135,6 +135,27 @@ void ConnectionManager::AddConnection(Connection *connection)
 	connection->Start();
 }
 
+/**
+ * Add up the write() and recv() calls made by the I/O tasks of the open
+ * connections, for benchmarking.  The snapshot sent when a connection comes up
+ * is not counted.
+ * @param writeCalls set to the number of write() calls
+ * @param recvCalls set to the number of recv() calls
+ */
+void ConnectionManager::GetSocketCalls(UINT32 *writeCalls, UINT32 *recvCalls)
+{
+	Synchronized sync(m_connectionLock);
+	*writeCalls = 0;
+	*recvCalls = 0;
+	ConnectionSet::iterator it = m_connections.begin();
+	ConnectionSet::iterator end = m_connections.end();
+	for (; it != end; it++)
+	{
+		*writeCalls += (*it)->m_writeCalls;
+		*recvCalls += (*it)->m_recvCalls;
+	}
+}
+
 void ConnectionManager::RemoveConnection(Connection *connection)
 {
 	{
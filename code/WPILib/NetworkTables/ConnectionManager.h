@@ -21,6 +21,7 @@ class ConnectionManager : public SensorBase
 	friend class Connection;
 public:
 	static ConnectionManager *GetInstance();
+	void GetSocketCalls(UINT32 *writeCalls, UINT32 *recvCalls);
 
 private:
 	ConnectionManager();
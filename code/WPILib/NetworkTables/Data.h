@@ -14,10 +14,12 @@ class Buffer;
 
 class Data {
 public:
+	virtual ~Data() {}
 	virtual void Encode(Buffer *buffer) = 0;
 	virtual bool IsEntry() {return false;}
 	virtual bool IsOldData() {return false;}
 	virtual bool IsTransaction() {return false;}
+	virtual bool IsSnapshot() {return false;}
 };
 
 } // namespace
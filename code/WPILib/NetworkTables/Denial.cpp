@@ -6,16 +6,29 @@
 
 #include "NetworkTables/Denial.h"
 #include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
 #include "NetworkTables/InterfaceConstants.h"
 
 namespace NetworkTables
 {
 
+FreeList Denial::_freeList("Denial", sizeof(Denial));
+
 Denial::Denial(int count) :
 	m_count(count)
 {
 }
 
+void *Denial::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void Denial::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
 void Denial::Encode(Buffer *buffer)
 {
 	for (int i = m_count; i > 0; i -= kNetworkTables_DENIAL - 1)
@@ -8,21 +8,27 @@
 #define __DENIAL_H__
 
 #include "NetworkTables/Data.h"
+#include <vxWorks.h>
 
 namespace NetworkTables
 {
 
 class Buffer;
+class FreeList;
 
 class Denial : public Data
 {
 public:
 	Denial(int count);
+	static void *operator new(size_t size);
+	static void operator delete(void *block, size_t size);
 	virtual void Encode(Buffer *buffer);
 private:
 	static Denial *Combine(Denial *a, Denial *b);
 
 	int m_count;
+
+	static FreeList _freeList;
 };
 
 } // namespace
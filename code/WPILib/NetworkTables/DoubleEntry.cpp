@@ -6,15 +6,28 @@
 
 #include "NetworkTables/DoubleEntry.h"
 #include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
 
 namespace NetworkTables
 {
 
+FreeList DoubleEntry::_freeList("DoubleEntry", sizeof(DoubleEntry));
+
 DoubleEntry::DoubleEntry(double value) :
 	m_value(value)
 {
 }
 
+void *DoubleEntry::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void DoubleEntry::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
 NetworkTables_Types DoubleEntry::GetType()
 {
 	return kNetworkTables_Types_DOUBLE;
@@ -32,4 +45,9 @@ double DoubleEntry::GetDouble()
 	return m_value;
 }
 
+bool DoubleEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((DoubleEntry *)other)->m_value == m_value;
+}
+
 } // namespace
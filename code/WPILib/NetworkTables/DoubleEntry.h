@@ -17,16 +17,22 @@ namespace NetworkTables
 {
 
 class Buffer;
+class FreeList;
 
 class DoubleEntry : public Entry {
 public:
 	DoubleEntry(double value);
+	static void *operator new(size_t size);
+	static void operator delete(void *block, size_t size);
 	virtual NetworkTables_Types GetType();
 	virtual void Encode(Buffer *buffer);
 	virtual double GetDouble();
+	virtual bool Equals(Entry *other);
 
 private:
 	double m_value;
+
+	static FreeList _freeList;
 };
 
 } // namespace
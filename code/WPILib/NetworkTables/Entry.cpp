@@ -57,4 +57,14 @@ NetworkTable *Entry::GetTable()
 	return NULL;
 }
 
+/**
+ * Compare the value of this entry to another.
+ * @param other the entry to compare against
+ * @return true if the other entry has the same type and value
+ */
+bool Entry::Equals(Entry *other)
+{
+	return false;
+}
+
 } // namespace
@@ -40,6 +40,7 @@ public:
 	virtual int GetString(char *str, int len);
 	virtual std::string GetString();
 	virtual NetworkTable *GetTable();
+	virtual bool Equals(Entry *other);
 
 private:
 
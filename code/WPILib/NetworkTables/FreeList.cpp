@@ -0,0 +1,108 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "NetworkTables/FreeList.h"
+
+#include "Synchronized.h"
+#include "Utility.h"
+#include <new>
+#include <stdio.h>
+
+namespace NetworkTables
+{
+
+FreeList *FreeList::_lists = NULL;
+
+FreeList::FreeList(const char *name, size_t size) :
+	m_lock(NULL),
+	m_name(name),
+	m_size(size),
+	m_head(NULL),
+	m_allocations(0),
+	m_heapAllocations(0),
+	m_lastAllocations(0),
+	m_lastHeapAllocations(0),
+	m_lastTime(0),
+	m_nextList(_lists)
+{
+	m_lock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
+	// Free lists are static objects, so they are all created before any task uses them
+	_lists = this;
+}
+
+/**
+ * Get a block for a new object, reusing a freed one if possible.
+ * @param size the size of the object being created
+ */
+void *FreeList::Allocate(size_t size)
+{
+	// Subclasses are bigger than the blocks on this list
+	if (size != m_size)
+		return ::operator new(size);
+
+	{
+		Synchronized sync(m_lock);
+		m_allocations++;
+		if (m_head != NULL)
+		{
+			Block *block = m_head;
+			m_head = block->next;
+			return block;
+		}
+		m_heapAllocations++;
+	}
+	return ::operator new(size);
+}
+
+/**
+ * Put the block of a deleted object on the list for reuse.
+ * @param block the memory of the deleted object
+ * @param size the size of the deleted object
+ */
+void FreeList::Free(void *block, size_t size)
+{
+	if (block == NULL)
+		return;
+	if (size != m_size)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	Synchronized sync(m_lock);
+	((Block *)block)->next = m_head;
+	m_head = (Block *)block;
+}
+
+/**
+ * Print the allocation counts of every free list.
+ * The rates cover the time since the previous call.
+ */
+void FreeList::PrintStats()
+{
+	UINT32 now = GetFPGATime();
+	for (FreeList *list = _lists; list != NULL; list = list->m_nextList)
+	{
+		UINT32 allocations, heapAllocations, lastTime;
+		{
+			Synchronized sync(list->m_lock);
+			allocations = list->m_allocations - list->m_lastAllocations;
+			heapAllocations = list->m_heapAllocations - list->m_lastHeapAllocations;
+			lastTime = list->m_lastTime;
+			list->m_lastAllocations = list->m_allocations;
+			list->m_lastHeapAllocations = list->m_heapAllocations;
+			list->m_lastTime = now;
+		}
+		double seconds = (now - lastTime) * 1e-6;
+		printf("%-14s allocs=%lu heap=%lu allocs/s=%.1f heap/s=%.1f\n",
+			list->m_name, (unsigned long)list->m_allocations,
+			(unsigned long)list->m_heapAllocations,
+			seconds > 0.0 ? allocations / seconds : 0.0,
+			seconds > 0.0 ? heapAllocations / seconds : 0.0);
+	}
+}
+
+} // namespace
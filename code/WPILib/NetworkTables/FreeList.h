@@ -0,0 +1,56 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __FREE_LIST_H__
+#define __FREE_LIST_H__
+
+#include <semLib.h>
+#include <vxWorks.h>
+
+namespace NetworkTables
+{
+
+/**
+ * Recycles the fixed size objects that NetworkTables creates for every update.
+ * Freed objects are kept on a list and handed out again, so the heap is only
+ * used until the list has grown to the number of objects in flight.
+ * Classes use it by forwarding their operator new and operator delete to a
+ * static FreeList.
+ */
+class FreeList
+{
+public:
+	FreeList(const char *name, size_t size);
+	void *Allocate(size_t size);
+	void Free(void *block, size_t size);
+	UINT32 GetAllocations() {return m_allocations;}
+	UINT32 GetHeapAllocations() {return m_heapAllocations;}
+
+	static void PrintStats();
+
+private:
+	struct Block
+	{
+		Block *next;
+	};
+
+	SEM_ID m_lock;
+	const char *m_name;
+	size_t m_size;
+	Block *m_head;
+	UINT32 m_allocations;
+	UINT32 m_heapAllocations;
+	UINT32 m_lastAllocations;
+	UINT32 m_lastHeapAllocations;
+	UINT32 m_lastTime;
+	FreeList *m_nextList;
+
+	static FreeList *_lists;
+};
+
+} // namespace
+
+#endif
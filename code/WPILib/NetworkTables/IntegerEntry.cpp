@@ -6,15 +6,28 @@
 
 #include "NetworkTables/IntegerEntry.h"
 #include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
 
 namespace NetworkTables
 {
 
+FreeList IntegerEntry::_freeList("IntegerEntry", sizeof(IntegerEntry));
+
 IntegerEntry::IntegerEntry(int value) :
 	m_value(value)
 {
 }
 
+void *IntegerEntry::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void IntegerEntry::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
 NetworkTables_Types IntegerEntry::GetType()
 {
 	return kNetworkTables_Types_INT;
@@ -32,4 +45,9 @@ int IntegerEntry::GetInt()
 	return m_value;
 }
 
+bool IntegerEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((IntegerEntry *)other)->m_value == m_value;
+}
+
 } // namespace
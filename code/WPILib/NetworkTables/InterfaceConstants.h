@@ -29,6 +29,8 @@
 #define kNetworkTables_CONFIRMATION_MAX	(kNetworkTables_CONFIRMATION - 1)
 #define kNetworkTables_PING				kNetworkTables_CONFIRMATION
 #define kNetworkTables_DENIAL			(1 << 4)
+// Records are a local type only; they are sent as strings
+#define kNetworkTables_RECORD			(1 << 8)
 
 typedef enum
 {
@@ -38,6 +40,7 @@ typedef enum
 	kNetworkTables_Types_DOUBLE = kNetworkTables_DOUBLE,
 	kNetworkTables_Types_BOOLEAN = kNetworkTables_BOOLEAN_TRUE,
 	kNetworkTables_Types_TABLE = kNetworkTables_TABLE,
+	kNetworkTables_Types_RECORD = kNetworkTables_RECORD,
 } NetworkTables_Types;
 
 #endif // __INTERFACE_CONSTANTS_H__
@@ -9,27 +9,44 @@
 #include "NetworkTables/Buffer.h"
 #include "NetworkTables/Entry.h"
 #include "NetworkTables/NetworkTable.h"
+#include "Atomic.h"
 #include "Synchronized.h"
 
 namespace NetworkTables
 {
 
+const UINT32 Key::kInitialIdsTableSize;
 SEM_ID Key::_staticLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);;
-std::map<UINT32, Key *> Key::_idsMap;
+Key **volatile Key::_idsTable = NULL;
+volatile UINT32 Key::_idsTableSize = 0;
 UINT32 Key::_currentId = 0;
 
 Key::Key(NetworkTable *table, const char *keyName) :
 	m_table(table),
 	m_name(keyName),
 	m_entry(NULL),
-	m_id(AllocateId())
+	m_id(AllocateId()),
+	m_minPublishInterval(0),
+	m_lastPublishTime(0),
+	m_publishPending(false),
+	m_sentEntry(NULL),
+	m_writeSeq(0),
+	m_publishSeq(0)
 {
-	_idsMap.insert(std::pair<UINT32, Key *>(m_id, this));
+	m_slots[0].type = kNetworkTables_Types_NONE;
+	m_slots[1].type = kNetworkTables_Types_NONE;
+	Synchronized sync(_staticLock);
+	if (m_id >= _idsTableSize)
+		GrowIdsTable(m_id + 1);
+	// Finish constructing the key before GetKey can find it
+	MemoryBarrier();
+	_idsTable[m_id] = this;
 }
 
 Key::~Key()
 {
-	_idsMap.erase(m_id);
+	Synchronized sync(_staticLock);
+	_idsTable[m_id] = NULL;
 }
 
 NetworkTables_Types Key::GetType()
@@ -52,12 +69,99 @@ std::auto_ptr<Entry> Key::SetEntry(std::auto_ptr<Entry> entry)
 	Entry *old = m_entry.release();
 	m_entry = entry;
 	m_entry->SetKey(this);
+	PublishValue();
 	return std::auto_ptr<Entry>(old);
 }
 
+/**
+ * Copy the current value into the slot readers are not using and publish it.
+ * Writers are serialized by the table's data lock.  Readers never wait on a
+ * writer, even one they have preempted, since they read the other slot.
+ */
+void Key::PublishValue()
+{
+	UINT32 seq = m_publishSeq + 1;
+	m_writeSeq = seq;
+	MemoryBarrier();
+
+	Slot *slot = &m_slots[seq & 1];
+	slot->type = m_entry->GetType();
+	switch (slot->type)
+	{
+	case kNetworkTables_Types_INT:
+		slot->value.i = m_entry->GetInt();
+		break;
+	case kNetworkTables_Types_DOUBLE:
+		slot->value.d = m_entry->GetDouble();
+		break;
+	case kNetworkTables_Types_BOOLEAN:
+		slot->value.b = m_entry->GetBoolean();
+		break;
+	default:
+		break;
+	}
+
+	MemoryBarrier();
+	m_publishSeq = seq;
+}
+
+/**
+ * Read the latest scalar value of this key without taking any lock.
+ * @param value filled in with the value if it is an int, double or boolean
+ * @return the type of the value (kNetworkTables_Types_NONE if there is no value yet)
+ */
+NetworkTables_Types Key::ReadValue(Value *value)
+{
+	Slot slot;
+	UINT32 seq;
+	do
+	{
+		seq = m_publishSeq;
+		MemoryBarrier();
+		slot = m_slots[seq & 1];
+		MemoryBarrier();
+		// Retry only if the writer has come back around to the slot just read
+	} while (m_writeSeq - seq >= 2);
+	*value = slot.value;
+	return slot.type;
+}
+
+/**
+ * Look up a key by id without locking, since this is called for every value received.
+ * The size is read before the table; a table is published before its size, so
+ * the table read is always at least that big.
+ */
 Key *Key::GetKey(UINT32 id)
 {
-	return _idsMap[id];
+	UINT32 size = _idsTableSize;
+	MemoryBarrier();
+	Key **table = _idsTable;
+	if (id >= size)
+		return NULL;
+	return table[id];
+}
+
+/**
+ * Replace the ids table with a larger copy.  Must be called with _staticLock held.
+ * The old table is never freed, since GetKey may still be reading it; doubling the
+ * size keeps all the old ones together smaller than the current one.
+ * @param minSize the number of ids the table must have room for
+ */
+void Key::GrowIdsTable(UINT32 minSize)
+{
+	UINT32 size = _idsTableSize;
+	UINT32 newSize = size != 0 ? size : kInitialIdsTableSize;
+	while (newSize < minSize)
+		newSize *= 2;
+	Key **table = new Key *[newSize];
+	for (UINT32 i = 0; i < size; i++)
+		table[i] = _idsTable[i];
+	for (UINT32 i = size; i < newSize; i++)
+		table[i] = NULL;
+	MemoryBarrier();
+	_idsTable = table;
+	MemoryBarrier();
+	_idsTableSize = newSize;
 }
 
 void Key::EncodeName(Buffer *buffer)
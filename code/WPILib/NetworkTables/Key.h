@@ -10,8 +10,9 @@
 #include "NetworkTables/Data.h"
 #include "NetworkTables/InterfaceConstants.h"
 
-#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 class NetworkTable;
 
@@ -36,23 +37,55 @@ public:
 	UINT32 GetId() {return m_id;}
 	void Encode(Buffer *buffer);
 
+	/** A copy of a scalar value that can be read without locking the table */
+	union Value
+	{
+		int i;
+		double d;
+		bool b;
+	};
+	NetworkTables_Types ReadValue(Value *value);
+
 	static Key *GetKey(UINT32 id);
 
 private:
 	std::auto_ptr<Entry> SetEntry(std::auto_ptr<Entry> entry);
 	bool HasEntry() {return m_entry.get() != NULL;}
 	void EncodeName(Buffer *buffer);
+	void PublishValue();
 
 	static UINT32 AllocateId();
+	static void GrowIdsTable(UINT32 minSize);
+
+	static const UINT32 kInitialIdsTableSize = 64;
 
 	NetworkTable *m_table;
 	std::string m_name;
 	// Keys are responsible for entrys' memory
 	std::auto_ptr<Entry> m_entry;
 	UINT32 m_id;
+	// Publish rate limiting, maintained by NetworkTable::Put
+	UINT32 m_minPublishInterval;
+	UINT32 m_lastPublishTime;
+	bool m_publishPending;
+	// The last entry sent while a newer one waits to be; the connections may still have it queued
+	std::auto_ptr<Entry> m_sentEntry;
+	// Double buffered copy of the value for ReadValue
+	struct Slot
+	{
+		NetworkTables_Types type;
+		Value value;
+	};
+	Slot m_slots[2];
+	volatile UINT32 m_writeSeq;
+	volatile UINT32 m_publishSeq;
 
+	/** Serializes id allocation and changes to the ids table; GetKey does not take it */
 	static SEM_ID _staticLock;
-	static std::map<UINT32, Key *> _idsMap;
+	/** Keys indexed by id; ids are handed out densely starting at 1 */
+	static Key **volatile _idsTable;
+	/** The number of ids _idsTable has room for, published after the table */
+	static volatile UINT32 _idsTableSize;
 	static UINT32 _currentId;
 };
 
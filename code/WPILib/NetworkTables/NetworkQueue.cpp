@@ -54,21 +54,25 @@ void NetworkQueue::Offer(Data *value, bool needsDelete)
 		}
 		else
 		{
-			DataHash_t::iterator found = m_latestDataHash.find(((Entry *)value)->GetId());
-			if (found != m_latestDataHash.end())
+			UINT32 id = ((Entry *)value)->GetId();
+			if (id >= m_latestDataHash.size())
+				m_latestDataHash.resize(id + 1, NULL);
+			DataQueue_t::value_type *found = m_latestDataHash[id];
+			if (found != NULL)
 			{
 				// Replace the old value for this key with a new one
 				// If this used to be auto_ptr'd, then delete it
 				// (This should never happen, right?)
-				if (found->second->second)
-					delete found->second->first;
-				found->second->first = value;
+				if (found->second)
+					delete found->first;
+				found->first = value;
 			}
 			else
 			{
 				// Add a new entry to the queue
+				// Elements of a deque stay put when adding to the ends, so it is safe to keep a pointer
 				m_dataQueue.push_back(DataQueue_t::value_type(value, needsDelete));
-				m_latestDataHash.insert(DataHash_t::value_type(((Entry *)m_dataQueue.back().first)->GetId(), m_dataQueue.end() - 1));
+				m_latestDataHash[id] = &m_dataQueue.back();
 			}
 		}
 	}
@@ -94,9 +98,10 @@ bool NetworkQueue::IsEmpty()
 
 bool NetworkQueue::ContainsKey(Key *key)
 {
+	if (key == NULL)
+		return false;
 	Synchronized sync(m_dataLock);
-	DataHash_t::iterator found = m_latestDataHash.find(key->GetId());
-	return key != NULL && found != m_latestDataHash.end();
+	return key->GetId() < m_latestDataHash.size() && m_latestDataHash[key->GetId()] != NULL;
 }
 
 // @return the data and if it came from an auto_ptr
@@ -108,7 +113,9 @@ std::pair<Data *, bool> NetworkQueue::Poll()
 	DataQueue_t::value_type data = m_dataQueue.front();
 	if (data.first->IsEntry())
 	{
-		m_latestDataHash.erase(((Entry *)data.first)->GetId());
+		UINT32 id = ((Entry *)data.first)->GetId();
+		if (id < m_latestDataHash.size() && m_latestDataHash[id] == &m_dataQueue.front())
+			m_latestDataHash[id] = NULL;
 	}
 	m_dataQueue.pop_front();
 	return data;
@@ -118,7 +125,7 @@ void NetworkQueue::Clear()
 {
 	Synchronized sync(m_dataLock);
 	m_dataQueue.clear();
-	m_latestDataHash.clear();
+	m_latestDataHash.assign(m_latestDataHash.size(), NULL);
 }
 
 Data *NetworkQueue::Peek()
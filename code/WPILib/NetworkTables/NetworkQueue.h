@@ -8,8 +8,8 @@
 #define __NETWORK_QUEUE_H__
 
 #include "NetworkTables/NetworkTable.h"
-#include <map>
 #include <deque>
+#include <vector>
 
 namespace NetworkTables
 {
@@ -23,7 +23,8 @@ class Data;
 class NetworkQueue
 {
 	typedef std::deque<std::pair<Data *, bool> > DataQueue_t;
-	typedef std::map<UINT32, DataQueue_t::iterator> DataHash_t;
+	// Indexed by key id; points at the queued value for that key (or NULL)
+	typedef std::vector<DataQueue_t::value_type *> DataHash_t;
 public:
 	NetworkQueue();
 	~NetworkQueue();
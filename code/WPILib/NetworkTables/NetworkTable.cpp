@@ -18,37 +18,43 @@
 #include "NetworkTables/NetworkTableChangeListener.h"
 #include "NetworkTables/NetworkTableAdditionListener.h"
 #include "NetworkTables/NetworkTableConnectionListener.h"
+#include "NetworkTables/RecordEntry.h"
+#include "NetworkTables/Snapshot.h"
 #include "NetworkTables/StringEntry.h"
 #include "NetworkTables/TableEntry.h"
 #include "Synchronized.h"
+#include "Utility.h"
 #include "WPIErrors.h"
+#include <algorithm>
 
 NetworkTable::TableNameMap NetworkTable::_tableNameMap;
 NetworkTable::TableIdMap NetworkTable::_tableIdMap;
 UINT32 NetworkTable::_currentId = 1;
 bool NetworkTable::_initialized = false;
 SEM_ID NetworkTable::_staticMemberMutex = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
+const UINT32 NetworkTable::kNothingPending;
+const UINT32 NetworkTable::kMaxPendingWait;
+std::set<NetworkTable *> NetworkTable::_pendingTables;
+volatile UINT32 NetworkTable::_pendingTableCount = 0;
+volatile UINT32 NetworkTable::_nextPendingTime = 0;
 
 NetworkTable::NetworkTable() :
 	m_dataLock(NULL),
+	m_keyLock(NULL),
 	m_listenerLock(NULL),
+	m_minPublishInterval(0),
 	m_id(GrabId()),
 	m_transaction(NULL),
-	m_transactionCount(0),
-	m_hasChanged(NULL),
-	m_hasAdded(NULL)
+	m_transactionCount(0)
 {
 	m_dataLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
+	m_keyLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
 	m_listenerLock = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
 	m_transaction = new NetworkTables::NetworkQueue();
-	m_hasChanged = new NetworkTables::NetworkQueue();
-	m_hasAdded = new NetworkTables::NetworkQueue();
 }
 
 NetworkTable::~NetworkTable()
 {
-	delete m_hasAdded;
-	delete m_hasChanged;
 	delete m_transaction;
 	semTake(m_listenerLock, WAIT_FOREVER);
 	m_connectionListeners.clear();
@@ -58,7 +64,9 @@ NetworkTable::~NetworkTable()
 	semDelete(m_listenerLock);
 	semTake(m_dataLock, WAIT_FOREVER);
 	m_connections.clear();
+	semTake(m_keyLock, WAIT_FOREVER);
 	m_data.clear();
+	semDelete(m_keyLock);
 	semDelete(m_dataLock);
 }
 
@@ -107,7 +115,7 @@ NetworkTable *NetworkTable::GetTable(int id)
 
 std::vector<const char *> NetworkTable::GetKeys()
 {
-	Synchronized sync(m_dataLock);
+	Synchronized sync(m_keyLock);
 	std::vector<const char *> keys;
 	keys.reserve(m_data.size());
 	DataMap::iterator it = m_data.begin();
@@ -129,16 +137,25 @@ void NetworkTable::BeginTransaction()
 
 void NetworkTable::EndTransaction()
 {
-	Synchronized sync(m_dataLock);
-	if (m_transactionCount == 0)
-	{
-		wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "EndTransaction() called too many times");
-		return;
-	}
-	else if (--m_transactionCount == 0)
+	std::auto_ptr<NetworkTables::NetworkQueue> transaction;
 	{
-		ProcessTransaction(true, m_transaction);
+		Synchronized sync(m_dataLock);
+		if (m_transactionCount == 0)
+		{
+			wpi_setWPIErrorWithContext(NetworkTablesCorrupt, "EndTransaction() called too many times");
+			return;
+		}
+		else if (--m_transactionCount != 0 || m_transaction->IsEmpty())
+		{
+			return;
+		}
+		// Take the finished transaction while still holding the lock, so a
+		// transaction begun by another task meanwhile goes into a fresh queue
+		transaction.reset(m_transaction);
+		m_transaction = new NetworkTables::NetworkQueue();
 	}
+	// Processing takes the lock again, but lets go of it before telling the listeners
+	ProcessTransaction(true, transaction.get());
 }
 
 /**
@@ -254,33 +271,23 @@ bool NetworkTable::IsConnected()
 
 bool NetworkTable::ContainsKey(const char *keyName)
 {
-	if (keyName == NULL)
-	{
-		wpi_setWPIErrorWithContext(NullParameter, "keyName");
-		return false;
-	}
-	Synchronized sync(m_dataLock);
-	DataMap::iterator key = m_data.find(keyName);
-	return key != m_data.end() && key->second->HasEntry();
+	NetworkTables::Key *key = FindKey(keyName);
+	return key != NULL && key->HasEntry();
 }
 
 /**
  * Internally used to get at the underlying Entry
+ * The entry is freed when the key is next put, so hold m_dataLock while using it.
  * @param keyName the name of the key
  * @return the entry at that position (or null if no entry)
  */
 NetworkTables::Entry *NetworkTable::GetEntry(const char *keyName)
 {
-	if (keyName == NULL)
-	{
-		wpi_setWPIErrorWithContext(NullParameter, "keyName");
-		return NULL;
-	}
 	Synchronized sync(m_dataLock);
-	DataMap::iterator key = m_data.find(keyName);
-	if (key == m_data.end())
+	NetworkTables::Key *key = FindKey(keyName);
+	if (key == NULL)
 		return NULL;
-	return key->second->GetEntry();
+	return key->GetEntry();
 }
 
 /**
@@ -290,14 +297,10 @@ NetworkTables::Entry *NetworkTable::GetEntry(const char *keyName)
  */
 int NetworkTable::GetInt(const char *keyName)
 {
-	NetworkTables::Entry *entry = GetEntry(keyName);
-	if (entry != NULL)
-	{
-		if (entry->GetType() == kNetworkTables_Types_INT)
-			return entry->GetInt();
-		else
-			wpi_setWPIError(NetworkTablesWrongType);
-	}
+	NetworkTables::Key *key = FindKey(keyName);
+	NetworkTables::Key::Value value;
+	if (key != NULL && CheckType(key->ReadValue(&value), kNetworkTables_Types_INT))
+		return value.i;
 	return 0;
 }
 
@@ -308,14 +311,10 @@ int NetworkTable::GetInt(const char *keyName)
  */
 bool NetworkTable::GetBoolean(const char *keyName)
 {
-	NetworkTables::Entry *entry = GetEntry(keyName);
-	if (entry != NULL)
-	{
-		if (entry->GetType() == kNetworkTables_Types_BOOLEAN)
-			return entry->GetBoolean();
-		else
-			wpi_setWPIError(NetworkTablesWrongType);
-	}
+	NetworkTables::Key *key = FindKey(keyName);
+	NetworkTables::Key::Value value;
+	if (key != NULL && CheckType(key->ReadValue(&value), kNetworkTables_Types_BOOLEAN))
+		return value.b;
 	return false;
 }
 
@@ -326,14 +325,10 @@ bool NetworkTable::GetBoolean(const char *keyName)
  */
 double NetworkTable::GetDouble(const char *keyName)
 {
-	NetworkTables::Entry *entry = GetEntry(keyName);
-	if (entry != NULL)
-	{
-		if (entry->GetType() == kNetworkTables_Types_DOUBLE)
-			return entry->GetDouble();
-		else
-			wpi_setWPIError(NetworkTablesWrongType);
-	}
+	NetworkTables::Key *key = FindKey(keyName);
+	NetworkTables::Key::Value value;
+	if (key != NULL && CheckType(key->ReadValue(&value), kNetworkTables_Types_DOUBLE))
+		return value.d;
 	return 0.0;
 }
 
@@ -344,6 +339,7 @@ double NetworkTable::GetDouble(const char *keyName)
  */
 int NetworkTable::GetString(const char *keyName, char *value, int len)
 {
+	Synchronized sync(m_dataLock);
 	NetworkTables::Entry *entry = GetEntry(keyName);
 	if (entry != NULL)
 	{
@@ -357,6 +353,7 @@ int NetworkTable::GetString(const char *keyName, char *value, int len)
 
 std::string NetworkTable::GetString(std::string keyName)
 {
+	Synchronized sync(m_dataLock);
 	NetworkTables::Entry *entry = GetEntry(keyName.c_str());
 	if (entry != NULL)
 	{
@@ -368,6 +365,20 @@ std::string NetworkTable::GetString(std::string keyName)
 	return "";
 }
 
+/**
+ * Copies the record at the specified key.
+ * @param keyName the key
+ * @param record the structure to fill in
+ * @param size the size of the structure
+ * @return the number of bytes copied
+ */
+int NetworkTable::GetRecord(const char *keyName, void *record, int size)
+{
+	NetworkTables::Key *key = FindKey(keyName);
+	if (key == NULL)
+		return 0;
+	return GetRecord(key, record, size);
+}
 
 /**
  * Returns the value at the specified key.
@@ -376,6 +387,7 @@ std::string NetworkTable::GetString(std::string keyName)
  */
 NetworkTable *NetworkTable::GetSubTable(const char *keyName)
 {
+	Synchronized sync(m_dataLock);
 	NetworkTables::Entry *entry = GetEntry(keyName);
 	if (entry != NULL)
 	{
@@ -445,6 +457,25 @@ void NetworkTable::PutString(std::string keyName, std::string value)
 	PutString(keyName.c_str(), value.c_str());
 }
 
+/**
+ * Maps the specified key to a copy of a fixed-layout structure.
+ * The whole structure is sent as one value with one confirmation, so related
+ * fields updated every loop cost far less than putting each one separately.
+ * Records are sent as strings of the raw bytes, in the robot's byte order.
+ * @param keyName the key
+ * @param record the structure
+ * @param size the size of the structure (at most RecordEntry::kMaxSize bytes)
+ */
+void NetworkTable::PutRecord(const char *keyName, const void *record, int size)
+{
+	if (keyName == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "keyName");
+		return;
+	}
+	PutRecord(GetKey(keyName), record, size);
+}
+
 /**
  * Maps the specified key to the specified value in this table.
  * Neither the key nor the value can be null.
@@ -462,6 +493,185 @@ void NetworkTable::PutSubTable(const char *keyName, NetworkTable *value)
 	Put(keyName, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::TableEntry(value)));
 }
 
+/**
+ * Limits how often values in this table are sent to the peers.
+ * A Put that comes sooner than the period after the last send of that key
+ * updates the local value only; the latest value is sent once the period has
+ * expired, even if no other Put of that key comes along.
+ * @param period the minimum time between sends of a key in seconds (0 for no limit)
+ */
+void NetworkTable::SetMinPublishInterval(double period)
+{
+	Synchronized sync(m_dataLock);
+	m_minPublishInterval = (UINT32)(period * 1e6);
+}
+
+/**
+ * Limits how often the given key is sent to the peers, overriding the table setting.
+ * @param keyName the key
+ * @param period the minimum time between sends of the key in seconds (0 to use the table setting)
+ */
+void NetworkTable::SetMinPublishInterval(const char *keyName, double period)
+{
+	if (keyName == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "keyName");
+		return;
+	}
+	Synchronized sync(m_dataLock);
+	GetKey(keyName)->m_minPublishInterval = (UINT32)(period * 1e6);
+}
+
+/**
+ * Resolves a key name into a handle that can be passed to the Get and Put methods.
+ * Looking a key up by handle avoids searching the table by name on every call,
+ * so high rate callers should resolve their keys once and keep the handles.
+ * The handle stays valid for the life of the table.
+ * @param keyName the key
+ * @return the handle for the key
+ */
+NetworkTables::Key *NetworkTable::GetKeyHandle(const char *keyName)
+{
+	if (keyName == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "keyName");
+		return NULL;
+	}
+	return GetKey(keyName);
+}
+
+/**
+ * Returns the value at the specified key.
+ * @param key the key handle from GetKeyHandle()
+ * @return the value
+ */
+int NetworkTable::GetInt(NetworkTables::Key *key)
+{
+	NetworkTables::Key::Value value;
+	if (CheckKey(key) && CheckType(key->ReadValue(&value), kNetworkTables_Types_INT))
+		return value.i;
+	return 0;
+}
+
+/**
+ * Returns the value at the specified key.
+ * @param key the key handle from GetKeyHandle()
+ * @return the value
+ */
+bool NetworkTable::GetBoolean(NetworkTables::Key *key)
+{
+	NetworkTables::Key::Value value;
+	if (CheckKey(key) && CheckType(key->ReadValue(&value), kNetworkTables_Types_BOOLEAN))
+		return value.b;
+	return false;
+}
+
+/**
+ * Returns the value at the specified key.
+ * @param key the key handle from GetKeyHandle()
+ * @return the value
+ */
+double NetworkTable::GetDouble(NetworkTables::Key *key)
+{
+	NetworkTables::Key::Value value;
+	if (CheckKey(key) && CheckType(key->ReadValue(&value), kNetworkTables_Types_DOUBLE))
+		return value.d;
+	return 0.0;
+}
+
+/**
+ * Copies the record at the specified key.
+ * Records put by a client arrive as strings and are copied the same way.
+ * @param key the key handle from GetKeyHandle()
+ * @param record the structure to fill in
+ * @param size the size of the structure
+ * @return the number of bytes copied
+ */
+int NetworkTable::GetRecord(NetworkTables::Key *key, void *record, int size)
+{
+	if (record == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "record");
+		return 0;
+	}
+	Synchronized sync(m_dataLock);
+	NetworkTables::Entry *entry = GetEntry(key);
+	if (entry == NULL)
+		return 0;
+	if (entry->GetType() != kNetworkTables_Types_RECORD && entry->GetType() != kNetworkTables_Types_STRING)
+	{
+		wpi_setWPIError(NetworkTablesWrongType);
+		return 0;
+	}
+	return entry->GetString((char *)record, size);
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void NetworkTable::PutInt(NetworkTables::Key *key, int value)
+{
+	Put(key, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::IntegerEntry(value)));
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void NetworkTable::PutBoolean(NetworkTables::Key *key, bool value)
+{
+	Put(key, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::BooleanEntry(value)));
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void NetworkTable::PutDouble(NetworkTables::Key *key, double value)
+{
+	Put(key, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::DoubleEntry(value)));
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void NetworkTable::PutString(NetworkTables::Key *key, const char *value)
+{
+	if (value == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "value");
+		return;
+	}
+	Put(key, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::StringEntry(value)));
+}
+
+/**
+ * Maps the specified key to a copy of a fixed-layout structure.
+ * @param key the key handle from GetKeyHandle()
+ * @param record the structure
+ * @param size the size of the structure (at most RecordEntry::kMaxSize bytes)
+ */
+void NetworkTable::PutRecord(NetworkTables::Key *key, const void *record, int size)
+{
+	if (record == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "record");
+		return;
+	}
+	if (size < 0 || (UINT32)size > NetworkTables::RecordEntry::kMaxSize)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "size");
+		return;
+	}
+	Put(key, std::auto_ptr<NetworkTables::Entry>(new NetworkTables::RecordEntry(record, size)));
+}
+
 UINT32 NetworkTable::GrabId()
 {
 	Synchronized sync(_staticMemberMutex);
@@ -474,81 +684,150 @@ void NetworkTable::ProcessTransaction(bool confirmed, NetworkTables::NetworkQueu
 		return;
 
 	NetworkTables::Connection *source = ((NetworkTables::Entry *)transaction->Peek())->GetSource();
+	typedef std::vector<std::pair<NetworkTables::Key *, bool> > KeyList;
+	KeyList updated;
 
-	Synchronized sync(m_dataLock);
+	{
+		Synchronized sync(m_dataLock);
 
-	std::set<NetworkTables::Connection *>::iterator it, end;
-	it = m_connections.begin();
-	end = m_connections.end();
-	for (; it != end; it++)
-		if (*it != source)
-			(*it)->OfferTransaction(transaction);
+		std::set<NetworkTables::Connection *>::iterator it, end;
+		it = m_connections.begin();
+		end = m_connections.end();
+		for (; it != end; it++)
+			if (*it != source)
+				(*it)->OfferTransaction(transaction);
 
-	while (!transaction->IsEmpty())
-	{
-		std::pair<NetworkTables::Data *, bool> data = transaction->Poll();
-		// TODO: Remove this
-		if (!data.second)
-			printf("Internal error!");
-		std::auto_ptr<NetworkTables::Entry> entry =
-			std::auto_ptr<NetworkTables::Entry>((NetworkTables::Entry *)data.first);
-		std::auto_ptr<NetworkTables::Entry> oldEntry = entry->GetKey()->SetEntry(entry);
-		if (oldEntry.get() == NULL)
-			m_hasAdded->Offer(data.first);
-		else	// TODO: Filter unchanged values
-			m_hasChanged->Offer(data.first);
-	}
-	while (!m_hasAdded->IsEmpty())
-	{
-		NetworkTables::Entry *entry = (NetworkTables::Entry *)m_hasAdded->Poll().first;
-		AlertListeners(true, confirmed, entry->GetKey()->GetName().c_str(), entry);
+		while (!transaction->IsEmpty())
+		{
+			std::pair<NetworkTables::Data *, bool> data = transaction->Poll();
+			// TODO: Remove this
+			if (!data.second)
+				printf("Internal error!");
+			std::auto_ptr<NetworkTables::Entry> entry =
+				std::auto_ptr<NetworkTables::Entry>((NetworkTables::Entry *)data.first);
+			NetworkTables::Key *key = entry->GetKey();
+			key->m_lastPublishTime = GetFPGATime();
+			ClearPending(key);
+			std::auto_ptr<NetworkTables::Entry> oldEntry = key->SetEntry(entry);
+			updated.push_back(KeyList::value_type(key, oldEntry.get() == NULL));
+		}
 	}
-	while (!m_hasChanged->IsEmpty())
+
+	// Tell the listeners about additions first, then changes
+	KeyList::iterator it = updated.begin();
+	KeyList::iterator end = updated.end();
+	for (; it != end; it++)
+		if (it->second)
+			AlertListeners(true, confirmed, it->first->GetName().c_str(), it->first->GetType());
+	for (it = updated.begin(); it != end; it++)
+		if (!it->second)
+			AlertListeners(false, confirmed, it->first->GetName().c_str(), it->first->GetType());
+}
+
+/**
+ * Bring a connection up to date with this table and any tables it contains.
+ * Everything is encoded into one snapshot that is written in a single pass;
+ * later changes are sent incrementally as usual.
+ * @param connection the new connection
+ */
+void NetworkTable::AddConnection(NetworkTables::Connection *connection)
+{
+	std::auto_ptr<NetworkTables::Snapshot> snapshot(new NetworkTables::Snapshot());
+	std::vector<NetworkTable *> locked;
+	std::vector<NetworkTable *> connected;
+
+	AddToSnapshot(connection, snapshot.get(), locked, connected);
+	// Queue the snapshot before any table is unlocked so no update can get ahead of it
+	if (!snapshot->IsEmpty())
+		connection->Offer(std::auto_ptr<NetworkTables::Data>(snapshot.release()));
+	std::vector<NetworkTable *>::reverse_iterator rit = locked.rbegin();
+	std::vector<NetworkTable *>::reverse_iterator rend = locked.rend();
+	for (; rit != rend; rit++)
+		semGive((*rit)->m_dataLock);
+
+	std::vector<NetworkTable *>::iterator it = connected.begin();
+	std::vector<NetworkTable *>::iterator end = connected.end();
+	for (; it != end; it++)
 	{
-		NetworkTables::Entry *entry = (NetworkTables::Entry *)m_hasChanged->Poll().first;
-		AlertListeners(true, confirmed, entry->GetKey()->GetName().c_str(), entry);
+		Synchronized sync((*it)->m_listenerLock);
+		std::set<NetworkTableConnectionListener *>::iterator lit, lend;
+		lit = (*it)->m_connectionListeners.begin();
+		lend = (*it)->m_connectionListeners.end();
+		for (; lit != lend; lit++)
+			(*lit)->Connected(*it);
 	}
 }
 
-void NetworkTable::AddConnection(NetworkTables::Connection *connection)
+/**
+ * Add this table's keys and values to a snapshot, preceded by those of the
+ * tables it contains.  Each table is left locked so it can not change until
+ * the snapshot is queued.
+ * @param connection the new connection
+ * @param snapshot the snapshot to add to
+ * @param locked the tables that have been locked, in locking order
+ * @param connected the tables that now have their first connection
+ */
+void NetworkTable::AddToSnapshot(NetworkTables::Connection *connection, NetworkTables::Snapshot *snapshot,
+	std::vector<NetworkTable *> &locked, std::vector<NetworkTable *> &connected)
 {
-	Synchronized sync(m_dataLock);
+	semTake(m_dataLock, WAIT_FOREVER);
+	locked.push_back(this);
+
+	if (!m_connections.insert(connection).second)
+		return;
 
-	if (m_connections.insert(connection).second)
+	// Keys are never removed, so they can be used after m_keyLock is released
+	std::vector<NetworkTables::Key *> keys;
 	{
+		Synchronized syncKeys(m_keyLock);
+		keys.reserve(m_data.size());
 		DataMap::iterator it = m_data.begin();
 		DataMap::iterator end = m_data.end();
 		for (; it != end; it++)
+			keys.push_back(it->second);
+	}
+
+	std::vector<NetworkTables::Key *>::iterator it = keys.begin();
+	std::vector<NetworkTables::Key *>::iterator end = keys.end();
+	for (; it != end; it++)
+	{
+		snapshot->Add(*it);
+		if ((*it)->HasEntry())
 		{
-			connection->Offer(it->second);
-			if(it->second->HasEntry())
-				connection->Offer(it->second->GetEntry());
+			NetworkTables::Entry *entry = (*it)->GetEntry();
+			if (entry->GetType() == kNetworkTables_TABLE)
+				((NetworkTables::TableEntry *)entry)->GetTable()->AddToSnapshot(connection, snapshot, locked, connected);
+			snapshot->Add(entry);
 		}
-		if (m_connections.size() == 1)
-		{
-			Synchronized syncStatic(_staticMemberMutex);
-			_tableIdMap.insert(TableIdMap::value_type(m_id, this));
+	}
 
-			std::set<NetworkTableConnectionListener *>::iterator lit, lend;
-			lit = m_connectionListeners.begin();
-			lend = m_connectionListeners.end();
-			for (; lit != lend; lit++)
-				(*lit)->Connected(this);
-		}
+	if (m_connections.size() == 1)
+	{
+		Synchronized syncStatic(_staticMemberMutex);
+		_tableIdMap.insert(TableIdMap::value_type(m_id, this));
+		connected.push_back(this);
 	}
 }
 
 void NetworkTable::RemoveConnection(NetworkTables::Connection *connection)
 {
-	Synchronized sync(m_dataLock);
+	bool disconnected = false;
+	{
+		Synchronized sync(m_dataLock);
 
-	m_connections.erase(connection);
+		m_connections.erase(connection);
 
-	if (m_connections.size() == 0)
-	{
-		Synchronized syncStatic(_staticMemberMutex);
-		_tableIdMap.erase(m_id);
+		if (m_connections.size() == 0)
+		{
+			Synchronized syncStatic(_staticMemberMutex);
+			_tableIdMap.erase(m_id);
+			disconnected = true;
+		}
+	}
 
+	if (disconnected)
+	{
+		Synchronized sync(m_listenerLock);
 		std::set<NetworkTableConnectionListener *>::iterator lit, lend;
 		lit = m_connectionListeners.begin();
 		lend = m_connectionListeners.end();
@@ -565,25 +844,99 @@ void NetworkTable::RemoveConnection(NetworkTables::Connection *connection)
  */
 NetworkTables::Key *NetworkTable::GetKey(const char *keyName)
 {
+	NetworkTables::Key *key = FindKey(keyName);
+	if (key != NULL)
+		return key;
+
+	// Lock order is m_dataLock, then m_keyLock
 	Synchronized sync(m_dataLock);
-	// Insert will add a new element if the key is not found
-	//  or will return the existing key if it is found.
-	std::pair<DataMap::iterator, bool> ret =
-		m_data.insert(DataMap::value_type(keyName, NULL));
-	if (ret.second)
 	{
+		Synchronized syncKeys(m_keyLock);
+		// Insert will add a new element if the key is not found
+		//  or will return the existing key if it is found.
+		std::pair<DataMap::iterator, bool> ret =
+			m_data.insert(DataMap::value_type(keyName, NULL));
+		if (!ret.second)
+			return ret.first->second;
 		// Key not found.  Create a new one.
-		ret.first->second = new NetworkTables::Key(this, keyName);
-		if (m_connections.size() != 0)
-		{
-			std::set<NetworkTables::Connection *>::iterator it, end;
-			it = m_connections.begin();
-			end = m_connections.end();
-			for (; it != end; it++)
-				(*it)->Offer(ret.first->second);
-		}
+		key = ret.first->second = new NetworkTables::Key(this, keyName);
 	}
-	return ret.first->second;
+	std::set<NetworkTables::Connection *>::iterator it, end;
+	it = m_connections.begin();
+	end = m_connections.end();
+	for (; it != end; it++)
+		(*it)->Offer(key);
+	return key;
+}
+
+/**
+ * Looks up the key for a name without creating one.
+ * Only the key map lock is taken, so this never waits on a transaction.
+ * @param keyName the name
+ * @return the key (or null if there is no key with that name)
+ */
+NetworkTables::Key *NetworkTable::FindKey(const char *keyName)
+{
+	if (keyName == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "keyName");
+		return NULL;
+	}
+	Synchronized sync(m_keyLock);
+	DataMap::iterator key = m_data.find(keyName);
+	if (key == m_data.end())
+		return NULL;
+	return key->second;
+}
+
+/**
+ * Checks the type of a value that was read from a key.
+ * @param type the type of the value (kNetworkTables_Types_NONE if there is no value)
+ * @param expected the type the caller asked for
+ * @return true if the value can be returned
+ */
+bool NetworkTable::CheckType(NetworkTables_Types type, NetworkTables_Types expected)
+{
+	if (type == kNetworkTables_Types_NONE)
+		return false;
+	if (type != expected)
+	{
+		wpi_setWPIError(NetworkTablesWrongType);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Verifies that a key handle belongs to this table.
+ * @param key the key handle
+ * @return true if the handle can be used with this table
+ */
+bool NetworkTable::CheckKey(NetworkTables::Key *key)
+{
+	if (key == NULL)
+	{
+		wpi_setWPIErrorWithContext(NullParameter, "key");
+		return false;
+	}
+	if (key->GetTable() != this)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "key belongs to another table");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Internally used to get at the underlying Entry
+ * @param key the key handle
+ * @return the entry for that key (or null if no entry)
+ */
+NetworkTables::Entry *NetworkTable::GetEntry(NetworkTables::Key *key)
+{
+	if (!CheckKey(key))
+		return NULL;
+	return key->GetEntry();
 }
 
 void NetworkTable::Put(const char *keyName, std::auto_ptr<NetworkTables::Entry> value)
@@ -593,14 +946,195 @@ void NetworkTable::Put(const char *keyName, std::auto_ptr<NetworkTables::Entry>
 		wpi_setWPIErrorWithContext(NullParameter, "keyName");
 		return;
 	}
-	Synchronized sync(m_dataLock);
-	NetworkTables::Key *key = GetKey(keyName);
+	Put(GetKey(keyName), value);
+}
+
+void NetworkTable::Put(NetworkTables::Key *key, std::auto_ptr<NetworkTables::Entry> value)
+{
+	if (!CheckKey(key))
+		return;
 	value->SetKey(key);
 
-	if (m_transactionCount == 0)
-		Got(true, key, value);
-	else
-		m_transaction->Offer(std::auto_ptr<NetworkTables::Data>(value.release()));
+	std::auto_ptr<NetworkTables::Entry> old;
+	NetworkTables_Types type;
+	bool isNew;
+	{
+		Synchronized sync(m_dataLock);
+
+		// Don't send a value the peers already have
+		bool unchanged = key->HasEntry() && key->GetEntry()->Equals(value.get());
+
+		if (m_transactionCount != 0)
+		{
+			// The transaction already coalesces repeated puts of a key,
+			// but a put may still need to override an earlier one in it
+			if (unchanged && !key->m_publishPending && !m_transaction->ContainsKey(key))
+				return;
+			m_transaction->Offer(std::auto_ptr<NetworkTables::Data>(value.release()));
+			return;
+		}
+
+		if (unchanged && !key->m_publishPending)
+			return;
+
+		isNew = !key->HasEntry();
+		UINT32 interval = GetPublishInterval(key);
+		UINT32 now = GetFPGATime();
+		if (interval != 0 && !isNew && now - key->m_lastPublishTime < interval)
+		{
+			// Too soon to send again, so only update the local value
+			if (unchanged)
+				return;
+			if (key->m_publishPending)
+			{
+				// The value being replaced was never sent
+				old = key->SetEntry(value);
+			}
+			else
+			{
+				// Hold on to the sent value until the pending one replaces it in the queues
+				key->m_sentEntry = key->SetEntry(value);
+				HoldBack(key);
+				// Let the connections work out when to send it
+				std::set<NetworkTables::Connection *>::iterator it, end;
+				it = m_connections.begin();
+				end = m_connections.end();
+				for (; it != end; it++)
+					(*it)->Wakeup();
+			}
+		}
+		else
+		{
+			old = key->SetEntry(value);
+			Publish(key, now);
+		}
+		type = key->GetType();
+	}
+	AlertListeners(isNew, true, key->GetName().c_str(), type);
+}
+
+/**
+ * Sends the current value of a key to the peers.  Must be called with m_dataLock held.
+ * @param key the key
+ * @param now the current FPGA time
+ */
+void NetworkTable::Publish(NetworkTables::Key *key, UINT32 now)
+{
+	key->m_lastPublishTime = now;
+	ClearPending(key);
+	Send(key->GetEntry());
+	// The new entry has taken the place of the held one in every connection's queue
+	key->m_sentEntry.reset();
+}
+
+/**
+ * Marks the value of a key as held back by the minimum publish interval.
+ * Must be called with m_dataLock held.
+ * @param key the key
+ */
+void NetworkTable::HoldBack(NetworkTables::Key *key)
+{
+	key->m_publishPending = true;
+	m_pendingKeys.insert(key);
+	UINT32 due = key->m_lastPublishTime + GetPublishInterval(key);
+	Synchronized sync(_staticMemberMutex);
+	if (_pendingTableCount == 0 || (INT32)(due - _nextPendingTime) < 0)
+		_nextPendingTime = due;
+	_pendingTables.insert(this);
+	_pendingTableCount = _pendingTables.size();
+}
+
+/**
+ * Marks the value of a key as no longer held back.  Must be called with m_dataLock held.
+ * @param key the key
+ */
+void NetworkTable::ClearPending(NetworkTables::Key *key)
+{
+	key->m_publishPending = false;
+	if (m_pendingKeys.erase(key) != 0 && m_pendingKeys.empty())
+	{
+		Synchronized sync(_staticMemberMutex);
+		_pendingTables.erase(this);
+		_pendingTableCount = _pendingTables.size();
+	}
+}
+
+/**
+ * Gets the minimum time between sends of a key.
+ * @param key the key
+ * @return the time in microseconds (0 for no limit)
+ */
+UINT32 NetworkTable::GetPublishInterval(NetworkTables::Key *key)
+{
+	return key->m_minPublishInterval != 0 ? key->m_minPublishInterval : m_minPublishInterval;
+}
+
+/**
+ * Sends the values of this table that were held back by the minimum publish
+ * interval and whose interval has now expired.
+ * @param now the current FPGA time
+ * @return the time in microseconds until the next held back value is due,
+ * or kNothingPending if there are none
+ */
+UINT32 NetworkTable::PublishPendingKeys(UINT32 now)
+{
+	Synchronized sync(m_dataLock);
+	UINT32 wait = kNothingPending;
+	std::set<NetworkTables::Key *>::iterator it = m_pendingKeys.begin();
+	while (it != m_pendingKeys.end())
+	{
+		// Publish() removes the key from the set, so step past it first
+		NetworkTables::Key *key = *it++;
+		UINT32 interval = GetPublishInterval(key);
+		UINT32 elapsed = now - key->m_lastPublishTime;
+		if (elapsed >= interval)
+			Publish(key, now);
+		else
+			wait = std::min(wait, interval - elapsed);
+	}
+	return wait;
+}
+
+/**
+ * Sends the held back values that are due.  This is called by the connections'
+ * I/O tasks so the latest value of a key goes out even when no later Put of it
+ * comes along.  Until a value is due it takes no locks, and then it only visits
+ * the tables that hold values back.
+ * @return the time in microseconds until the next held back value is due,
+ * or kNothingPending if there are none
+ */
+UINT32 NetworkTable::PublishPending()
+{
+	if (_pendingTableCount == 0)
+		return kNothingPending;
+	UINT32 now = GetFPGATime();
+	INT32 remaining = (INT32)(_nextPendingTime - now);
+	if (remaining > 0)
+		return remaining;
+
+	std::vector<NetworkTable *> tables;
+	{
+		Synchronized sync(_staticMemberMutex);
+		tables.assign(_pendingTables.begin(), _pendingTables.end());
+		// Push the due time out while the tables are visited; a value held
+		// back meanwhile brings it in again
+		_nextPendingTime = now + kMaxPendingWait;
+	}
+
+	// The tables take their own locks, which come before the static one
+	UINT32 wait = kNothingPending;
+	std::vector<NetworkTable *>::iterator it = tables.begin();
+	std::vector<NetworkTable *>::iterator end = tables.end();
+	for (; it != end; it++)
+		wait = std::min(wait, (*it)->PublishPendingKeys(now));
+
+	if (wait != kNothingPending)
+	{
+		Synchronized sync(_staticMemberMutex);
+		if ((INT32)(now + wait - _nextPendingTime) < 0)
+			_nextPendingTime = now + wait;
+	}
+	return wait;
 }
 
 void NetworkTable::Send(NetworkTables::Entry *entry)
@@ -624,18 +1158,43 @@ void NetworkTable::Send(NetworkTables::Entry *entry)
 void NetworkTable::Got(bool confirmed, NetworkTables::Key *key, std::auto_ptr<NetworkTables::Entry> value)
 {
 	std::auto_ptr<NetworkTables::Entry> old;
+	NetworkTables_Types type;
 	{
 		Synchronized sync(m_dataLock);
 		old = key->SetEntry(value);
+		type = key->GetType();
+		// The peer's value replaces any local one still waiting to be sent
+		ClearPending(key);
+		// TODO: return if value didn't change
+		Send(key->GetEntry());
 	}
-	// TODO: return if value didn't change
+	AlertListeners(old.get() == NULL, confirmed, key->GetName().c_str(), type);
+}
 
-	Send(key->GetEntry());
-	AlertListeners(old.get() == NULL, confirmed, key->GetName().c_str(), key->GetEntry());
+/**
+ * This method is called by a connection when the peer confirms a value of this table.
+ * The value may have been replaced since it was sent, so the listeners are told
+ * about the current one.
+ * @param key the key
+ */
+void NetworkTable::Confirmed(NetworkTables::Key *key)
+{
+	NetworkTables_Types type;
+	{
+		Synchronized sync(m_dataLock);
+		if (!key->HasEntry())
+			return;
+		type = key->GetType();
+	}
+	AlertListeners(false, true, key->GetName().c_str(), type);
 }
 
+/**
+ * Calls the listeners for a key.  This must not be called with m_dataLock held
+ * so that the listeners can not hold up the other users of the table.
+ */
 void NetworkTable::AlertListeners(bool isNew, bool confirmed, const char *keyName,
-	NetworkTables::Entry *value)
+	NetworkTables_Types type)
 {
 	Synchronized sync(m_listenerLock);
 
@@ -645,7 +1204,7 @@ void NetworkTable::AlertListeners(bool isNew, bool confirmed, const char *keyNam
 		lit = m_additionListeners.begin();
 		lend = m_additionListeners.end();
 		for (; lit != lend; lit++)
-			(*lit)->FieldAdded(this, keyName, value->GetType());
+			(*lit)->FieldAdded(this, keyName, type);
 	}
 
 	ListenersMap::iterator listeners = m_listeners.find(keyName);
@@ -657,9 +1216,9 @@ void NetworkTable::AlertListeners(bool isNew, bool confirmed, const char *keyNam
 		for (; lit != lend; lit++)
 		{
 			if (confirmed)
-				(*lit)->ValueConfirmed(this, keyName, value->GetType());
+				(*lit)->ValueConfirmed(this, keyName, type);
 			else
-				(*lit)->ValueChanged(this, keyName, value->GetType());
+				(*lit)->ValueChanged(this, keyName, type);
 		}
 	}
 
@@ -670,9 +1229,9 @@ void NetworkTable::AlertListeners(bool isNew, bool confirmed, const char *keyNam
 		for (; lit != lend; lit++)
 		{
 			if (confirmed)
-				(*lit)->ValueConfirmed(this, keyName, value->GetType());
+				(*lit)->ValueConfirmed(this, keyName, type);
 			else
-				(*lit)->ValueChanged(this, keyName, value->GetType());
+				(*lit)->ValueChanged(this, keyName, type);
 		}
 	}
 }
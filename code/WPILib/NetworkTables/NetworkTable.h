@@ -8,6 +8,7 @@
 #define __NETWORK_TABLE_H__
 
 #include "ErrorBase.h"
+#include "NetworkTables/InterfaceConstants.h"
 #include <map>
 #include <set>
 #include <vector>
@@ -19,6 +20,7 @@ namespace NetworkTables
     class Entry;
     class Key;
     class NetworkQueue;
+    class Snapshot;
     class TableAssignment;
     class TableEntry;
 }
@@ -58,29 +60,65 @@ public:
 	double GetDouble(const char *keyName);
 	int GetString(const char *keyName, char *value, int len);
 	std::string GetString(std::string keyName);
+	int GetRecord(const char *keyName, void *record, int size);
 	NetworkTable *GetSubTable(const char *keyName);
 	void PutInt(const char *keyName, int value);
 	void PutBoolean(const char *keyName, bool value);
 	void PutDouble(const char *keyName, double value);
 	void PutString(const char *keyName, const char *value);
 	void PutString(std::string keyName, std::string value);
+	void PutRecord(const char *keyName, const void *record, int size);
 	void PutSubTable(const char *keyName, NetworkTable *value);
+	void SetMinPublishInterval(double period);
+	void SetMinPublishInterval(const char *keyName, double period);
+
+	NetworkTables::Key *GetKeyHandle(const char *keyName);
+	int GetInt(NetworkTables::Key *key);
+	bool GetBoolean(NetworkTables::Key *key);
+	double GetDouble(NetworkTables::Key *key);
+	int GetRecord(NetworkTables::Key *key, void *record, int size);
+	void PutInt(NetworkTables::Key *key, int value);
+	void PutBoolean(NetworkTables::Key *key, bool value);
+	void PutDouble(NetworkTables::Key *key, double value);
+	void PutString(NetworkTables::Key *key, const char *value);
+	void PutRecord(NetworkTables::Key *key, const void *record, int size);
 	
 private:
+	/** Returned by PublishPending when no held back value is waiting */
+	static const UINT32 kNothingPending = 0xFFFFFFFF;
+	/** The furthest ahead a held back value can be due, in microseconds */
+	static const UINT32 kMaxPendingWait = 0x7FFFFFFF;
+
 	static UINT32 GrabId();
+	static UINT32 PublishPending();
+	UINT32 PublishPendingKeys(UINT32 now);
+	UINT32 GetPublishInterval(NetworkTables::Key *key);
+	void Publish(NetworkTables::Key *key, UINT32 now);
+	void HoldBack(NetworkTables::Key *key);
+	void ClearPending(NetworkTables::Key *key);
 	void ProcessTransaction(bool confirmed, NetworkTables::NetworkQueue *transaction);
 	UINT32 GetId() {return m_id;}
 	void AddConnection(NetworkTables::Connection *connection);
+	void AddToSnapshot(NetworkTables::Connection *connection, NetworkTables::Snapshot *snapshot,
+		std::vector<NetworkTable *> &locked, std::vector<NetworkTable *> &connected);
 	void RemoveConnection(NetworkTables::Connection *connection);
 	NetworkTables::Key *GetKey(const char *keyName);
+	NetworkTables::Key *FindKey(const char *keyName);
+	bool CheckKey(NetworkTables::Key *key);
+	bool CheckType(NetworkTables_Types type, NetworkTables_Types expected);
+	NetworkTables::Entry *GetEntry(NetworkTables::Key *key);
 	void Put(const char *keyName, std::auto_ptr<NetworkTables::Entry> value);
+	void Put(NetworkTables::Key *key, std::auto_ptr<NetworkTables::Entry> value);
 	void Send(NetworkTables::Entry *entry);
 	void Got(bool confirmed, NetworkTables::Key *key, std::auto_ptr<NetworkTables::Entry> value);
-	void AlertListeners(bool isNew, bool confirmed, const char *keyName, NetworkTables::Entry *value);
+	void Confirmed(NetworkTables::Key *key);
+	void AlertListeners(bool isNew, bool confirmed, const char *keyName, NetworkTables_Types type);
 	void EncodeName(NetworkTables::Buffer *buffer);
 
-	/** The lock for data */
+	/** The lock for data, connections and transactions */
 	SEM_ID m_dataLock;
+	/** The lock for the key map (taken after m_dataLock) */
+	SEM_ID m_keyLock;
 	/** The actual data */
 	typedef std::map<std::string, NetworkTables::Key *> DataMap;
 	DataMap m_data;
@@ -97,16 +135,16 @@ private:
 	std::set<NetworkTableAdditionListener *> m_additionListeners;
 	/** Set of connection listeners */
 	std::set<NetworkTableConnectionListener *> m_connectionListeners;
+	/** The minimum time between sends of a key in microseconds (0 for no limit) */
+	UINT32 m_minPublishInterval;
+	/** Keys whose latest value is held back by the minimum publish interval */
+	std::set<NetworkTables::Key *> m_pendingKeys;
 	/** The id of this table */
 	UINT32 m_id;
 	/** The queue of the current transaction */
 	NetworkTables::NetworkQueue *m_transaction;
 	/** The number of times begin transaction has been called without a matching end transaction */
 	int m_transactionCount;
-	/** A list of values which need to be signaled */
-	NetworkTables::NetworkQueue *m_hasChanged;
-	/** A list of values which has been added */
-	NetworkTables::NetworkQueue *m_hasAdded;
 
 	/** Links names to tables */
 	typedef std::map<std::string, NetworkTable *> TableNameMap;
@@ -120,6 +158,12 @@ private:
 	static bool _initialized;
 	/** Protects access to static members */
 	static SEM_ID _staticMemberMutex;
+	/** Tables with values held back by the minimum publish interval */
+	static std::set<NetworkTable *> _pendingTables;
+	/** The size of _pendingTables, read by PublishPending without the lock */
+	static volatile UINT32 _pendingTableCount;
+	/** The FPGA time the next held back value is due, read by PublishPending without the lock */
+	static volatile UINT32 _nextPendingTime;
 	/** Usage Guidelines... */
 	DISALLOW_COPY_AND_ASSIGN(NetworkTable);
 };
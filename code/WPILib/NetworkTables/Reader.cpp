@@ -15,6 +15,7 @@
 #include <errnoLib.h> 
 #include <selectLib.h> 
 #include <sockLib.h> 
+#include <string.h>
 #include <usrLib.h> 
 
 namespace NetworkTables
@@ -22,43 +23,57 @@ namespace NetworkTables
 
 Reader::Reader(Connection *connection, int inputStreamFd) :
 	m_connection(connection),
-	m_inputStreamFd(inputStreamFd)
+	m_inputStreamFd(inputStreamFd),
+	m_head(0),
+	m_tail(0),
+	m_recvCalls(0)
 {
 	m_lastByte = -2;
 }
 
-int Reader::Read()
+/**
+ * Receive whatever is available on the input stream into the buffer.
+ * This is only called once every buffered byte has been decoded, so a whole
+ * burst of updates costs one select() and one recv().  The connection is
+ * dropped if the rest of a message does not arrive within the watchdog timeout.
+ * @return True if data was received, false if the connection is closed.
+ */
+bool Reader::Fill()
 {
 	fd_set readFdSet;
+	struct timeval timeout;
 	int retval = ERROR;
 
+	m_head = 0;
+	m_tail = 0;
 	FD_ZERO(&readFdSet);
 	FD_SET(m_inputStreamFd, &readFdSet);
-	if (select(FD_SETSIZE, &readFdSet, NULL, NULL, NULL) != ERROR)
+	timeout.tv_sec = Connection::kTimeout / 1000;
+	timeout.tv_usec = (Connection::kTimeout % 1000) * 1000;
+	int ready = select(FD_SETSIZE, &readFdSet, NULL, NULL, &timeout);
+	if (ready == 0)
+	{
+		wpi_setStaticWPIErrorWithContext(m_connection, Timeout, "NetworkTables watchdog expired... disconnecting");
+		m_connection->Close();
+		return false;
+	}
+	else if (ready != ERROR)
 	{
 		if (FD_ISSET(m_inputStreamFd, &readFdSet))
 		{
-			char readbuf;
-			retval = recv(m_inputStreamFd, &readbuf, 1, 0);
-			m_lastByte = readbuf;
+			retval = recv(m_inputStreamFd, (char *)m_buffer, kBufferSize, 0);
+			m_recvCalls++;
 			if (retval != ERROR && retval > 0)
 			{
-#ifdef DEBUG
-				if (m_lastByte != kNetworkTables_PING)
-				{
-					char pbuf[6];
-					snprintf(pbuf, 6, "I:%02X\n", m_lastByte);
-					printf(pbuf);
-				}
-#endif
-				return m_lastByte;
+				m_tail = retval;
+				return true;
 			}
 		}
 	}
 	else if (!m_connection->IsConnected())
 	{
 		// The error came from us closing the socket
-		return 0;
+		return false;
 	}
 
 	// TODO: Should we ignore ECONNRESET errors?
@@ -71,7 +86,24 @@ int Reader::Read()
 		printErrno(err);
 	}
 	m_connection->Close();
-	return 0;
+	return false;
+}
+
+int Reader::Read()
+{
+	if (m_head == m_tail && !Fill())
+		return 0;
+
+	m_lastByte = m_buffer[m_head++];
+#ifdef DEBUG
+	if (m_lastByte != kNetworkTables_PING)
+	{
+		char pbuf[6];
+		snprintf(pbuf, 6, "I:%02X\n", m_lastByte);
+		printf(pbuf);
+	}
+#endif
+	return m_lastByte;
 }
 
 int Reader::Check(bool useLastValue)
@@ -87,18 +119,35 @@ std::string Reader::ReadString()
 	if (m_lastByte == kNetworkTables_BEGIN_STRING)
 	{
 		buffer.reserve(360);
-		buffer.clear();
-		while (Read() != kNetworkTables_END_STRING)
-			buffer.append(1, (char)m_lastByte);
+		// Copy up to the terminator straight out of the receive buffer
+		while (m_head < m_tail || Fill())
+		{
+			UINT8 *start = &m_buffer[m_head];
+			UINT8 *end = (UINT8 *)memchr(start, kNetworkTables_END_STRING, m_tail - m_head);
+			int count = ((end != NULL) ? end : &m_buffer[m_tail]) - start;
+			buffer.append((char *)start, count);
+			m_head += count;
+			if (end != NULL)
+			{
+				m_lastByte = m_buffer[m_head++];
+				break;
+			}
+		}
 	}
 	else
 	{
 		int length = m_lastByte;
-		buffer.reserve(length + 1);
-		buffer.clear();
-		for (int i = 0; i < length; i++)
-			buffer[i] = (char)Read();
-		buffer[length] = '\0';
+		buffer.reserve(length);
+		while (length > 0 && (m_head < m_tail || Fill()))
+		{
+			int count = m_tail - m_head;
+			if (count > length)
+				count = length;
+			buffer.append((char *)&m_buffer[m_head], count);
+			m_head += count;
+			length -= count;
+			m_lastByte = m_buffer[m_head - 1];
+		}
 	}
 
 	return buffer;
@@ -132,20 +181,21 @@ int Reader::ReadVariableSize(bool useLastValue, int tag) {
 
 int Reader::ReadInt()
 {
-	return (Read() << 24) | (Read() << 16) | (Read() << 8) | Read();
+	UINT32 value = Read();
+	value = (value << 8) | Read();
+	value = (value << 8) | Read();
+	value = (value << 8) | Read();
+	return value;
 }
 
 double Reader::ReadDouble()
 {
-	long l = Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	l = (l << 8) | Read();
-	return *((double *)&l);
+	UINT64 bits = 0;
+	double value;
+	for (unsigned i = 0; i < sizeof(value); i++)
+		bits = (bits << 8) | Read();
+	memcpy(&value, &bits, sizeof(value));
+	return value;
 }
 
 int Reader::ReadConfirmations(bool useLastValue)
@@ -28,16 +28,30 @@ public:
     int ReadConfirmations(bool useLastValue);
     int ReadDenials(bool useLastValue);
     std::auto_ptr<Entry> ReadEntry(bool useLastValue);
+
+    bool HasBufferedData() {return m_head != m_tail;}
+    UINT32 GetRecvCalls() {return m_recvCalls;}
 private:
+    bool Fill();
     int Check(bool useLastValue);
     int ReadVariableSize(bool useLastValue, int tag);
 
+    static const int kBufferSize = 1024;
+
     /** The connection associated with this reader */
     Connection *m_connection;
     /** The input stream */
     int m_inputStreamFd;
     /** The last read value (-2 if nothing has been read) */
     int m_lastByte;
+    /** Bytes received from the input stream that have not been decoded yet */
+    UINT8 m_buffer[kBufferSize];
+    /** The index of the next byte to decode */
+    int m_head;
+    /** The index one past the last received byte */
+    int m_tail;
+    /** The number of recv() calls made by this reader, for benchmarking */
+    UINT32 m_recvCalls;
 
 };
 
@@ -0,0 +1,69 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "NetworkTables/RecordEntry.h"
+#include "NetworkTables/Buffer.h"
+#include "NetworkTables/FreeList.h"
+#include <string.h>
+
+namespace NetworkTables
+{
+
+const UINT32 RecordEntry::kMaxSize;
+
+FreeList RecordEntry::_freeList("RecordEntry", sizeof(RecordEntry));
+
+/**
+ * @param record the structure to copy
+ * @param size the size of the structure (at most kMaxSize)
+ */
+RecordEntry::RecordEntry(const void *record, UINT32 size) :
+	m_size(size)
+{
+	memcpy(m_value, record, size);
+}
+
+void *RecordEntry::operator new(size_t size)
+{
+	return _freeList.Allocate(size);
+}
+
+void RecordEntry::operator delete(void *block, size_t size)
+{
+	_freeList.Free(block, size);
+}
+
+NetworkTables_Types RecordEntry::GetType()
+{
+	return kNetworkTables_Types_RECORD;
+}
+
+void RecordEntry::Encode(Buffer *buffer)
+{
+	Entry::Encode(buffer);
+	buffer->WriteByte(kNetworkTables_STRING);
+	buffer->WriteString(m_size, (const char *)m_value);
+}
+
+int RecordEntry::GetString(char *str, int len)
+{
+	int size = (int)m_size < len ? (int)m_size : len;
+	memcpy(str, m_value, size);
+	return size;
+}
+
+std::string RecordEntry::GetString()
+{
+	return std::string((const char *)m_value, m_size);
+}
+
+bool RecordEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((RecordEntry *)other)->m_size == m_size
+		&& memcmp(((RecordEntry *)other)->m_value, m_value, m_size) == 0;
+}
+
+} // namespace
@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __RECORD_ENTRY_H__
+#define __RECORD_ENTRY_H__
+
+#include "NetworkTables/Entry.h"
+#include "NetworkTables/InterfaceConstants.h"
+#include <vxWorks.h>
+#include <string>
+
+class NetworkTable;
+
+namespace NetworkTables
+{
+
+class Buffer;
+class FreeList;
+
+/**
+ * A fixed-layout structure sent as one value.
+ * Records go out as strings of raw bytes, so they are limited to the longest
+ * string that can be sent with a one byte length.
+ */
+class RecordEntry : public Entry {
+public:
+	static const UINT32 kMaxSize = kNetworkTables_BEGIN_STRING - 1;
+
+	RecordEntry(const void *record, UINT32 size);
+	static void *operator new(size_t size);
+	static void operator delete(void *block, size_t size);
+	virtual NetworkTables_Types GetType();
+	virtual void Encode(Buffer *buffer);
+	virtual int GetString(char *str, int len);
+	virtual std::string GetString();
+	virtual bool Equals(Entry *other);
+	UINT32 GetSize() {return m_size;}
+
+private:
+	UINT8 m_value[kMaxSize];
+	UINT32 m_size;
+
+	static FreeList _freeList;
+};
+
+} // namespace
+
+#endif
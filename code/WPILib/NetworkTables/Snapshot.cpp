@@ -0,0 +1,68 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "NetworkTables/Snapshot.h"
+#include "NetworkTables/Buffer.h"
+#include "NetworkTables/Entry.h"
+
+namespace NetworkTables
+{
+
+const UINT32 Snapshot::kInitialSize;
+
+Snapshot::Snapshot() :
+	m_buffer(NULL)
+{
+	m_buffer = new Buffer(kInitialSize);
+}
+
+Snapshot::~Snapshot()
+{
+	delete m_buffer;
+}
+
+/**
+ * Encode the data at the end of the snapshot, growing it as needed.
+ * @param data the assignment or entry to add
+ */
+void Snapshot::Add(Data *data)
+{
+	UINT32 mark = m_buffer->GetSize();
+	data->Encode(m_buffer);
+	while (m_buffer->IsOverflowed())
+	{
+		m_buffer->Rewind(mark);
+		m_buffer->Reserve(m_buffer->GetCapacity() * 2);
+		data->Encode(m_buffer);
+	}
+	if (data->IsEntry())
+		m_keys.push_back(((Entry *)data)->GetKey());
+}
+
+/**
+ * Copy the snapshot into a buffer.  Snapshots are normally sent with Flush()
+ * instead, since they rarely fit in a connection's write buffer.
+ */
+void Snapshot::Encode(Buffer *buffer)
+{
+	buffer->WriteBytes(m_buffer->GetSize(), m_buffer->GetData());
+}
+
+/**
+ * Write the whole snapshot to the socket.
+ * @return false if the write failed
+ */
+bool Snapshot::Flush(int socket)
+{
+	return m_buffer->Flush(socket);
+}
+
+bool Snapshot::IsEmpty()
+{
+	return m_buffer->GetSize() == 0;
+}
+
+} // namespace
@@ -0,0 +1,48 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2011. All Rights Reserved.                             */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "NetworkTables/Data.h"
+#include <vxWorks.h>
+#include <vector>
+
+namespace NetworkTables
+{
+
+class Buffer;
+class Key;
+
+/**
+ * The complete contents of one or more tables, encoded up front so a new
+ * connection can be brought up to date with a single write.
+ */
+class Snapshot : public Data
+{
+public:
+	typedef std::vector<Key *> KeyList_t;
+
+	static const UINT32 kInitialSize = 2048;
+
+	Snapshot();
+	virtual ~Snapshot();
+	void Add(Data *data);
+	virtual void Encode(Buffer *buffer);
+	virtual bool IsSnapshot() {return true;}
+	bool Flush(int socket);
+	bool IsEmpty();
+	/** The keys of the entries in the snapshot, in the order they will be confirmed */
+	const KeyList_t &GetKeys() {return m_keys;}
+
+private:
+	Buffer *m_buffer;
+	KeyList_t m_keys;
+};
+
+} // namespace
+
+#endif // __SNAPSHOT_H__
@@ -37,4 +37,9 @@ std::string StringEntry::GetString()
 	return m_value;
 }
 
+bool StringEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((StringEntry *)other)->m_value == m_value;
+}
+
 } // namespace
@@ -27,6 +27,7 @@ public:
 	virtual void Encode(Buffer *buffer);
 	virtual int GetString(char *str, int len);
 	virtual std::string GetString();
+	virtual bool Equals(Entry *other);
 
 private:
 	std::string m_value;
@@ -32,4 +32,9 @@ NetworkTable *TableEntry::GetTable()
 	return m_value;
 }
 
+bool TableEntry::Equals(Entry *other)
+{
+	return other->GetType() == GetType() && ((TableEntry *)other)->m_value == m_value;
+}
+
 } // namespace
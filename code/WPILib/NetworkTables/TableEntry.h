@@ -23,6 +23,7 @@ public:
 	virtual NetworkTables_Types GetType();
 	virtual void Encode(Buffer *buffer);
 	virtual NetworkTable *GetTable();
+	virtual bool Equals(Entry *other);
 
 private:
 	NetworkTable *m_value;
@@ -6,6 +6,7 @@
 
 #include "PWM.h"
 
+#include "ControlLatency.h"
 #include "DigitalModule.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "Resource.h"
@@ -293,6 +294,7 @@ float PWM::GetSpeed()
 void PWM::SetRaw(UINT8 value)
 {
 	if (StatusIsFatal()) return;
+	ControlLatency::MarkOutput();
 	m_module->SetPWM(m_channel, value);
 }
 
@@ -6,6 +6,7 @@
 
 #include "Relay.h"
 
+#include "ControlLatency.h"
 #include "DigitalModule.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "Resource.h"
@@ -128,6 +129,7 @@ Relay::~Relay()
 void Relay::Set(Relay::Value value)
 {
 	if (StatusIsFatal()) return;
+	ControlLatency::MarkOutput();
 	switch (value)
 	{
 	case kOff:
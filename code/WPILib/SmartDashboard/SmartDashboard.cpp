@@ -213,6 +213,83 @@ void SmartDashboard::PutString(std::string keyName, std::string value)
 	m_table->PutString(keyName, value);
 }
 
+/**
+ * Maps the specified key to a copy of a fixed-layout structure.
+ * Related values that change together are much cheaper to send as one record.
+ * @param keyName the key
+ * @param record the structure
+ * @param size the size of the structure
+ */
+void SmartDashboard::PutRecord(const char *keyName, const void *record, int size)
+{
+	m_table->PutRecord(keyName, record, size);
+}
+
+/**
+ * Copies the record at the specified key.
+ * @param keyName the key
+ * @param record the structure to fill in
+ * @param size the size of the structure
+ * @return the number of bytes copied
+ */
+int SmartDashboard::GetRecord(const char *keyName, void *record, int size)
+{
+	return m_table->GetRecord(keyName, record, size);
+}
+
+/**
+ * Resolves a key name into a handle for the Put methods that take one.
+ * Values updated every loop should be put through a handle resolved once
+ * at startup so the table is not searched by name on every update.
+ * @param keyName the key
+ * @return the handle for the key
+ */
+NetworkTables::Key *SmartDashboard::GetKeyHandle(const char *keyName)
+{
+	return m_table->GetKeyHandle(keyName);
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void SmartDashboard::PutBoolean(NetworkTables::Key *key, bool value)
+{
+	m_table->PutBoolean(key, value);
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void SmartDashboard::PutInt(NetworkTables::Key *key, int value)
+{
+	m_table->PutInt(key, value);
+}
+
+/**
+ * Maps the specified key to the specified value in this table.
+ * @param key the key handle from GetKeyHandle()
+ * @param value the value
+ */
+void SmartDashboard::PutDouble(NetworkTables::Key *key, double value)
+{
+	m_table->PutDouble(key, value);
+}
+
+/**
+ * Maps the specified key to a copy of a fixed-layout structure.
+ * @param key the key handle from GetKeyHandle()
+ * @param record the structure
+ * @param size the size of the structure
+ */
+void SmartDashboard::PutRecord(NetworkTables::Key *key, const void *record, int size)
+{
+	m_table->PutRecord(key, record, size);
+}
+
 /**
  * Returns the value at the specified key.
  * @param keyName the key
@@ -12,6 +12,10 @@
 #include <string>
 
 class NetworkTable;
+namespace NetworkTables
+{
+	class Key;
+}
 class SmartDashboardData;
 class SmartDashboardNamedData;
 
@@ -33,6 +37,13 @@ public:
 	int GetString(const char *keyName, char *value, int valueLen);
 	std::string GetString(std::string keyName);
 	void PutString(std::string keyName, std::string value);
+	void PutRecord(const char *keyName, const void *record, int size);
+	int GetRecord(const char *keyName, void *record, int size);
+	NetworkTables::Key *GetKeyHandle(const char *keyName);
+	void PutBoolean(NetworkTables::Key *key, bool value);
+	void PutInt(NetworkTables::Key *key, int value);
+	void PutDouble(NetworkTables::Key *key, double value);
+	void PutRecord(NetworkTables::Key *key, const void *record, int size);
 
 	void init();
 	static int LogChar(char value, const char *name);
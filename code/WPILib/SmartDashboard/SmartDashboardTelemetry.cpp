@@ -0,0 +1,170 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "SmartDashboard/SmartDashboardTelemetry.h"
+
+#include "SmartDashboard/SmartDashboard.h"
+#include "Utility.h"
+#include "WPIErrors.h"
+
+const SmartDashboardTelemetry::Channel SmartDashboardTelemetry::kInvalidChannel;
+const UINT32 SmartDashboardTelemetry::kMaxChannels;
+const UINT32 SmartDashboardTelemetry::kChannelsPerFrame;
+const UINT32 SmartDashboardTelemetry::kFrameHeaderSize;
+const UINT32 SmartDashboardTelemetry::kMaxFrames;
+
+/**
+ * Create a telemetry stream.
+ * @param name The SmartDashboard key the first frame is sent under.
+ * @param period The least time in seconds between frames.
+ */
+SmartDashboardTelemetry::SmartDashboardTelemetry(const char *name, double period)
+	: m_name (name)
+	, m_schemaName (name)
+	, m_schemaChanged (false)
+	, m_numChannels (0)
+	, m_period (0)
+	, m_nextPublish (0)
+	, m_frameNumber (0)
+{
+	m_schemaName += "Schema";
+	memset(m_frameKeys, 0, sizeof(m_frameKeys));
+	memset(m_values, 0, sizeof(m_values));
+	memset(m_changed, 0, sizeof(m_changed));
+	SetPeriod(period);
+	m_nextPublish = GetFPGATime();
+}
+
+SmartDashboardTelemetry::~SmartDashboardTelemetry()
+{
+}
+
+/**
+ * Register a channel that holds a double.
+ * The value is sent as a float.
+ * @param channelName The name the dashboard shows for the channel.
+ * @return The channel to set, or kInvalidChannel if there is no room for it.
+ */
+SmartDashboardTelemetry::Channel SmartDashboardTelemetry::AddDouble(const char *channelName)
+{
+	return AddChannel(channelName, 'd');
+}
+
+/**
+ * Register a channel that holds an int.
+ * @param channelName The name the dashboard shows for the channel.
+ * @return The channel to set, or kInvalidChannel if there is no room for it.
+ */
+SmartDashboardTelemetry::Channel SmartDashboardTelemetry::AddInt(const char *channelName)
+{
+	return AddChannel(channelName, 'i');
+}
+
+/**
+ * Set the least time between frames.
+ * @param period The time in seconds.
+ */
+void SmartDashboardTelemetry::SetPeriod(double period)
+{
+	if (period < 0.0)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "period must not be negative");
+		return;
+	}
+	m_period = (UINT32)(period * 1e6);
+}
+
+/**
+ * Send the frames holding channels that changed if the period has elapsed.
+ * Call this once per loop after setting the channels.
+ * @return True if a frame was sent.
+ */
+bool SmartDashboardTelemetry::Publish()
+{
+	UINT32 now = GetFPGATime();
+	// The FPGA time wraps every 71 minutes, so compare the difference
+	if ((INT32)(now - m_nextPublish) < 0)
+		return false;
+	m_nextPublish = now + m_period;
+
+	SmartDashboard *smartDashboard = SmartDashboard::GetInstance();
+	if (m_schemaChanged)
+	{
+		smartDashboard->PutString(m_schemaName.c_str(), m_schema.c_str());
+		m_schemaChanged = false;
+	}
+
+	bool sent = false;
+	for (UINT32 index = 0; index * kChannelsPerFrame < m_numChannels; index++)
+	{
+		if (!m_changed[index])
+			continue;
+		m_changed[index] = false;
+		if (!sent)
+		{
+			m_frameNumber++;
+			sent = true;
+		}
+
+		// Every frame holds all of its channels, so it stands on its own
+		UINT8 frame[kFrameHeaderSize + kChannelsPerFrame * sizeof(UINT32)];
+		UINT32 first = index * kChannelsPerFrame;
+		UINT32 count = m_numChannels - first;
+		if (count > kChannelsPerFrame)
+			count = kChannelsPerFrame;
+		UINT32 size = 0;
+		frame[size++] = (UINT8)(m_frameNumber >> 8);
+		frame[size++] = (UINT8)m_frameNumber;
+		frame[size++] = (UINT8)first;
+		frame[size++] = (UINT8)count;
+		for (UINT32 channel = first; channel < first + count; channel++)
+		{
+			UINT32 bits = m_values[channel];
+			frame[size++] = (UINT8)(bits >> 24);
+			frame[size++] = (UINT8)(bits >> 16);
+			frame[size++] = (UINT8)(bits >> 8);
+			frame[size++] = (UINT8)bits;
+		}
+		smartDashboard->PutRecord(m_frameKeys[index], frame, size);
+	}
+	return sent;
+}
+
+/**
+ * Register a channel and add it to the schema.
+ */
+SmartDashboardTelemetry::Channel SmartDashboardTelemetry::AddChannel(const char *channelName, char type)
+{
+	if (channelName == NULL)
+	{
+		wpi_setWPIError(NullParameter);
+		return kInvalidChannel;
+	}
+	if (m_numChannels >= kMaxChannels)
+	{
+		wpi_setWPIErrorWithContext(NoAvailableResources, "too many telemetry channels");
+		return kInvalidChannel;
+	}
+
+	m_schema += channelName;
+	m_schema += ':';
+	m_schema += type;
+	m_schema += '\n';
+	m_schemaChanged = true;
+
+	Channel channel = m_numChannels++;
+	UINT32 index = channel / kChannelsPerFrame;
+	if (m_frameKeys[index] == NULL)
+	{
+		std::string frameName = m_name;
+		if (index > 0)
+			frameName += (char)('0' + index);
+		m_frameKeys[index] = SmartDashboard::GetInstance()->GetKeyHandle(frameName.c_str());
+	}
+	// Send the initial value with the next frame
+	m_changed[index] = true;
+	return channel;
+}
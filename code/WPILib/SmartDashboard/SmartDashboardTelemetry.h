@@ -0,0 +1,96 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __SMART_DASHBOARD_TELEMETRY_H__
+#define __SMART_DASHBOARD_TELEMETRY_H__
+
+#include "ErrorBase.h"
+#include <string.h>
+#include <string>
+#include <vxWorks.h>
+
+namespace NetworkTables
+{
+	class Key;
+}
+
+/**
+ * Stream a fixed set of numeric values to the SmartDashboard in packed frames.
+ *
+ * Channels are registered once and then set every loop.  Setting a channel only
+ * stores the value and marks its frame changed.  The channels are split into
+ * fixed frames of kChannelsPerFrame channels, each sent as one record under its
+ * own key: the telemetry name for the first frame and the name followed by the
+ * frame index for the others.  Publish() runs at most once per period and sends
+ * every frame holding a channel that changed.  A frame always carries all of its
+ * channels, so a frame that replaces an unsent one, or a dashboard that connects
+ * late, loses nothing.
+ *
+ * The channel names are published once as a string under the telemetry name
+ * followed by "Schema": one "name:type" line per channel in channel order, where
+ * type is 'd' for a double (sent as a float) or 'i' for an int.
+ *
+ * A frame is a UINT16 frame number, shared by the frames sent by one Publish(),
+ * a UINT8 first channel number and a UINT8 channel count, and then the 4 byte
+ * value of each channel in order, all big-endian.
+ *
+ * Set and publish the channels from the same task.
+ */
+class SmartDashboardTelemetry : public ErrorBase
+{
+public:
+	typedef INT32 Channel;
+	static const Channel kInvalidChannel = -1;
+	static const UINT32 kMaxChannels = 128;
+	/** As many channels as fit in a NetworkTables record */
+	static const UINT32 kChannelsPerFrame = 62;
+
+	explicit SmartDashboardTelemetry(const char *name, double period = 0.1);
+	virtual ~SmartDashboardTelemetry();
+
+	Channel AddDouble(const char *channelName);
+	Channel AddInt(const char *channelName);
+	void SetPeriod(double period);
+
+	void SetDouble(Channel channel, double value)
+		{ float f = (float)value; UINT32 bits; memcpy(&bits, &f, sizeof(bits)); Store(channel, bits); }
+	void SetInt(Channel channel, INT32 value) { Store(channel, (UINT32)value); }
+
+	bool Publish();
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(SmartDashboardTelemetry);
+
+	static const UINT32 kFrameHeaderSize = sizeof(UINT16) + 2 * sizeof(UINT8);
+	static const UINT32 kMaxFrames = (kMaxChannels + kChannelsPerFrame - 1) / kChannelsPerFrame;
+
+	/**
+	 * Store a value and mark its frame changed if it is different.
+	 */
+	void Store(Channel channel, UINT32 bits)
+	{
+		if ((UINT32)channel < m_numChannels && m_values[channel] != bits)
+		{
+			m_values[channel] = bits;
+			m_changed[channel / kChannelsPerFrame] = true;
+		}
+	}
+	Channel AddChannel(const char *channelName, char type);
+
+	std::string m_name;
+	std::string m_schemaName;
+	std::string m_schema;
+	bool m_schemaChanged;
+	NetworkTables::Key *m_frameKeys[kMaxFrames];
+	UINT32 m_values[kMaxChannels];
+	bool m_changed[kMaxFrames];
+	UINT32 m_numChannels;
+	UINT32 m_period;
+	UINT32 m_nextPublish;
+	UINT16 m_frameNumber;
+};
+
+#endif
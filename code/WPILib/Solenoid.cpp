@@ -5,6 +5,7 @@
 /*----------------------------------------------------------------------------*/
 
 #include "Solenoid.h"
+#include "ControlLatency.h"
 #include "NetworkCommunication/UsageReporting.h"
 #include "WPIErrors.h"
 
@@ -82,6 +83,7 @@ Solenoid::~Solenoid()
 void Solenoid::Set(bool on)
 {
 	if (StatusIsFatal()) return;
+	ControlLatency::MarkOutput();
 	UINT8 value = on ? 0xFF : 0x00;
 	UINT8 mask = 1 << (m_channel - 1);
 
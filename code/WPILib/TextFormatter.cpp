@@ -0,0 +1,176 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#include "TextFormatter.h"
+
+const INT32 TextFormatter::kMaxDecimals;
+
+static const UINT32 kDecimalScale[TextFormatter::kMaxDecimals + 1] =
+	{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/**
+ * TextFormatter constructor.
+ * @param buffer The buffer to write the text into.
+ * @param size The size of the buffer in bytes.
+ */
+TextFormatter::TextFormatter(char *buffer, INT32 size)
+	: m_buffer (buffer)
+	, m_size (size)
+	, m_length (0)
+{
+	if (buffer == NULL || size < 0)
+		m_size = 0;
+}
+
+/**
+ * Append a string.
+ * @param text The NULL terminated string to append.
+ */
+TextFormatter &TextFormatter::Str(const char *text)
+{
+	if (text != NULL)
+	{
+		while (*text != '\0' && m_length < m_size)
+			m_buffer[m_length++] = *text++;
+	}
+	return *this;
+}
+
+/**
+ * Append a single character.
+ * @param c The character to append.
+ */
+TextFormatter &TextFormatter::Char(char c)
+{
+	Put(c);
+	return *this;
+}
+
+/**
+ * Append a signed decimal integer.
+ * @param value The value to append.
+ * @param width The minimum number of characters, including the sign.
+ * @param zeroPad Pad with zeros after the sign instead of spaces before it.
+ */
+TextFormatter &TextFormatter::Int(INT32 value, INT32 width, bool zeroPad)
+{
+	char digits[10];
+	char *end = digits + sizeof(digits);
+	char *p = end;
+	bool negative = value < 0;
+	// Negate as unsigned so the most negative value still works
+	UINT32 magnitude = negative ? 0 - (UINT32)value : (UINT32)value;
+
+	do
+	{
+		*--p = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude != 0);
+
+	PutField(p, end - p, negative, width, zeroPad);
+	return *this;
+}
+
+/**
+ * Append an unsigned integer as lower case hex digits padded with zeros.
+ * @param value The value to append.
+ * @param width The minimum number of digits.
+ */
+TextFormatter &TextFormatter::Hex(UINT32 value, INT32 width)
+{
+	static const char kHexDigits[] = "0123456789abcdef";
+	char digits[8];
+	char *end = digits + sizeof(digits);
+	char *p = end;
+
+	do
+	{
+		*--p = kHexDigits[value & 0xF];
+		value >>= 4;
+	} while (value != 0);
+
+	PutField(p, end - p, false, width, true);
+	return *this;
+}
+
+/**
+ * Append a number with a fixed number of decimal places.
+ *
+ * The value is scaled to an integer and rounded half away from zero, so the
+ * last digit can differ from printf for values that are exactly half way.
+ * Values that do not fit in 32 bits once scaled, and NaN, are shown as a field
+ * of '*' characters.
+ * @param value The value to append.
+ * @param width The minimum number of characters, including the sign and decimal point.
+ * @param decimals The number of digits after the decimal point, up to kMaxDecimals.
+ */
+TextFormatter &TextFormatter::Fixed(double value, INT32 width, INT32 decimals)
+{
+	char digits[24];
+	char *end = digits + sizeof(digits);
+	char *p = end;
+
+	if (decimals < 0)
+		decimals = 0;
+	else if (decimals > kMaxDecimals)
+		decimals = kMaxDecimals;
+
+	bool negative = value < 0.0;
+	double scaled = (negative ? -value : value) * kDecimalScale[decimals] + 0.5;
+	// NaN fails every comparison, so it is caught here too
+	if (!(scaled < 4294967296.0))
+	{
+		for (INT32 count = width > 0 ? width : 1; count > 0; count--)
+			Put('*');
+		return *this;
+	}
+
+	UINT32 magnitude = (UINT32)scaled;
+	UINT32 whole = magnitude / kDecimalScale[decimals];
+	UINT32 fraction = magnitude - whole * kDecimalScale[decimals];
+	if (decimals > 0)
+	{
+		for (INT32 i = 0; i < decimals; i++)
+		{
+			*--p = '0' + fraction % 10;
+			fraction /= 10;
+		}
+		*--p = '.';
+	}
+	do
+	{
+		*--p = '0' + whole % 10;
+		whole /= 10;
+	} while (whole != 0);
+
+	PutField(p, end - p, negative, width, false);
+	return *this;
+}
+
+/**
+ * Append formatted digits with their sign and padding.
+ * @param text The digits to append.
+ * @param length The number of digits.
+ * @param negative Put a minus sign before the digits.
+ * @param width The minimum number of characters, including the sign.
+ * @param zeroPad Pad with zeros after the sign instead of spaces before it.
+ */
+void TextFormatter::PutField(const char *text, INT32 length, bool negative, INT32 width, bool zeroPad)
+{
+	INT32 pad = width - length - (negative ? 1 : 0);
+
+	if (!zeroPad)
+	{
+		for (; pad > 0; pad--)
+			Put(' ');
+	}
+	if (negative)
+		Put('-');
+	for (; pad > 0; pad--)
+		Put('0');
+	for (INT32 i = 0; i < length; i++)
+		Put(text[i]);
+}
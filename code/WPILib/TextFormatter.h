@@ -0,0 +1,50 @@
+/*----------------------------------------------------------------------------*/
+/* Copyright (c) FIRST 2012. All Rights Reserved.							  */
+/* Open Source Software - may be modified and shared by FRC teams. The code   */
+/* must be accompanied by the FIRST BSD license file in $(WIND_BASE)/WPILib.  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef __TEXT_FORMATTER_H__
+#define __TEXT_FORMATTER_H__
+
+#include <vxWorks.h>
+
+/**
+ * Format short status text without printf.
+ *
+ * Each method appends one value to a caller supplied buffer and returns the
+ * formatter so the calls can be chained.  The value types are known at compile
+ * time, so there is no format string to parse, no varargs and no locale lookup.
+ * Text that does not fit in the buffer is dropped.  The buffer is not NULL
+ * terminated; use GetLength() to find the end of the text.
+ *
+ * The widths follow printf: Int(x, 3) is "%3d", Hex(x, 8) is "%08x" and
+ * Fixed(x, 7, 3) is "%7.3f".
+ */
+class TextFormatter
+{
+public:
+	static const INT32 kMaxDecimals = 9;
+
+	TextFormatter(char *buffer, INT32 size);
+
+	TextFormatter &Str(const char *text);
+	TextFormatter &Char(char c);
+	TextFormatter &Int(INT32 value, INT32 width = 0, bool zeroPad = false);
+	TextFormatter &Hex(UINT32 value, INT32 width = 0);
+	TextFormatter &Fixed(double value, INT32 width, INT32 decimals);
+
+	const char *GetText() const { return m_buffer; }
+	INT32 GetLength() const { return m_length; }
+	void Reset() { m_length = 0; }
+
+private:
+	void Put(char c) { if (m_length < m_size) m_buffer[m_length++] = c; }
+	void PutField(const char *text, INT32 length, bool negative, INT32 width, bool zeroPad);
+
+	char *m_buffer;
+	INT32 m_size;
+	INT32 m_length;
+};
+
+#endif
@@ -7,8 +7,11 @@
 #include "Vision/AxisCamera.h"
 
 #include <string.h>
+#include <selectLib.h>
 #include "NetworkCommunication/UsageReporting.h"
 #include "Synchronized.h"
+#include "Timer.h"
+#include "Utility.h"
 #include "Vision/PCVideoServer.h"
 #include "WPIErrors.h"
 
@@ -18,24 +21,43 @@ IMAQ_FUNC int Priv_ReadJPEGString_C(Image* _image, const unsigned char* _string,
 // Max packet without jumbo frames is 1500... add 36 because??
 #define kMaxPacketSize 1536
 #define kImageBufferAllocationIncrement 1000
+// Time allowed to receive one frame, in microseconds, on top of two frame periods at the max FPS
+#define kFrameTimeout 1000000
+// Delay between attempts to reconnect to the camera, in seconds; doubled after each failure
+#define kMinReconnectDelay 0.1
+#define kMaxReconnectDelay 2.0
 
 AxisCamera *AxisCamera::_instance = NULL;
 
 /**
  * AxisCamera constructor
  */
-AxisCamera::AxisCamera(const char *ipAddress)
-	: AxisCameraParams(ipAddress)
+AxisCamera::AxisCamera(const char *ipAddress, UINT16 port)
+	: AxisCameraParams(ipAddress, port)
 	, m_cameraSocket(ERROR)
-	, m_protectedImageBuffer(NULL)
-	, m_protectedImageBufferLength(0)
-	, m_protectedImageSize(0)
-	, m_protectedImageSem(NULL)
+	, m_receiveHead(0)
+	, m_receiveTail(0)
+	, m_stallCount(0)
+	, m_reconnectCount(0)
+	, m_latestFrame(-1)
+	, m_fillFrame(-1)
+	, m_frameNumber(0)
+	, m_droppedFrames(0)
+	, m_frameBufferSem(NULL)
 	, m_freshImage(false)
 	, m_imageStreamTask("cameraTask", (FUNCPTR)s_ImageStreamTaskFunction)
 	, m_videoServer(NULL)
 {
-	m_protectedImageSem = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
+	for (int i = 0; i < kNumFrameBuffers; i++)
+	{
+		m_frameBuffers[i].data = NULL;
+		m_frameBuffers[i].bufferLength = 0;
+		m_frameBuffers[i].size = 0;
+		m_frameBuffers[i].pinCount = 0;
+		m_frameBuffers[i].frameNumber = 0;
+		m_frameBuffers[i].frameTime = 0;
+	}
+	m_frameBufferSem = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE | SEM_DELETE_SAFE);
 
 #if JAVA_CAMERA_LIB != 1
 	nUsageReporting::report(nUsageReporting::kResourceType_AxisCamera, ipAddress == NULL ? 1 : 2);
@@ -64,19 +86,26 @@ AxisCamera::~AxisCamera()
 	}
 	m_newImageSemSet.clear();
 
-	semDelete(m_protectedImageSem);
+	for (int i = 0; i < kNumFrameBuffers; i++)
+	{
+		delete [] m_frameBuffers[i].data;
+		m_frameBuffers[i].data = NULL;
+	}
+	semDelete(m_frameBufferSem);
 }
 
 /**
  * Get a pointer to the AxisCamera object, if the object does not exist, create it
  * To use the camera on port 2 of a cRIO-FRC, pass "192.168.0.90" to the first GetInstance call.
+ * @param cameraIP The IP address of the camera, or NULL for the team's default address.
+ * @param cameraPort The HTTP port of the camera, e.g. to reach it through a relay.
  * @return reference to AxisCamera object
  */
-AxisCamera &AxisCamera::GetInstance(const char *cameraIP)
+AxisCamera &AxisCamera::GetInstance(const char *cameraIP, UINT16 cameraPort)
 {
 	if (NULL == _instance)
 	{
-		_instance = new AxisCamera(cameraIP);
+		_instance = new AxisCamera(cameraIP, cameraPort);
 
 		_instance->m_videoServer = new PCVideoServer();
 	}
@@ -120,16 +149,21 @@ SEM_ID AxisCamera::GetNewImageSem()
 /**
  * Get an image from the camera and store it in the provided image.
  * @param image The imaq image to store the result in. This must be an HSL or RGB image
+ * @param frameNumber If not NULL, set to the sequence number of the image.
+ * @param frameTime If not NULL, set to the FPGA time in microseconds when the image was received.
  * This function is called by Java.
  * @return 1 upon success, zero on a failure
  */
-int AxisCamera::GetImage(Image* imaqImage)
+int AxisCamera::GetImage(Image* imaqImage, UINT32 *frameNumber, UINT32 *frameTime)
 {
-	if (m_protectedImageBuffer == NULL)
+	const char *imageData;
+	int imageSize;
+	int frameHandle = PinJPEG(&imageData, imageSize, frameNumber, frameTime);
+	if (frameHandle < 0)
 		return 0;
-	Synchronized sync(m_protectedImageSem);
-	Priv_ReadJPEGString_C(imaqImage,
-		(unsigned char*)m_protectedImageBuffer, m_protectedImageSize);
+	// Decode straight out of the pinned frame; the receive task keeps filling other buffers.
+	Priv_ReadJPEGString_C(imaqImage, (const unsigned char*)imageData, imageSize);
+	UnpinJPEG(frameHandle);
 	m_freshImage = false;
 	return 1;
 }
@@ -138,11 +172,13 @@ int AxisCamera::GetImage(Image* imaqImage)
 /**
  * Get an image from the camera and store it in the provided image.
  * @param image The image to store the result in. This must be an HSL or RGB image
+ * @param frameNumber If not NULL, set to the sequence number of the image.
+ * @param frameTime If not NULL, set to the FPGA time in microseconds when the image was received.
  * @return 1 upon success, zero on a failure
  */
-int AxisCamera::GetImage(ColorImage* image)
+int AxisCamera::GetImage(ColorImage* image, UINT32 *frameNumber, UINT32 *frameTime)
 {
-	return GetImage(image->GetImaqImage());
+	return GetImage(image->GetImaqImage(), frameNumber, frameTime);
 }
 
 /**
@@ -164,36 +200,119 @@ HSLImage* AxisCamera::GetImage()
  * This copies an image into an existing buffer rather than creating a new image
  * in memory. That way a new image is only allocated when the image being copied is
  * larger than the destination.
- * This method is called by the PCVideoServer class.
+ * Callers that only need to read the image should use PinJPEG() instead, which avoids the copy.
  * @param imageData The destination image.
  * @param numBytes The size of the destination image.
  * @return 0 if failed (no source image or no memory), 1 if success.
  */
 int AxisCamera::CopyJPEG(char **destImage, int &destImageSize, int &destImageBufferSize)
 {
-	Synchronized sync(m_protectedImageSem);
 	if (destImage == NULL)
+	{
 		wpi_setWPIErrorWithContext(NullParameter, "destImage must not be NULL");
+		return 0;
+	}
 
-	if (m_protectedImageBuffer == NULL || m_protectedImageSize <= 0)
+	const char *imageData;
+	int imageSize;
+	int frameHandle = PinJPEG(&imageData, imageSize);
+	if (frameHandle < 0)
 		return 0; // if no source image
 
-	if (destImageBufferSize < m_protectedImageSize) // if current destination buffer too small
+	int success = 1;
+	if (destImageBufferSize < imageSize) // if current destination buffer too small
 	{
 		if (*destImage != NULL) delete [] *destImage;
-		destImageBufferSize = m_protectedImageSize + kImageBufferAllocationIncrement;
+		destImageBufferSize = imageSize + kImageBufferAllocationIncrement;
 		*destImage = new char[destImageBufferSize];
-		if (*destImage == NULL) return 0;
+		if (*destImage == NULL)
+		{
+			destImageBufferSize = 0;
+			success = 0;
+		}
 	}
-	// copy this image into destination buffer
-	if (*destImage == NULL)
+	if (success)
 	{
-		wpi_setWPIErrorWithContext(NullParameter, "*destImage must not be NULL");
+		memcpy(*destImage, imageData, imageSize);
+		destImageSize = imageSize;
 	}
-	// TODO: Is this copy realy necessary... perhaps we can simply transmit while holding the protected buffer
-	memcpy(*destImage, m_protectedImageBuffer, m_protectedImageSize);
-	destImageSize = m_protectedImageSize;
-	return 1;
+	UnpinJPEG(frameHandle);
+	return success;
+}
+
+/**
+ * Pin the latest JPEG image received from the camera so that it can be read in place.
+ * The image stays valid and unchanged until UnpinJPEG() is called with the returned handle.
+ * The receive task never blocks on a pinned image; it fills one of the other frame buffers.
+ * Keep the image pinned only as long as necessary, otherwise new frames may be dropped.
+ * @param image Set to point to the JPEG data.
+ * @param imageSize Set to the size of the JPEG data in bytes.
+ * @param frameNumber If not NULL, set to the sequence number of the pinned frame.
+ * @param frameTime If not NULL, set to the FPGA time in microseconds when the frame was received.
+ * @return A handle to pass to UnpinJPEG(), or -1 if no image has been received yet.
+ */
+int AxisCamera::PinJPEG(const char **image, int &imageSize, UINT32 *frameNumber, UINT32 *frameTime)
+{
+	int frameHandle;
+	{
+		Synchronized sync(m_frameBufferSem);
+		frameHandle = m_latestFrame;
+		if (frameHandle < 0)
+			return -1;
+		m_frameBuffers[frameHandle].pinCount++;
+	}
+	*image = m_frameBuffers[frameHandle].data;
+	imageSize = m_frameBuffers[frameHandle].size;
+	if (frameNumber != NULL)
+		*frameNumber = m_frameBuffers[frameHandle].frameNumber;
+	if (frameTime != NULL)
+		*frameTime = m_frameBuffers[frameHandle].frameTime;
+	return frameHandle;
+}
+
+/**
+ * Release an image pinned by PinJPEG().
+ * @param frameHandle The handle returned by PinJPEG().
+ */
+void AxisCamera::UnpinJPEG(int frameHandle)
+{
+	if (frameHandle < 0 || frameHandle >= kNumFrameBuffers)
+	{
+		wpi_setWPIErrorWithContext(ParameterOutOfRange, "frameHandle");
+		return;
+	}
+	Synchronized sync(m_frameBufferSem);
+	m_frameBuffers[frameHandle].pinCount--;
+}
+
+/**
+ * Get the number of frames that were received but thrown away because all of the
+ * frame buffers were pinned by readers.
+ * @return The number of dropped frames.
+ */
+UINT32 AxisCamera::GetDroppedFrameCount()
+{
+	return m_droppedFrames;
+}
+
+/**
+ * Get the number of times the image stream stalled, i.e. a frame was not received
+ * before its deadline. The stream is reconnected after each stall.
+ * @return The number of stalls.
+ */
+UINT32 AxisCamera::GetStallCount()
+{
+	return m_stallCount;
+}
+
+/**
+ * Get the number of times the image stream was reconnected after it stalled,
+ * was closed by the camera or failed to connect.
+ * @return The number of reconnects.
+ */
+UINT32 AxisCamera::GetReconnectCount()
+{
+	return m_reconnectCount;
 }
 
 /**
@@ -212,6 +331,7 @@ int AxisCamera::s_ImageStreamTaskFunction(AxisCamera *thisPtr)
  */
 int AxisCamera::ImageStreamTaskFunction()
 {
+	double reconnectDelay = kMinReconnectDelay;
 	// Loop on trying to setup the camera connection. This happens in a background
 	// thread so it shouldn't effect the operation of user programs.
 	while (1)
@@ -225,130 +345,306 @@ Authorization: Basic RlJDOkZSQw==\n\n";
 		m_cameraSocket = CreateCameraSocket(requestString);
 		if (m_cameraSocket == ERROR)
 		{
-			// Don't hammer the camera if it isn't ready.
 			semGive(m_socketPossessionSem);
-			taskDelay(1000);
 		}
 		else
 		{
-			ReadImagesFromCamera();
+			UINT32 firstFrameNumber = m_frameNumber;
+			if (ReadImagesFromCamera() != ERROR)
+			{
+				// The stream was closed to apply new parameters; reopen it right away.
+				reconnectDelay = kMinReconnectDelay;
+				continue;
+			}
+			if (m_frameNumber != firstFrameNumber)
+			{
+				// The stream was working before it failed, so start backing off from scratch.
+				reconnectDelay = kMinReconnectDelay;
+			}
+		}
+		// Don't hammer the camera if it isn't ready.
+		m_reconnectCount++;
+		Wait(reconnectDelay);
+		reconnectDelay *= 2.0;
+		if (reconnectDelay > kMaxReconnectDelay)
+		{
+			reconnectDelay = kMaxReconnectDelay;
 		}
 	}
 }
 
 /**
  * This function actually reads the images from the camera.
+ * Each image is received directly into a free frame buffer which is then published to the readers.
+ * Every read waits with select() against a per-frame deadline so that a camera that stops
+ * sending in the middle of a frame can't hang the task.
+ * The camera socket is closed and released before returning.
+ * @return 0 if the stream was closed to update the camera parameters, ERROR if it failed.
  */
 int AxisCamera::ReadImagesFromCamera()
 {
-	char *imgBuffer = NULL;
-	int imgBufferLength = 0;
 	//Infinite loop, task deletion handled by taskDeleteHook
 	// Socket cleanup handled by destructor
-
-	// TODO: these recv calls must be non-blocking. Otherwise if the camera
-	// fails during a read, the code hangs and never retries when the camera comes
-	// back up.
-
-	int counter = 2;
+	m_receiveHead = 0;
+	m_receiveTail = 0;
 	while (1)
 	{
-		char initialReadBuffer[kMaxPacketSize] = "";
-		char intermediateBuffer[1];
-		char *trailingPtr = initialReadBuffer;
-		int trailingCounter = 0;
-		while (counter)
+		UINT32 deadline = GetFPGATime() + kFrameTimeout;
+		int maxFPS = GetMaxFPS();
+		if (maxFPS > 0)
 		{
-			// TODO: fix me... this cannot be the most efficient way to approach this, reading one byte at a time.
-			if(recv(m_cameraSocket, intermediateBuffer, 1, 0) == ERROR)
-			{
-				wpi_setErrnoErrorWithContext("Failed to read image header");
-				close (m_cameraSocket);
-				return ERROR;
-			}
-			strncat(initialReadBuffer, intermediateBuffer, 1);
-			// trailingCounter ensures that we start looking for the 4 byte string after
-			// there is at least 4 bytes total. Kind of obscure.
-			// look for 2 blank lines (\r\n)
-			if (NULL != strstr(trailingPtr, "\r\n\r\n"))
-			{
-				--counter;
-			}
-			if (++trailingCounter >= 4)
-			{
-				trailingPtr++;
-			}
+			deadline += 2000000 / maxFPS;
 		}
-		counter = 1;
-		char *contentLength = strstr(initialReadBuffer, "Content-Length: ");
-		if (contentLength == NULL)
+
+		int readLength = ReadFrameHeader(deadline);
+		if (readLength == ERROR)
 		{
-			wpi_setWPIErrorWithContext(IncompatibleMode, "No content-length token found in packet");
-			close(m_cameraSocket);
+			CloseCameraSocket();
 			return ERROR;
 		}
-		contentLength = contentLength + 16; // skip past "content length"
-		int readLength = atol(contentLength); // get the image byte count
 
-		// Make sure buffer is large enough
-		if (imgBufferLength < readLength)
+		// Find a frame buffer that no reader is using. If they are all pinned,
+		// the image still has to be drained from the socket, so it is dropped.
+		int fillFrame = AcquireFillBuffer();
+		char *imgBuffer = NULL;
+		if (fillFrame >= 0)
 		{
-			if (imgBuffer) delete[] imgBuffer;
-			imgBufferLength = readLength + kImageBufferAllocationIncrement;
-			imgBuffer = new char[imgBufferLength];
-			if (imgBuffer == NULL)
+			FrameBuffer &frame = m_frameBuffers[fillFrame];
+			// Make sure buffer is large enough. The receive task owns the fill buffer,
+			// so no lock is needed to grow it.
+			if (frame.bufferLength < readLength)
 			{
-				imgBufferLength = 0;
-				continue;
+				if (frame.data) delete[] frame.data;
+				frame.bufferLength = readLength + kImageBufferAllocationIncrement;
+				frame.data = new char[frame.bufferLength];
+				if (frame.data == NULL)
+				{
+					frame.bufferLength = 0;
+				}
 			}
+			imgBuffer = frame.data;
 		}
 
-		// Read the image data for "Content-Length" bytes
-		int bytesRead = 0;
-		int remaining = readLength;
-		while(bytesRead < readLength)
+		if (ReadFrameBody(imgBuffer, readLength, deadline) == ERROR)
 		{
-			int bytesThisRecv = recv(m_cameraSocket, &imgBuffer[bytesRead], remaining, 0);
-			bytesRead += bytesThisRecv;
-			remaining -= bytesThisRecv;
+			CloseCameraSocket();
+			return ERROR;
 		}
 		// Update image
-		UpdatePublicImageFromCamera(imgBuffer, readLength);
+		if (imgBuffer != NULL)
+		{
+			PublishFillBuffer(readLength);
+		}
+		else
+		{
+			m_droppedFrames++;
+		}
 		if (semTake(m_paramChangedSem, NO_WAIT) == OK)
 		{
 			// params need to be updated: close the video stream; release the camera.
-			close(m_cameraSocket);
-			semGive(m_socketPossessionSem);
+			CloseCameraSocket();
 			return 0;
 		}
 	}
 }
 
 /**
- * Copy the image from private buffer to shared buffer.
- * @param imgBuffer The buffer containing the image
- * @param bufLength The length of the image
+ * Wait until the camera socket has data or the deadline passes, then receive what is available.
+ * A stall is counted if the deadline passes first.
+ * @param buffer The buffer to receive into.
+ * @param length The maximum number of bytes to receive.
+ * @param deadline The FPGA time in microseconds by which data must arrive.
+ * @return The number of bytes received, or ERROR on a stall, a socket error or if the camera closed the connection.
  */
-void AxisCamera::UpdatePublicImageFromCamera(char *imgBuffer, int imgSize)
+int AxisCamera::ReceiveWithDeadline(char *buffer, int length, UINT32 deadline)
 {
+	INT32 timeLeft = (INT32)(deadline - GetFPGATime());
+	if (timeLeft <= 0)
 	{
-		Synchronized sync(m_protectedImageSem);
+		m_stallCount++;
+		return ERROR;
+	}
 
-		// Adjust the buffer size if current destination buffer is too small.
-		if (m_protectedImageBufferLength < imgSize)
+	struct timeval timeout;
+	timeout.tv_sec = timeLeft / 1000000;
+	timeout.tv_usec = timeLeft % 1000000;
+	fd_set readFdSet;
+	FD_ZERO(&readFdSet);
+	FD_SET(m_cameraSocket, &readFdSet);
+	int ready = select(m_cameraSocket + 1, &readFdSet, NULL, NULL, &timeout);
+	if (ready == 0)
+	{
+		m_stallCount++;
+		return ERROR;
+	}
+	if (ready == ERROR)
+	{
+		wpi_setErrnoErrorWithContext("Failed to wait for the camera");
+		return ERROR;
+	}
+
+	int bytesThisRecv = recv(m_cameraSocket, buffer, length, 0);
+	if (bytesThisRecv == ERROR)
+	{
+		wpi_setErrnoErrorWithContext("Failed to read from the camera");
+		return ERROR;
+	}
+	if (bytesThisRecv == 0)
+	{
+		// The camera closed the connection.
+		return ERROR;
+	}
+	return bytesThisRecv;
+}
+
+/**
+ * Read the stream until the header of the next image part and return its length.
+ * Data is received in blocks; anything past the header is left in the receive buffer
+ * for ReadFrameBody(). Header blocks without a Content-Length, such as the HTTP
+ * response header in front of the first image, are skipped.
+ * @param deadline The FPGA time in microseconds by which the header must arrive.
+ * @return The image byte count, or ERROR if the stream failed.
+ */
+int AxisCamera::ReadFrameHeader(UINT32 deadline)
+{
+	char header[kMaxPacketSize];
+	int headerLength = 0;
+	while (1)
+	{
+		if (m_receiveHead == m_receiveTail)
+		{
+			int bytesThisRecv = ReceiveWithDeadline(m_receiveBuffer, kReceiveBufferSize, deadline);
+			if (bytesThisRecv == ERROR)
+			{
+				return ERROR;
+			}
+			m_receiveHead = 0;
+			m_receiveTail = bytesThisRecv;
+		}
+
+		while (m_receiveHead < m_receiveTail)
 		{
-			if (m_protectedImageBuffer != NULL) delete [] m_protectedImageBuffer;
-			m_protectedImageBufferLength = imgSize + kImageBufferAllocationIncrement;
-			m_protectedImageBuffer = new char[m_protectedImageBufferLength];
-			if (m_protectedImageBuffer == NULL)
+			if (headerLength >= kMaxPacketSize - 1)
 			{
-				m_protectedImageBufferLength = 0;
-				return;
+				wpi_setWPIErrorWithContext(IncompatibleMode, "Image header too long");
+				return ERROR;
+			}
+			header[headerLength++] = m_receiveBuffer[m_receiveHead++];
+			// look for 2 blank lines (\r\n)
+			if (headerLength >= 4 && memcmp(&header[headerLength - 4], "\r\n\r\n", 4) == 0)
+			{
+				header[headerLength] = '\0';
+				char *contentLength = strstr(header, "Content-Length: ");
+				if (contentLength != NULL)
+				{
+					contentLength = contentLength + 16; // skip past "content length"
+					int readLength = atol(contentLength); // get the image byte count
+					if (readLength <= 0)
+					{
+						wpi_setWPIErrorWithContext(IncompatibleMode, "Invalid content-length in packet");
+						return ERROR;
+					}
+					return readLength;
+				}
+				headerLength = 0;
 			}
 		}
+	}
+}
+
+/**
+ * Read the image data that follows a header.
+ * @param imgBuffer The buffer to read into, or NULL to drain and discard the image.
+ * @param readLength The image byte count from the header.
+ * @param deadline The FPGA time in microseconds by which the image must arrive.
+ * @return OK if the whole image was read, ERROR if the stream failed.
+ */
+int AxisCamera::ReadFrameBody(char *imgBuffer, int readLength, UINT32 deadline)
+{
+	// Start with whatever arrived together with the header.
+	int bytesRead = m_receiveTail - m_receiveHead;
+	if (bytesRead > readLength)
+	{
+		bytesRead = readLength;
+	}
+	if (imgBuffer != NULL)
+	{
+		memcpy(imgBuffer, &m_receiveBuffer[m_receiveHead], bytesRead);
+	}
+	m_receiveHead += bytesRead;
 
-		memcpy(m_protectedImageBuffer, imgBuffer, imgSize);
-		m_protectedImageSize = imgSize;
+	// Read the rest straight into the image buffer.
+	while (bytesRead < readLength)
+	{
+		int remaining = readLength - bytesRead;
+		int bytesThisRecv;
+		if (imgBuffer != NULL)
+		{
+			bytesThisRecv = ReceiveWithDeadline(&imgBuffer[bytesRead], remaining, deadline);
+		}
+		else
+		{
+			bytesThisRecv = ReceiveWithDeadline(m_receiveBuffer,
+				remaining < kReceiveBufferSize ? remaining : kReceiveBufferSize, deadline);
+		}
+		if (bytesThisRecv == ERROR)
+		{
+			return ERROR;
+		}
+		bytesRead += bytesThisRecv;
+	}
+	return OK;
+}
+
+/**
+ * Close the image stream and give the camera back to the parameter task.
+ */
+void AxisCamera::CloseCameraSocket()
+{
+	close(m_cameraSocket);
+	m_cameraSocket = ERROR;
+	semGive(m_socketPossessionSem);
+}
+
+/**
+ * Select the frame buffer the next image will be received into.
+ * The fill buffer is kept across images until it is published, so a buffer that
+ * was being filled when the stream was restarted is reused.
+ * @return The index of the fill buffer, or -1 if every other buffer is in use.
+ */
+int AxisCamera::AcquireFillBuffer()
+{
+	Synchronized sync(m_frameBufferSem);
+	if (m_fillFrame < 0)
+	{
+		for (int i = 0; i < kNumFrameBuffers; i++)
+		{
+			if (i != m_latestFrame && m_frameBuffers[i].pinCount == 0)
+			{
+				m_fillFrame = i;
+				break;
+			}
+		}
+	}
+	return m_fillFrame;
+}
+
+/**
+ * Publish the fill buffer as the latest image and notify the waiting readers.
+ * Only the buffer index is swapped under the lock; the image data is not copied.
+ * @param imgSize The length of the image
+ */
+void AxisCamera::PublishFillBuffer(int imgSize)
+{
+	UINT32 frameTime = GetFPGATime();
+	{
+		Synchronized sync(m_frameBufferSem);
+		FrameBuffer &frame = m_frameBuffers[m_fillFrame];
+		frame.size = imgSize;
+		frame.frameNumber = ++m_frameNumber;
+		frame.frameTime = frameTime;
+		m_latestFrame = m_fillFrame;
+		m_fillFrame = -1;
 	}
 
 	m_freshImage = true;
@@ -34,41 +34,79 @@ class PCVideoServer;
 class AxisCamera : public AxisCameraParams
 {
 private:
-	explicit AxisCamera(const char *cameraIP);
+	AxisCamera(const char *cameraIP, UINT16 cameraPort);
 public:
 	virtual ~AxisCamera();
-	static AxisCamera& GetInstance(const char *cameraIP = NULL);
+	static AxisCamera& GetInstance(const char *cameraIP = NULL, UINT16 cameraPort = kDefaultCameraPort);
 	static void DeleteInstance();
 
 	bool IsFreshImage();
 	SEM_ID GetNewImageSem();
 
-	int GetImage(Image *imaqImage);
+	int GetImage(Image *imaqImage, UINT32 *frameNumber = NULL, UINT32 *frameTime = NULL);
 #if JAVA_CAMERA_LIB != 1
-	int GetImage(ColorImage *image);
+	int GetImage(ColorImage *image, UINT32 *frameNumber = NULL, UINT32 *frameTime = NULL);
 	HSLImage *GetImage();
 #endif
 
 	int CopyJPEG(char **destImage, int &destImageSize, int &destImageBufferSize);
+	int PinJPEG(const char **image, int &imageSize, UINT32 *frameNumber = NULL, UINT32 *frameTime = NULL);
+	void UnpinJPEG(int frameHandle);
+	UINT32 GetDroppedFrameCount();
+	UINT32 GetStallCount();
+	UINT32 GetReconnectCount();
 
 private:
+	/** Number of frame buffers shared between the receive task and the readers */
+	static const int kNumFrameBuffers = 3;
+	/** Size of the buffer that stream data is received into before it is parsed */
+	static const int kReceiveBufferSize = 1536;
+
+	/**
+	 * A JPEG frame buffer.
+	 * A buffer is owned by the receive task while it is being filled. Once published,
+	 * readers pin it and use the data in place. It is only recycled when it is neither
+	 * the latest frame nor pinned by any reader.
+	 */
+	struct FrameBuffer
+	{
+		char *data;
+		int bufferLength;
+		int size;
+		int pinCount;
+		UINT32 frameNumber;
+		UINT32 frameTime;
+	};
+
 	static int s_ImageStreamTaskFunction(AxisCamera *thisPtr);
 	int ImageStreamTaskFunction();
 
 	int ReadImagesFromCamera();
-	void UpdatePublicImageFromCamera(char *imgBuffer, int imgSize);
+	int ReceiveWithDeadline(char *buffer, int length, UINT32 deadline);
+	int ReadFrameHeader(UINT32 deadline);
+	int ReadFrameBody(char *imgBuffer, int readLength, UINT32 deadline);
+	void CloseCameraSocket();
+	int AcquireFillBuffer();
+	void PublishFillBuffer(int imgSize);
 
 	virtual void RestartCameraTask();
 
 	static AxisCamera *_instance;
 	int m_cameraSocket;
+	char m_receiveBuffer[kReceiveBufferSize];
+	int m_receiveHead;
+	int m_receiveTail;
+	UINT32 m_stallCount;
+	UINT32 m_reconnectCount;
 	typedef std::set<SEM_ID> SemSet_t;
 	SemSet_t m_newImageSemSet;
 
-	char* m_protectedImageBuffer;
-	int m_protectedImageBufferLength;
-	int m_protectedImageSize;
-	SEM_ID m_protectedImageSem;
+	FrameBuffer m_frameBuffers[kNumFrameBuffers];
+	int m_latestFrame;
+	int m_fillFrame;
+	UINT32 m_frameNumber;
+	UINT32 m_droppedFrames;
+	SEM_ID m_frameBufferSem;
 	bool m_freshImage;
 
 	Task m_imageStreamTask;
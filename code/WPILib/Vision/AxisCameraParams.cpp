@@ -20,6 +20,8 @@
 #include "DriverStation.h"
 #endif
 
+const UINT16 AxisCameraParams::kDefaultCameraPort;
+
 static const char *const kRotationChoices[] = {"0", "180"};
 static const char *const kResolutionChoices[] = {"640x480", "640x360", "320x240", "160x120"};
 static const char *const kExposureControlChoices[] = { "automatic", "hold", "flickerfree50", "flickerfree60" };
@@ -29,8 +31,9 @@ static const char *const kWhiteBalanceChoices[] = { "auto", "holdwb", "fixed_out
 /**
  * AxisCamera constructor
  */
-AxisCameraParams::AxisCameraParams(const char* ipAddress)
+AxisCameraParams::AxisCameraParams(const char* ipAddress, UINT16 port)
 	: m_paramTask("paramTask", (FUNCPTR) s_ParamTaskFunction)
+	, m_port (port)
 	, m_paramChangedSem (NULL)
 	, m_socketPossessionSem (NULL)
 	, m_brightnessParam (NULL)
@@ -444,7 +447,7 @@ int AxisCameraParams::CreateCameraSocket(const char *requestString)
 	bzero((char *) &serverAddr, sockAddrSize);
 	serverAddr.sin_family = AF_INET;
 	serverAddr.sin_len = (u_char) sockAddrSize;
-	serverAddr.sin_port = htons(80);
+	serverAddr.sin_port = htons(m_port);
 
 	serverAddr.sin_addr.s_addr = m_ipAddress;
 
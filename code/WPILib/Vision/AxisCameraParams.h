@@ -28,8 +28,11 @@ public:
 	typedef enum Resolution_t {kResolution_640x480, kResolution_640x360, kResolution_320x240, kResolution_160x120};
 	typedef enum Rotation_t {kRotation_0, kRotation_180};
 
+	/** The HTTP port of the Axis camera */
+	static const UINT16 kDefaultCameraPort = 80;
+
 protected:
-	AxisCameraParams(const char* ipAddress);
+	AxisCameraParams(const char* ipAddress, UINT16 port);
 	virtual ~AxisCameraParams();
 
 public:
@@ -67,6 +70,7 @@ protected:
 
 	Task m_paramTask;
 	UINT32 m_ipAddress; // IPv4
+	UINT16 m_port;
 	SEM_ID m_paramChangedSem;
 	SEM_ID m_socketPossessionSem;
 
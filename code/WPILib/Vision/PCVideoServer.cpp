@@ -228,9 +228,9 @@ int PCVideoServer::ServerTask()
 		// Report usage when there is actually a connection.
 		nUsageReporting::report(nUsageReporting::kResourceType_PCVideoServer, 0);
 
+		AxisCamera &camera = AxisCamera::GetInstance();
 		int numBytes = 0;
-		int imageDataSize = 0;
-		char* imageData = NULL;
+		const char* imageData = NULL;
 
 		while(!m_stopServer)
 		{
@@ -240,8 +240,9 @@ int PCVideoServer::ServerTask()
 				// If the semTake timed out, there are no new images from the camera.
 				continue;
 			}
-			success = AxisCamera::GetInstance().CopyJPEG(&imageData, numBytes, imageDataSize);
-			if (!success)
+			// Send the image straight out of the camera's frame buffer instead of copying it.
+			int frameHandle = camera.PinJPEG(&imageData, numBytes);
+			if (frameHandle < 0)
 			{
 				// No point in running too fast -
 				Wait(1.0);
@@ -258,7 +259,9 @@ int PCVideoServer::ServerTask()
 			int lengthSend = write(newPCSock, reinterpret_cast<char*>(&numBytes), 4);
 
 			// Write image to PC
-			int sent = write (newPCSock, imageData, numBytes);
+			int sent = write (newPCSock, const_cast<char*>(imageData), numBytes);
+
+			camera.UnpinJPEG(frameHandle);
 
 			// The PC probably closed connection. Get out of here
 			// and try listening again.
@@ -268,7 +271,6 @@ int PCVideoServer::ServerTask()
 			}
 		}
 		// Clean up
-		delete [] imageData;
 		close (newPCSock);
 		newPCSock = ERROR;
 		close (pcSock);
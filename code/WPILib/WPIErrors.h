@@ -53,6 +53,7 @@ S(NetworkTablesWrongType, -42, "The wrong type was read from the NetworkTables e
 S(NetworkTablesCorrupt, -43, "NetworkTables data stream is corrupt");
 S(SmartDashboardMissingKey, -43, "SmartDashboard data does not exist");
 S(CommandIllegalUse, -50, "Illegal use of Command");
+S(FileWriteError, -51, "Unable to open the file for writing");
 
 /*
  * Warnings
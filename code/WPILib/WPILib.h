@@ -17,6 +17,7 @@
 #include "AnalogModule.h"
 #include "AnalogTrigger.h"
 #include "AnalogTriggerOutput.h"
+#include "Atomic.h"
 #include "Buttons/AnalogIOButton.h"
 #include "Buttons/DigitalIOButton.h"
 #include "Buttons/InternalButton.h"
@@ -35,8 +36,11 @@
 #include "Commands/WaitForChildren.h"
 #include "Commands/WaitUntilCommand.h"
 #include "Compressor.h"
+#include "ControlLatency.h"
 #include "Counter.h"
 #include "Dashboard.h"
+#include "DashboardSchema.h"
+#include "DashboardTelemetry.h"
 #include "DigitalInput.h"
 #include "DigitalModule.h"
 #include "DigitalOutput.h"
@@ -77,11 +81,13 @@
 #include "SmartDashboard/SendableGyro.h"
 #include "SmartDashboard/SendablePIDController.h"
 #include "SmartDashboard/SmartDashboard.h"
+#include "SmartDashboard/SmartDashboardTelemetry.h"
 #include "Solenoid.h"
 #include "SpeedController.h"
 #include "SPI.h"
 #include "Synchronized.h"
 #include "Task.h"
+#include "TextFormatter.h"
 #include "Timer.h"
 #include "Ultrasonic.h"
 #include "Utility.h"
@@ -0,0 +1,149 @@
+#if 0
+/// Copyright (c) Titan Robotics Club. All rights reserved.
+///
+/// <module name="BenchCmd.h" />
+///
+/// <summary>
+///     This module contains the definitions and implementation of the
+///     BenchCmd class.
+/// </summary>
+///
+/// <remarks>
+///     Environment: Wind River C++ for National Instrument cRIO based Robot.
+/// </remarks>
+#endif
+
+#ifndef _BENCHCMD_H
+#define _BENCHCMD_H
+
+#ifdef MOD_ID
+#undef MOD_ID
+#endif
+#define MOD_ID                  MOD_BENCH
+#ifdef MOD_NAME
+#undef MOD_NAME
+#endif
+#define MOD_NAME                "BenchCmd"
+
+#define CMDID_BENCH_RUN         (CMDACTION_NONE + 1)
+
+/**
+ * This abstract class implements the console command shared by the
+ * benchmarks. It registers a single "run" command under the name of the
+ * benchmark and hands the command arguments to the RunCmd function of the
+ * subclass. The usage is printed if RunCmd rejects the arguments. A
+ * benchmark is started from the console with:
+ *   <name>.run <usage>
+ */
+class BenchCmd: public CmdHandler
+{
+private:
+    CMD_ENTRY           m_cmdTable[2];
+    const char         *m_usage;
+
+protected:
+    /**
+     * This function is provided by the subclass to run the benchmark with
+     * the arguments of the run command.
+     *
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns ERR_INVALID_PARAM if the arguments are not
+     *         valid, other error code otherwise.
+     */
+    virtual
+    int
+    RunCmd(
+        char **apszArgs,
+        int    cArgs
+        ) = 0;
+
+public:
+    /**
+     * Constructor for the class object.
+     *
+     * @param benchName Specifies the name the command is registered under.
+     * @param usage Specifies the arguments of the run command.
+     * @param help Specifies the help text of the run command.
+     */
+    BenchCmd(
+        char       *benchName,
+        const char *usage,
+        const char *help
+        ): m_usage(usage)
+    {
+        TLevel(INIT);
+        TEnterMsg(("name=%s,usage=%s", benchName, usage));
+
+        m_cmdTable[0].cmdName = "run";
+        m_cmdTable[0].cmdAction = CMDID_BENCH_RUN;
+        m_cmdTable[0].cmdHelp = help;
+        m_cmdTable[1].cmdName = NULL;
+        m_cmdTable[1].cmdAction = CMDACTION_NONE;
+        m_cmdTable[1].cmdHelp = NULL;
+        RegisterCmdHandler(benchName, m_cmdTable, NULL);
+
+        TExit();
+    }   //BenchCmd
+
+    /**
+     * Destructor for the class object.
+     */
+    virtual
+    ~BenchCmd(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+        TExit();
+    }   //~BenchCmd
+
+    /**
+     * This function executes the console command.
+     *
+     * @param cmdEntry Points to the command table entry.
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    ExecuteCommand(
+        PCMD_ENTRY  cmdEntry,
+        char      **apszArgs,
+        int         cArgs
+        )
+    {
+        int rc = ERR_SUCCESS;
+
+        TLevel(CALLBK);
+        TEnterMsg(("cmd=%s,pArgs=%p,cArgs=%d",
+                   cmdEntry->cmdName, apszArgs, cArgs));
+
+        switch (cmdEntry->cmdAction)
+        {
+            case CMDID_BENCH_RUN:
+                rc = RunCmd(apszArgs, cArgs);
+                if (rc == ERR_INVALID_PARAM)
+                {
+                    printf("Usage: run %s\n", m_usage);
+                }
+                break;
+
+            default:
+                printf("Error: invalid command ID (cmd=%s,ID=%d).\n",
+                       cmdEntry->cmdName, cmdEntry->cmdAction);
+                rc = ERR_ASSERT;
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //ExecuteCommand
+
+};  //class BenchCmd
+
+#endif  //ifndef _BENCHCMD_H
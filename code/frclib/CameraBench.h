@@ -0,0 +1,1003 @@
+#if 0
+/// Copyright (c) Titan Robotics Club. All rights reserved.
+///
+/// <module name="CameraBench.h" />
+///
+/// <summary>
+///     This module contains the definitions and implementation of the
+///     CameraBench class.
+/// </summary>
+///
+/// <remarks>
+///     Environment: Wind River C++ for National Instrument cRIO based Robot.
+/// </remarks>
+#endif
+
+#ifndef _CAMERABENCH_H
+#define _CAMERABENCH_H
+
+#ifdef MOD_ID
+#undef MOD_ID
+#endif
+#define MOD_ID                  MOD_BENCH
+#ifdef MOD_NAME
+#undef MOD_NAME
+#endif
+#define MOD_NAME                "CameraBench"
+
+#define CB_RELAY_IP             "127.0.0.1"
+#define CB_RELAY_PORT           1180
+#define CB_CAMERA_PORT          80
+#define CB_MAX_PAIRS            4
+#define CB_BUFFER_SIZE          1536
+#define CB_POLL_PERIOD          100000  //usec between relay fault checks
+#define CB_CONNECT_TIMEOUT      1       //sec to connect to the camera
+#define CB_FAULT_TIME           3000000 //usec a stall or refusal lasts
+#define CB_FRAME_TIMEOUT        5000000 //usec to wait for a working stream
+#define CB_MAX_RECOVERY         5000000 //usec allowed to get a new frame
+#define CB_DEF_ITERATIONS       5
+
+//
+// Faults injected into the image stream.
+//
+#define CB_FAULT_NONE           0
+#define CB_FAULT_STALL          1       //stop sending in the middle of a frame
+#define CB_FAULT_HEADER         2       //stop sending in the middle of a header
+#define CB_FAULT_DROP           3       //close the stream in the middle of a frame
+#define CB_FAULT_REFUSE         4       //refuse connections for a while
+#define CB_NUM_FAULTS           5
+
+static const char *g_CameraBenchFaultNames[CB_NUM_FAULTS] =
+{
+    "none",
+    "stall",
+    "header",
+    "drop",
+    "refuse"
+};
+
+static
+void
+CameraRelayTask(
+    void *relay
+    );
+
+/**
+ * This class defines and implements the CameraRelay object. The object is a
+ * TCP relay on the loopback interface that stands between AxisCamera and the
+ * camera. It passes everything through unchanged until a fault is injected
+ * into the image stream, which is the connection that requests the MJPEG
+ * video. The parameter connections are never faulted, except that they are
+ * refused along with the stream.
+ */
+class CameraRelay
+{
+private:
+    typedef struct _RelayPair
+    {
+        int     clientSocket;
+        int     cameraSocket;
+        bool    fStream;
+        bool    fStalled;
+    } RELAYPAIR, *PRELAYPAIR;
+
+    UINT32              m_cameraAddr;
+    int                 m_listenSocket;
+    Task                m_task;
+    volatile bool       m_fRun;
+    RELAYPAIR           m_pairs[CB_MAX_PAIRS];
+    char                m_buffer[CB_BUFFER_SIZE];
+    volatile int        m_fault;
+    volatile bool       m_fInjected;
+    volatile UINT32     m_faultTime;
+    volatile UINT32     m_faultEndTime;
+
+    /**
+     * This function looks for text in a block of stream data.
+     *
+     * @param data Points to the data.
+     * @param length Specifies the length of the data.
+     * @param text Points to the text to look for.
+     *
+     * @return Returns the offset of the text, or -1 if not found.
+     */
+    int
+    FindText(
+        const char *data,
+        int         length,
+        const char *text
+        )
+    {
+        int offset = -1;
+        int textLength = strlen(text);
+
+        TLevel(UTIL);
+        TEnterMsg(("data=%p,len=%d,text=%s", data, length, text));
+
+        for (int i = 0; i + textLength <= length; i++)
+        {
+            if (memcmp(&data[i], text, textLength) == 0)
+            {
+                offset = i;
+                break;
+            }
+        }
+
+        TExitMsg(("=%d", offset));
+        return offset;
+    }   //FindText
+
+    /**
+     * This function sends all the data to a socket.
+     *
+     * @param sock Specifies the socket.
+     * @param data Points to the data.
+     * @param length Specifies the length of the data.
+     *
+     * @return Returns true if successful, false otherwise.
+     */
+    bool
+    SendAll(
+        int         sock,
+        const char *data,
+        int         length
+        )
+    {
+        bool fOk = true;
+
+        TLevel(UTIL);
+        TEnterMsg(("sock=%d,data=%p,len=%d", sock, data, length));
+
+        while (length > 0)
+        {
+            int sent = send(sock, (char *)data, length, 0);
+
+            if (sent <= 0)
+            {
+                fOk = false;
+                break;
+            }
+            data += sent;
+            length -= sent;
+        }
+
+        TExitMsg(("=%x", fOk));
+        return fOk;
+    }   //SendAll
+
+    /**
+     * This function opens the socket the relay accepts connections on.
+     */
+    void
+    OpenListenSocket(
+        void
+        )
+    {
+        struct sockaddr_in relayAddr;
+        int optval = 1;
+
+        TLevel(FUNC);
+        TEnter();
+
+        bzero((char *)&relayAddr, sizeof(relayAddr));
+        relayAddr.sin_len = (u_char)sizeof(relayAddr);
+        relayAddr.sin_family = AF_INET;
+        relayAddr.sin_port = htons(CB_RELAY_PORT);
+        relayAddr.sin_addr.s_addr = inet_addr(CB_RELAY_IP);
+
+        m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_listenSocket == ERROR)
+        {
+            TErr(("Failed to create the relay socket."));
+        }
+        else if ((setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR,
+                             (char *)&optval, sizeof(optval)) == ERROR) ||
+                 (bind(m_listenSocket, (struct sockaddr *)&relayAddr,
+                       sizeof(relayAddr)) == ERROR) ||
+                 (listen(m_listenSocket, CB_MAX_PAIRS) == ERROR))
+        {
+            TErr(("Failed to listen on the relay port."));
+            close(m_listenSocket);
+            m_listenSocket = ERROR;
+        }
+
+        TExit();
+    }   //OpenListenSocket
+
+    /**
+     * This function closes the socket the relay accepts connections on, so
+     * that new connections are refused.
+     */
+    void
+    CloseListenSocket(
+        void
+        )
+    {
+        TLevel(FUNC);
+        TEnter();
+
+        if (m_listenSocket != ERROR)
+        {
+            close(m_listenSocket);
+            m_listenSocket = ERROR;
+        }
+
+        TExit();
+    }   //CloseListenSocket
+
+    /**
+     * This function closes both sides of a relayed connection.
+     *
+     * @param pair Points to the relayed connection.
+     */
+    void
+    ClosePair(
+        PRELAYPAIR pair
+        )
+    {
+        TLevel(FUNC);
+        TEnterMsg(("pair=%p", pair));
+
+        if (pair->clientSocket != ERROR)
+        {
+            close(pair->clientSocket);
+            pair->clientSocket = ERROR;
+        }
+        if (pair->cameraSocket != ERROR)
+        {
+            close(pair->cameraSocket);
+            pair->cameraSocket = ERROR;
+        }
+        pair->fStream = false;
+        pair->fStalled = false;
+
+        TExit();
+    }   //ClosePair
+
+    /**
+     * This function accepts a connection and connects it to the camera.
+     */
+    void
+    Accept(
+        void
+        )
+    {
+        int clientSocket;
+
+        TLevel(FUNC);
+        TEnter();
+
+        clientSocket = accept(m_listenSocket, NULL, NULL);
+        if (clientSocket != ERROR)
+        {
+            PRELAYPAIR pair = NULL;
+            struct sockaddr_in cameraAddr;
+            struct timeval timeout;
+
+            for (int i = 0; i < CB_MAX_PAIRS; i++)
+            {
+                if (m_pairs[i].clientSocket == ERROR)
+                {
+                    pair = &m_pairs[i];
+                    break;
+                }
+            }
+
+            bzero((char *)&cameraAddr, sizeof(cameraAddr));
+            cameraAddr.sin_len = (u_char)sizeof(cameraAddr);
+            cameraAddr.sin_family = AF_INET;
+            cameraAddr.sin_port = htons(CB_CAMERA_PORT);
+            cameraAddr.sin_addr.s_addr = m_cameraAddr;
+            timeout.tv_sec = CB_CONNECT_TIMEOUT;
+            timeout.tv_usec = 0;
+
+            if (pair == NULL)
+            {
+                TWarn(("Too many relay connections."));
+                close(clientSocket);
+            }
+            else if ((pair->cameraSocket = socket(AF_INET, SOCK_STREAM, 0))
+                     == ERROR)
+            {
+                TErr(("Failed to create the camera socket."));
+                close(clientSocket);
+            }
+            else if (connectWithTimeout(pair->cameraSocket,
+                                        (struct sockaddr *)&cameraAddr,
+                                        sizeof(cameraAddr), &timeout)
+                     == ERROR)
+            {
+                TWarn(("Failed to connect to the camera."));
+                pair->clientSocket = clientSocket;
+                ClosePair(pair);
+            }
+            else
+            {
+                pair->clientSocket = clientSocket;
+            }
+        }
+
+        TExit();
+    }   //Accept
+
+    /**
+     * This function passes a request from AxisCamera on to the camera. The
+     * connection that requests the video is the image stream.
+     *
+     * @param pair Points to the relayed connection.
+     */
+    void
+    RelayFromClient(
+        PRELAYPAIR pair
+        )
+    {
+        int length;
+
+        TLevel(FUNC);
+        TEnterMsg(("pair=%p", pair));
+
+        length = recv(pair->clientSocket, m_buffer, sizeof(m_buffer), 0);
+        if (length <= 0)
+        {
+            ClosePair(pair);
+        }
+        else
+        {
+            if (FindText(m_buffer, length, "GET /mjpg/") != -1)
+            {
+                pair->fStream = true;
+            }
+            if (!SendAll(pair->cameraSocket, m_buffer, length))
+            {
+                ClosePair(pair);
+            }
+        }
+
+        TExit();
+    }   //RelayFromClient
+
+    /**
+     * This function passes camera data on to AxisCamera, injecting the
+     * pending fault into the image stream. Stalls and drops happen in the
+     * middle of a frame body, so only blocks without a header are faulted.
+     * A header stall cuts the block in the middle of the Content-Length
+     * line.
+     *
+     * @param pair Points to the relayed connection.
+     */
+    void
+    RelayFromCamera(
+        PRELAYPAIR pair
+        )
+    {
+        int length;
+
+        TLevel(FUNC);
+        TEnterMsg(("pair=%p", pair));
+
+        length = recv(pair->cameraSocket, m_buffer, sizeof(m_buffer), 0);
+        if (length <= 0)
+        {
+            ClosePair(pair);
+        }
+        else if (!pair->fStalled)
+        {
+            int fault = pair->fStream && !m_fInjected? m_fault: CB_FAULT_NONE;
+            int header = FindText(m_buffer, length, "Content-Length: ");
+            int cut = -1;
+
+            if (((fault == CB_FAULT_STALL) || (fault == CB_FAULT_DROP)) &&
+                (header == -1))
+            {
+                cut = length/2;
+            }
+            else if ((fault == CB_FAULT_HEADER) && (header != -1))
+            {
+                cut = header + strlen("Content-");
+            }
+
+            if (cut == -1)
+            {
+                if (!SendAll(pair->clientSocket, m_buffer, length))
+                {
+                    ClosePair(pair);
+                }
+            }
+            else
+            {
+                SendAll(pair->clientSocket, m_buffer, cut);
+                if (fault == CB_FAULT_DROP)
+                {
+                    ClosePair(pair);
+                }
+                else
+                {
+                    pair->fStalled = true;
+                }
+                m_faultTime = GetFPGATime();
+                m_faultEndTime = m_faultTime + CB_FAULT_TIME;
+                m_fInjected = true;
+            }
+        }
+
+        TExit();
+    }   //RelayFromCamera
+
+    /**
+     * This function starts a refusal and ends the current fault once its
+     * time is up.
+     */
+    void
+    CheckFault(
+        void
+        )
+    {
+        UINT32 currTime = GetFPGATime();
+
+        TLevel(FUNC);
+        TEnter();
+
+        if ((m_fault == CB_FAULT_REFUSE) && !m_fInjected)
+        {
+            CloseListenSocket();
+            for (int i = 0; i < CB_MAX_PAIRS; i++)
+            {
+                if (m_pairs[i].fStream)
+                {
+                    ClosePair(&m_pairs[i]);
+                }
+            }
+            m_faultTime = currTime;
+            m_faultEndTime = currTime + CB_FAULT_TIME;
+            m_fInjected = true;
+        }
+        else if ((m_fault != CB_FAULT_NONE) && m_fInjected &&
+                 ((INT32)(currTime - m_faultEndTime) >= 0))
+        {
+            //
+            // A stalled stream is left stalled, so a camera that never
+            // notices the stall does not recover.
+            //
+            if (m_listenSocket == ERROR)
+            {
+                OpenListenSocket();
+            }
+            m_fault = CB_FAULT_NONE;
+        }
+
+        TExit();
+    }   //CheckFault
+
+public:
+    /**
+     * Constructor for the class object.
+     */
+    CameraRelay(
+        void
+        ): m_cameraAddr(0)
+         , m_listenSocket(ERROR)
+         , m_task("CameraRelay", (FUNCPTR)CameraRelayTask)
+         , m_fRun(false)
+         , m_fault(CB_FAULT_NONE)
+         , m_fInjected(false)
+         , m_faultTime(0)
+         , m_faultEndTime(0)
+    {
+        TLevel(INIT);
+        TEnter();
+
+        for (int i = 0; i < CB_MAX_PAIRS; i++)
+        {
+            m_pairs[i].clientSocket = ERROR;
+            m_pairs[i].cameraSocket = ERROR;
+            m_pairs[i].fStream = false;
+            m_pairs[i].fStalled = false;
+        }
+
+        TExit();
+    }   //CameraRelay
+
+    /**
+     * Destructor for the class object.
+     */
+    ~CameraRelay(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+
+        m_fRun = false;
+        while (m_task.Verify())
+        {
+            taskDelay(1);
+        }
+
+        TExit();
+    }   //~CameraRelay
+
+    /**
+     * This function starts relaying connections to the camera.
+     *
+     * @param cameraIP Specifies the IP address of the camera.
+     *
+     * @return Returns true if successful, false otherwise.
+     */
+    bool
+    Start(
+        const char *cameraIP
+        )
+    {
+        bool fStarted = false;
+
+        TLevel(API);
+        TEnterMsg(("cameraIP=%s", cameraIP));
+
+        m_cameraAddr = inet_addr((char *)cameraIP);
+        OpenListenSocket();
+        if (m_listenSocket != ERROR)
+        {
+            m_fRun = true;
+            fStarted = m_task.Start((INT32)this);
+        }
+
+        TExitMsg(("=%x", fStarted));
+        return fStarted;
+    }   //Start
+
+    /**
+     * This function arms a fault. It is injected into the next suitable
+     * block of the image stream, or right away for a refusal.
+     *
+     * @param fault Specifies the fault.
+     */
+    void
+    InjectFault(
+        int fault
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("fault=%d", fault));
+
+        m_fInjected = false;
+        m_fault = fault;
+
+        TExit();
+    }   //InjectFault
+
+    /**
+     * This function returns whether the armed fault has been injected.
+     *
+     * @param faultTime Points to the variable to hold the FPGA time the
+     *        fault was injected.
+     * @param faultEndTime Points to the variable to hold the FPGA time the
+     *        fault ends.
+     *
+     * @return Returns true if the fault has been injected.
+     */
+    bool
+    IsFaultInjected(
+        UINT32 *faultTime,
+        UINT32 *faultEndTime
+        )
+    {
+        bool fInjected = m_fInjected;
+
+        TLevel(API);
+        TEnter();
+
+        *faultTime = m_faultTime;
+        *faultEndTime = m_faultEndTime;
+
+        TExitMsg(("=%x", fInjected));
+        return fInjected;
+    }   //IsFaultInjected
+
+    /**
+     * This function returns whether the current fault is over.
+     *
+     * @return Returns true if no fault is armed or injected.
+     */
+    bool
+    IsFaultOver(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%x", m_fault == CB_FAULT_NONE));
+        return m_fault == CB_FAULT_NONE;
+    }   //IsFaultOver
+
+    /**
+     * This function relays the connections until the relay is destroyed.
+     */
+    void
+    RelayTask(
+        void
+        )
+    {
+        TLevel(TASK);
+        TEnter();
+
+        while (m_fRun)
+        {
+            struct timeval timeout;
+            fd_set fdSet;
+
+            timeout.tv_sec = 0;
+            timeout.tv_usec = CB_POLL_PERIOD;
+            FD_ZERO(&fdSet);
+            if (m_listenSocket != ERROR)
+            {
+                FD_SET(m_listenSocket, &fdSet);
+            }
+            for (int i = 0; i < CB_MAX_PAIRS; i++)
+            {
+                if (m_pairs[i].clientSocket != ERROR)
+                {
+                    FD_SET(m_pairs[i].clientSocket, &fdSet);
+                    FD_SET(m_pairs[i].cameraSocket, &fdSet);
+                }
+            }
+
+            if (select(FD_SETSIZE, &fdSet, NULL, NULL, &timeout) > 0)
+            {
+                for (int i = 0; i < CB_MAX_PAIRS; i++)
+                {
+                    PRELAYPAIR pair = &m_pairs[i];
+
+                    if ((pair->clientSocket != ERROR) &&
+                        FD_ISSET(pair->clientSocket, &fdSet))
+                    {
+                        RelayFromClient(pair);
+                    }
+                    if ((pair->cameraSocket != ERROR) &&
+                        FD_ISSET(pair->cameraSocket, &fdSet))
+                    {
+                        RelayFromCamera(pair);
+                    }
+                }
+                if ((m_listenSocket != ERROR) &&
+                    FD_ISSET(m_listenSocket, &fdSet))
+                {
+                    Accept();
+                }
+            }
+            CheckFault();
+        }
+
+        for (int i = 0; i < CB_MAX_PAIRS; i++)
+        {
+            ClosePair(&m_pairs[i]);
+        }
+        CloseListenSocket();
+
+        TExit();
+    }   //RelayTask
+
+};  //class CameraRelay
+
+/**
+ * This task runs the camera relay.
+ *
+ * Do not call this function directly.
+ */
+static
+void
+CameraRelayTask(
+    void *relay
+    )
+{
+    TLevel(TASK);
+    TEnter();
+
+    ((CameraRelay *)relay)->RelayTask();
+
+    TExit();
+}   //CameraRelayTask
+
+/**
+ * This class defines and implements the CameraBench object. The object
+ * verifies how AxisCamera handles a camera that stalls, drops the stream
+ * or refuses connections. AxisCamera must be created with CB_RELAY_IP and
+ * CB_RELAY_PORT so that it reaches the camera through the relay. Each
+ * iteration waits for a working stream, injects the fault and times how
+ * long it takes for a new frame to arrive. It fails if a frame does not
+ * arrive in time, if the stall and reconnect counters do not show the
+ * fault, or if a frame is not a whole JPEG. The benchmark is started from
+ * the console:
+ *   CameraBench.run stall|header|drop|refuse [<iterations>]
+ */
+class CameraBench: public BenchCmd
+{
+private:
+    CameraRelay         m_relay;
+    SEM_ID              m_newImageSem;
+
+    /**
+     * This function waits for a frame newer than the given one.
+     *
+     * @param camera Specifies the camera.
+     * @param lastFrame Specifies the frame number of the last frame seen.
+     * @param deadline Specifies the FPGA time to give up at.
+     * @param frameNumber Points to the variable to hold the frame number.
+     * @param frameTime Points to the variable to hold the FPGA time the
+     *        frame was received.
+     * @param numCorrupts Points to the count of frames that are not a whole
+     *        JPEG.
+     *
+     * @return Returns true if a new frame arrived, false otherwise.
+     */
+    bool
+    WaitForFrame(
+        AxisCamera &camera,
+        UINT32 lastFrame,
+        UINT32 deadline,
+        UINT32 *frameNumber,
+        UINT32 *frameTime,
+        int *numCorrupts
+        )
+    {
+        bool fNewFrame = false;
+        INT32 remaining;
+
+        TLevel(FUNC);
+        TEnterMsg(("lastFrame=%d,deadline=%d", lastFrame, deadline));
+
+        while (!fNewFrame &&
+               ((remaining = (INT32)(deadline - GetFPGATime())) > 0))
+        {
+            const char *image;
+            int imageSize;
+            int frameHandle;
+
+            semTake(m_newImageSem,
+                    remaining/1000*sysClkRateGet()/1000 + 1);
+            frameHandle = camera.PinJPEG(&image, imageSize,
+                                         frameNumber, frameTime);
+            if ((frameHandle >= 0) &&
+                ((INT32)(*frameNumber - lastFrame) > 0))
+            {
+                if ((imageSize < 4) ||
+                    ((UINT8)image[0] != 0xff) ||
+                    ((UINT8)image[1] != 0xd8) ||
+                    ((UINT8)image[imageSize - 2] != 0xff) ||
+                    ((UINT8)image[imageSize - 1] != 0xd9))
+                {
+                    TWarn(("Frame %d is not a whole JPEG (size=%d).",
+                           *frameNumber, imageSize));
+                    (*numCorrupts)++;
+                }
+                fNewFrame = true;
+            }
+            if (frameHandle >= 0)
+            {
+                camera.UnpinJPEG(frameHandle);
+            }
+        }
+
+        TExitMsg(("=%x", fNewFrame));
+        return fNewFrame;
+    }   //WaitForFrame
+
+public:
+    /**
+     * Constructor for the class object. The relay starts right away, so the
+     * camera can connect through it before the benchmark is run.
+     *
+     * @param cameraIP Specifies the IP address of the camera.
+     */
+    CameraBench(
+        const char *cameraIP
+        ): BenchCmd(MOD_NAME, "stall|header|drop|refuse [<iterations>]",
+                    "Inject camera faults: run stall|header|drop|refuse "
+                    "[<iterations>]")
+         , m_relay()
+         , m_newImageSem(NULL)
+    {
+        TLevel(INIT);
+        TEnterMsg(("cameraIP=%s", cameraIP));
+
+        if (!m_relay.Start(cameraIP))
+        {
+            TErr(("Failed to start the camera relay."));
+        }
+
+        TExit();
+    }   //CameraBench
+
+    /**
+     * Destructor for the class object.
+     */
+    virtual
+    ~CameraBench(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+        TExit();
+    }   //~CameraBench
+
+    /**
+     * This function runs the benchmark.
+     *
+     * @param fault Specifies the fault to inject.
+     * @param numIterations Specifies the number of times to inject it.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns ERR_ASSERT if the camera did not recover,
+     *         other error code otherwise.
+     */
+    int
+    Run(
+        int fault,
+        int numIterations
+        )
+    {
+        int rc = ERR_SUCCESS;
+
+        TLevel(API);
+        TEnterMsg(("fault=%d,iterations=%d", fault, numIterations));
+
+        if ((fault <= CB_FAULT_NONE) || (fault >= CB_NUM_FAULTS) ||
+            (numIterations < 1))
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            AxisCamera &camera = AxisCamera::GetInstance();
+            UINT32 lastFrame = 0;
+            UINT32 frameTime = 0;
+            UINT32 totalRecovery = 0;
+            UINT32 maxRecovery = 0;
+            int numCorrupts = 0;
+            int numFailed = 0;
+
+            if (m_newImageSem == NULL)
+            {
+                m_newImageSem = camera.GetNewImageSem();
+            }
+
+            printf("CameraBench: %s x %d\n",
+                   g_CameraBenchFaultNames[fault], numIterations);
+            for (int i = 0; i < numIterations; i++)
+            {
+                UINT32 stalls, reconnects;
+                UINT32 faultTime, faultEndTime;
+                UINT32 recovery;
+                bool fOk = true;
+
+                if (!WaitForFrame(camera, lastFrame,
+                                  GetFPGATime() + CB_FRAME_TIMEOUT,
+                                  &lastFrame, &frameTime, &numCorrupts))
+                {
+                    printf("No frames from the camera.\n");
+                    rc = ERR_ASSERT;
+                    break;
+                }
+
+                stalls = camera.GetStallCount();
+                reconnects = camera.GetReconnectCount();
+                m_relay.InjectFault(fault);
+                while (!m_relay.IsFaultInjected(&faultTime, &faultEndTime))
+                {
+                    taskDelay(1);
+                }
+                //
+                // Frames received before the fault came from the old
+                // connection.
+                //
+                WaitForFrame(camera, lastFrame, GetFPGATime(),
+                             &lastFrame, &frameTime, &numCorrupts);
+
+                if (!WaitForFrame(camera, lastFrame,
+                                  ((fault == CB_FAULT_REFUSE)?
+                                   faultEndTime: faultTime) +
+                                  CB_MAX_RECOVERY,
+                                  &lastFrame, &frameTime, &numCorrupts))
+                {
+                    printf("%d: no frame after the fault\n", i);
+                    fOk = false;
+                    recovery = 0;
+                }
+                else
+                {
+                    recovery = frameTime - faultTime;
+                    if (recovery > maxRecovery)
+                    {
+                        maxRecovery = recovery;
+                    }
+                    totalRecovery += recovery;
+                }
+                stalls = camera.GetStallCount() - stalls;
+                reconnects = camera.GetReconnectCount() - reconnects;
+                if ((reconnects == 0) ||
+                    (((fault == CB_FAULT_STALL) ||
+                      (fault == CB_FAULT_HEADER)) && (stalls == 0)))
+                {
+                    fOk = false;
+                }
+                printf("%d: recovery=%dms, stalls=+%d, reconnects=+%d%s\n",
+                       i, recovery/1000, stalls, reconnects,
+                       fOk? "": " FAILED");
+                if (!fOk)
+                {
+                    numFailed++;
+                }
+
+                while (!m_relay.IsFaultOver())
+                {
+                    taskDelay(1);
+                }
+            }
+
+            if (rc == ERR_SUCCESS)
+            {
+                printf("Recovery(ms): avg=%d max=%d, Corrupt=%d, Failed=%d\n",
+                       (numIterations > numFailed)?
+                       totalRecovery/1000/(numIterations - numFailed): 0,
+                       maxRecovery/1000, numCorrupts, numFailed);
+                if ((numFailed > 0) || (numCorrupts > 0))
+                {
+                    rc = ERR_ASSERT;
+                }
+            }
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //Run
+
+    /**
+     * This function runs the benchmark from the console command.
+     *
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    RunCmd(
+        char **apszArgs,
+        int    cArgs
+        )
+    {
+        int rc;
+        int fault = CB_FAULT_NONE;
+
+        TLevel(CALLBK);
+        TEnterMsg(("pArgs=%p,cArgs=%d", apszArgs, cArgs));
+
+        if ((cArgs >= 1) && (cArgs <= 2))
+        {
+            for (int i = CB_FAULT_NONE + 1; i < CB_NUM_FAULTS; i++)
+            {
+                if (strcmp(apszArgs[0], g_CameraBenchFaultNames[i]) == 0)
+                {
+                    fault = i;
+                    break;
+                }
+            }
+        }
+
+        if (fault == CB_FAULT_NONE)
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            rc = Run(fault,
+                     (cArgs == 2)? atoi(apszArgs[1]): CB_DEF_ITERATIONS);
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //RunCmd
+
+};  //class CameraBench
+
+#endif  //ifndef _CAMERABENCH_H
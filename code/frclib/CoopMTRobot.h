@@ -24,6 +24,10 @@
 #endif
 #define MOD_NAME                "CoopMTRobot"
 
+#ifndef LATENCY_DUMP_FILE
+#define LATENCY_DUMP_FILE       "/c/latency.csv"
+#endif
+
 #define GETLOOPPERIOD()         ((m_loopPeriod == 0.0)?             \
                                  ((double)m_periodPacket)/1000.0:   \
                                  m_loopPeriod)
@@ -47,6 +51,10 @@ private:
     Timer               m_loopTimer;
     UINT32              m_periodPacket;
     UINT32              m_prevTime;
+    UINT32              m_timeSliceUsed;
+    double              m_continuousPeriod;
+    UINT32              m_controlSequence;
+    bool                m_newControlData;
 
     /**
      * This function is called to determine if the next period has
@@ -54,7 +62,8 @@ private:
      * If m_loopPeriod > 0.0, call the periodic function every
      * m_loopPeriod as compared to Timer.Get(). If m_loopPeriod == 0.0,
      * call the periodic functions whenever a packet is received
-     * from the Driver Station, or about every 20 ms (50 Hz).
+     * from the Driver Station, or about every 20 ms (50 Hz). The
+     * packet is the one WaitForNextPacket found at the top of the loop.
      *
      * @return Returns true if the next period is ready, false otherwise.
      */
@@ -74,7 +83,8 @@ private:
         }
         else
         {
-            rc = m_ds->IsNewControlData();
+            rc = m_newControlData;
+            m_newControlData = false;
             if (rc)
             {
                 //
@@ -90,6 +100,30 @@ private:
         return rc;
     }   //NextPeriodReady
 
+    /**
+     * This function sleeps until the Driver Station publishes a new
+     * packet or until the continuous functions are due, whichever
+     * comes first. The loop wakes up as soon as the packet arrives
+     * instead of polling for it, so the periodic functions stay aligned
+     * with the packets without spinning the CPU in between.
+     */
+    void
+    WaitForNextPacket(
+        void
+        )
+    {
+        TLevel(HIFREQ);
+        TEnter();
+
+        if (m_ds->WaitForNewData(m_controlSequence, m_continuousPeriod,
+                                 &m_controlSequence))
+        {
+            m_newControlData = true;
+        }
+
+        TExitMsg(("newData=%d", m_newControlData));
+    }   //WaitForNextPacket
+
 public:
     /*
      * The default period for the periodic function calls (seconds)
@@ -98,6 +132,12 @@ public:
      */
     static const double kDefaultPeriod = 0.0;
 
+    /*
+     * The default time between calls of the continuous functions when
+     * no Driver Station packet arrives (seconds).
+     */
+    static const double kDefaultContinuousPeriod = 0.005;
+
     /**
      * This function is called one time to do robot-wide initialization.
      */
@@ -199,9 +239,6 @@ public:
     {
         TLevel(HIFREQ);
         TEnter();
-
-        taskDelay(1);
-
         TExit();
     }   //DisabledContinuous
 
@@ -262,9 +299,6 @@ public:
     {
         TLevel(HIFREQ);
         TEnter();
-
-        taskDelay(1);
-
         TExit();
     }   //AutonomousContinuous
 
@@ -324,9 +358,6 @@ public:
     {
         TLevel(HIFREQ);
         TEnter();
-
-        taskDelay(1);
-
         TExit();
     }   //TeleOpContinuous
 
@@ -363,6 +394,25 @@ public:
 
         TExit();
     }   //SetPeriod
+
+    /**
+     * This function sets the longest time the main loop sleeps between
+     * calls of the continuous functions. The loop also wakes up for
+     * every Driver Station packet.
+     *
+     * @param period The time between continuous function calls in
+     *        seconds. Less than 0.0 means only once per packet.
+     */
+    void
+    SetContinuousPeriod(
+        double period
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("period=%f", period));
+        m_continuousPeriod = period;
+        TExit();
+    }   //SetContinuousPeriod
     
     /**
      * This function gets the period for the periodic functions.
@@ -403,6 +453,34 @@ public:
         return freq;
     }   //GetLoopsPerSec
 
+    /**
+     * This function gets the load of the main loop. It is the execution
+     * time of the last periodic loop over the loop period, so a value
+     * above 1.0 means the loop is overrunning its period.
+     *
+     * @return Returns the load of the last periodic loop.
+     */
+    float
+    GetLoopLoad(
+        void
+        )
+    {
+        float load = 0.0;
+        double period;
+
+        TLevel(API);
+        TEnter();
+
+        period = GETLOOPPERIOD();
+        if (period > 0.0)
+        {
+            load = (float)((double)m_timeSliceUsed/1000.0/period);
+        }
+
+        TExitMsg(("=%f", load));
+        return load;
+    }   //GetLoopLoad
+
     /**
      * Start a competition.
      * This specific StartCompetition() implements "main loop" behavior like
@@ -428,8 +506,9 @@ public:
         UINT32 mode = MODE_DISABLED;
         UINT32 cntLoops = 0;
         UINT32 timeSliceStart = 0;
-        UINT32 timeSliceUsed = 0;
         UINT32 periodStartTime = GetMsecTime();
+        char lcdText[DriverStationLCD::kLineLength];
+        TextFormatter lcdLine(lcdText, sizeof(lcdText));
         
         //
         // Disable the watchdog while doing initialization.
@@ -469,15 +548,22 @@ public:
         //
         // Loop forever, calling the appropriate mode-dependent functions.
         //
+        m_controlSequence = m_ds->GetControlSequence();
         while (true)
         {
+            WaitForNextPacket();
             GetWatchdog().Feed();
             TPeriodStart();
 
-            m_dsLCD->PrintfLine(
-                DriverStationLCD::kUser_Line1, "[%s: %7.3f]",
-                runModes[mode],
-                (float)(GetMsecTime() - periodStartTime)/1000.0);
+            //
+            // This runs every loop, so format the line without printf.
+            //
+            lcdLine.Reset();
+            lcdLine.Char('[').Str(runModes[mode]).Str(": ")
+                   .Fixed((GetMsecTime() - periodStartTime)/1000.0, 7, 3)
+                   .Char(']');
+            m_dsLCD->PrintLine(DriverStationLCD::kUser_Line1,
+                               lcdLine.GetText(), lcdLine.GetLength());
 #ifdef _PERFDATA_LOOP
             StartPerfDataLoop();
 #endif
@@ -509,15 +595,15 @@ public:
                             m_taskMgr->TaskPrePeriodicAll(mode);
                             DisabledPeriodic();
                             m_taskMgr->TaskPostPeriodicAll(mode);
-                            timeSliceUsed = GetMsecTime() - timeSliceStart;
+                            m_timeSliceUsed = GetMsecTime() - timeSliceStart;
                             cntLoops++;
-                            if ((float)timeSliceUsed/1000.0 > GETLOOPPERIOD())
+                            if ((float)m_timeSliceUsed/1000.0 > GETLOOPPERIOD())
                             {
                                 //
                                 // Execution time exceeds the loop period.
                                 //
                                 TWarn(("Disabled execution takes too long (%d/%d ms)",
-                                       timeSliceUsed,
+                                       m_timeSliceUsed,
                                        (int)(GETLOOPPERIOD()*1000)));
                             }
                         }
@@ -534,15 +620,15 @@ public:
                             m_taskMgr->TaskPrePeriodicAll(mode);
                             AutonomousPeriodic();
                             m_taskMgr->TaskPostPeriodicAll(mode);
-                            timeSliceUsed = GetMsecTime() - timeSliceStart;
+                            m_timeSliceUsed = GetMsecTime() - timeSliceStart;
                             cntLoops++;
-                            if ((float)timeSliceUsed/1000.0 > GETLOOPPERIOD())
+                            if ((float)m_timeSliceUsed/1000.0 > GETLOOPPERIOD())
                             {
                                 //
                                 // Execution time exceeds the loop period.
                                 //
                                 TWarn(("Autonomous execution takes too long (%d/%d ms)",
-                                       timeSliceUsed,
+                                       m_timeSliceUsed,
                                        (int)(GETLOOPPERIOD()*1000)));
                             }
                         }
@@ -554,6 +640,9 @@ public:
                     {
                         AutonomousStop();
                         m_taskMgr->TaskStopModeAll(mode);
+#ifdef _LATENCY_DUMP
+                        ControlLatency::DumpToFile(LATENCY_DUMP_FILE);
+#endif
                         mode = MODE_DISABLED;
                         periodStartTime = GetMsecTime();
                     }
@@ -569,15 +658,15 @@ public:
                             m_taskMgr->TaskPrePeriodicAll(mode);
                             TeleOpPeriodic();
                             m_taskMgr->TaskPostPeriodicAll(mode);
-                            timeSliceUsed = GetMsecTime() - timeSliceStart;
+                            m_timeSliceUsed = GetMsecTime() - timeSliceStart;
                             cntLoops++;
-                            if ((float)timeSliceUsed/1000.0 > GETLOOPPERIOD())
+                            if ((float)m_timeSliceUsed/1000.0 > GETLOOPPERIOD())
                             {
                                 //
                                 // Execution time exceeds the loop period.
                                 //
                                 TWarn(("TeleOp execution takes too long (%d/%d ms)",
-                                       timeSliceUsed,
+                                       m_timeSliceUsed,
                                        (int)(GETLOOPPERIOD()*1000)));
                             }
                         }
@@ -589,6 +678,9 @@ public:
                     {
                         TeleOpStop();
                         m_taskMgr->TaskStopModeAll(mode);
+#ifdef _LATENCY_DUMP
+                        ControlLatency::DumpToFile(LATENCY_DUMP_FILE);
+#endif
                         mode = MODE_DISABLED;
                         periodStartTime = GetMsecTime();
                     }
@@ -616,6 +708,10 @@ protected:
         ): m_loopPeriod(kDefaultPeriod)
          , m_periodPacket(0)
          , m_prevTime(0)
+         , m_timeSliceUsed(0)
+         , m_continuousPeriod(kDefaultContinuousPeriod)
+         , m_controlSequence(0)
+         , m_newControlData(false)
     {
         TLevel(INIT);
         TEnter();
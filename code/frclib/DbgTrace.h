@@ -41,6 +41,8 @@
 #define MOD_PIDMOTOR            0x08000000
 #define MOD_PIDDRIVE            0x10000000
 #define MOD_LNFOLLOWER          0x20000000
+#define MOD_NETTABLES           0x40000000
+#define MOD_BENCH               0x80000000
 
 #define MOD_MAIN                0x00000001
 #define TGenModId(n)            ((MOD_MAIN << (n)) & 0xff)
@@ -0,0 +1,421 @@
+#if 0
+/// Copyright (c) Titan Robotics Club. All rights reserved.
+///
+/// <module name="FormatBench.h" />
+///
+/// <summary>
+///     This module contains the definitions and implementation of the
+///     FormatBench class.
+/// </summary>
+///
+/// <remarks>
+///     Environment: Wind River C++ for National Instrument cRIO based Robot.
+/// </remarks>
+#endif
+
+#ifndef _FORMATBENCH_H
+#define _FORMATBENCH_H
+
+#ifdef MOD_ID
+#undef MOD_ID
+#endif
+#define MOD_ID                  MOD_BENCH
+#ifdef MOD_NAME
+#undef MOD_NAME
+#endif
+#define MOD_NAME                "FormatBench"
+
+//
+// Benchmark cases, taken from the LCD lines printed by CoopMTRobot and the
+// robot code.
+//
+#define FMB_CASE_MODE           0       //"[%s: %7.3f]"
+#define FMB_CASE_SHOOTER        1       //"ID=%d,A=%5.1f"
+#define FMB_CASE_TARGET         2       //"x=%3d, y=%3d"
+#define FMB_CASE_SOLENOID       3       //"[%d] Solenoids %08x"
+#define FMB_CASE_LCDLINE        4       //PrintfLine vs PrintLine
+#define FMB_NUM_CASES           5
+
+#define FMB_DEF_LOOPS           10000
+#define FMB_CHECK_LOOPS         1000
+
+static const char *g_FormatBenchCaseNames[FMB_NUM_CASES] =
+{
+    "[%s: %7.3f]",
+    "ID=%d,A=%5.1f",
+    "x=%3d, y=%3d",
+    "[%d] Solenoids %08x",
+    "LCD line"
+};
+
+/**
+ * This class implements a micro-benchmark of the LCD text formatting. Each
+ * case formats the same values with vsnprintf, the way
+ * DriverStationLCD::PrintfLine does, and with TextFormatter, then prints the
+ * time per call of both. The benchmark is started from the console:
+ *   FormatBench.run [<loops>]
+ */
+class FormatBench: public BenchCmd
+{
+private:
+    char                    m_text[DriverStationLCD::kLineLength + 1];
+    char                    m_expected[DriverStationLCD::kLineLength + 1];
+    UINT32                  m_checksum;
+
+    /**
+     * This function formats text with vsnprintf the same way
+     * DriverStationLCD::PrintfLine does.
+     *
+     * @param format Specifies the printf format string.
+     *
+     * @return Returns the length of the formatted text.
+     */
+    int
+    VPrintf(
+        const char *format,
+        ...
+        )
+    {
+        va_list args;
+        int length;
+
+        va_start(args, format);
+        length = vsnprintf(m_text, sizeof(m_text), format, args);
+        va_end(args);
+
+        return length;
+    }   //VPrintf
+
+    /**
+     * This function formats the text of one case with vsnprintf into
+     * m_text.
+     *
+     * @param benchCase Specifies the benchmark case.
+     * @param i Specifies the loop count the values are made from.
+     *
+     * @return Returns the length of the formatted text.
+     */
+    int
+    FormatPrintf(
+        int benchCase,
+        int i
+        )
+    {
+        int length = 0;
+
+        switch (benchCase)
+        {
+            case FMB_CASE_MODE:
+            case FMB_CASE_LCDLINE:
+                length = VPrintf("[%s: %7.3f]", "TeleOp", (float)i/1000.0);
+                break;
+
+            case FMB_CASE_SHOOTER:
+                length = VPrintf("ID=%d,A=%5.1f", i & 0x3,
+                                 (float)(i%900)/10.0);
+                break;
+
+            case FMB_CASE_TARGET:
+                length = VPrintf("x=%3d, y=%3d", i%320, i%240);
+                break;
+
+            case FMB_CASE_SOLENOID:
+                length = VPrintf("[%d] Solenoids %08x", i & 0x7,
+                                 (UINT32)i*0x01010101);
+                break;
+        }
+
+        return length;
+    }   //FormatPrintf
+
+    /**
+     * This function formats the text of one case with TextFormatter.
+     *
+     * @param text Specifies the formatter to append the text to.
+     * @param benchCase Specifies the benchmark case.
+     * @param i Specifies the loop count the values are made from.
+     */
+    void
+    FormatText(
+        TextFormatter &text,
+        int benchCase,
+        int i
+        )
+    {
+        switch (benchCase)
+        {
+            case FMB_CASE_MODE:
+            case FMB_CASE_LCDLINE:
+                text.Char('[').Str("TeleOp").Str(": ")
+                    .Fixed((float)i/1000.0, 7, 3).Char(']');
+                break;
+
+            case FMB_CASE_SHOOTER:
+                text.Str("ID=").Int(i & 0x3).Str(",A=")
+                    .Fixed((float)(i%900)/10.0, 5, 1);
+                break;
+
+            case FMB_CASE_TARGET:
+                text.Str("x=").Int(i%320, 3).Str(", y=").Int(i%240, 3);
+                break;
+
+            case FMB_CASE_SOLENOID:
+                text.Char('[').Int(i & 0x7).Str("] Solenoids ")
+                    .Hex((UINT32)i*0x01010101, 8);
+                break;
+        }
+    }   //FormatText
+
+    /**
+     * This function checks that both ways of formatting a case produce the
+     * same text for the values the benchmark uses.
+     *
+     * @param benchCase Specifies the benchmark case.
+     *
+     * @return Returns true if the text matches, false otherwise.
+     */
+    bool
+    CheckCase(
+        int benchCase
+        )
+    {
+        bool fMatch = true;
+        TextFormatter text(m_text, DriverStationLCD::kLineLength);
+
+        TLevel(FUNC);
+        TEnterMsg(("case=%d", benchCase));
+
+        for (int i = 0; fMatch && (i < FMB_CHECK_LOOPS); i++)
+        {
+            FormatPrintf(benchCase, i);
+            strcpy(m_expected, m_text);
+            text.Reset();
+            FormatText(text, benchCase, i);
+            m_text[text.GetLength()] = '\0';
+            if (strcmp(m_text, m_expected) != 0)
+            {
+                printf("FormatBench: %s mismatch at %d: "
+                       "printf=\"%s\" fmt=\"%s\"\n",
+                       g_FormatBenchCaseNames[benchCase], i,
+                       m_expected, m_text);
+                fMatch = false;
+            }
+        }
+
+        TExitMsg(("=%d", fMatch));
+        return fMatch;
+    }   //CheckCase
+
+    /**
+     * This function runs one case with vsnprintf.
+     *
+     * @param benchCase Specifies the benchmark case.
+     * @param numLoops Specifies the number of calls to time.
+     *
+     * @return Returns the elapsed time in usec.
+     */
+    UINT32
+    RunPrintf(
+        int benchCase,
+        int numLoops
+        )
+    {
+        DriverStationLCD *lcd = DriverStationLCD::GetInstance();
+        UINT32 startTime;
+
+        TLevel(FUNC);
+        TEnterMsg(("case=%d,loops=%d", benchCase, numLoops));
+
+        startTime = GetFPGATime();
+        for (int i = 0; i < numLoops; i++)
+        {
+            if (benchCase == FMB_CASE_LCDLINE)
+            {
+                lcd->PrintfLine(DriverStationLCD::kUser_Line6,
+                                "[%s: %7.3f]", "TeleOp",
+                                (float)i/1000.0);
+            }
+            else
+            {
+                m_checksum += FormatPrintf(benchCase, i);
+            }
+        }
+
+        TExit();
+        return GetFPGATime() - startTime;
+    }   //RunPrintf
+
+    /**
+     * This function runs one case with TextFormatter.
+     *
+     * @param benchCase Specifies the benchmark case.
+     * @param numLoops Specifies the number of calls to time.
+     *
+     * @return Returns the elapsed time in usec.
+     */
+    UINT32
+    RunFormatter(
+        int benchCase,
+        int numLoops
+        )
+    {
+        DriverStationLCD *lcd = DriverStationLCD::GetInstance();
+        TextFormatter text(m_text, DriverStationLCD::kLineLength);
+        UINT32 startTime;
+
+        TLevel(FUNC);
+        TEnterMsg(("case=%d,loops=%d", benchCase, numLoops));
+
+        startTime = GetFPGATime();
+        for (int i = 0; i < numLoops; i++)
+        {
+            text.Reset();
+            FormatText(text, benchCase, i);
+            if (benchCase == FMB_CASE_LCDLINE)
+            {
+                lcd->PrintLine(DriverStationLCD::kUser_Line6,
+                               text.GetText(), text.GetLength());
+            }
+            else
+            {
+                m_checksum += text.GetLength();
+            }
+        }
+
+        TExit();
+        return GetFPGATime() - startTime;
+    }   //RunFormatter
+
+public:
+    /**
+     * Constructor for the class object.
+     */
+    FormatBench(
+        void
+        ): BenchCmd(MOD_NAME, "[<loops>]",
+                    "Benchmark LCD text formatting against vsnprintf: run [<loops>]")
+         , m_checksum(0)
+    {
+        TLevel(INIT);
+        TEnter();
+
+        memset(m_text, 0, sizeof(m_text));
+        memset(m_expected, 0, sizeof(m_expected));
+
+        TExit();
+    }   //FormatBench
+
+    /**
+     * Destructor for the class object.
+     */
+    virtual
+    ~FormatBench(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+        TExit();
+    }   //~FormatBench
+
+    /**
+     * This function runs the benchmark. The text of every case is checked
+     * first and nothing is timed if any of it does not match. Every case is
+     * then run once untimed so that both sides start with warm caches.
+     *
+     * @param numLoops Specifies the number of calls to time per case.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    Run(
+        int numLoops
+        )
+    {
+        int rc = ERR_SUCCESS;
+
+        TLevel(API);
+        TEnterMsg(("loops=%d", numLoops));
+
+        if (numLoops < 1)
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            for (int i = 0; i < FMB_NUM_CASES; i++)
+            {
+                if (!CheckCase(i))
+                {
+                    rc = ERR_ASSERT;
+                }
+            }
+        }
+
+        if (rc == ERR_SUCCESS)
+        {
+            printf("FormatBench: %d loops\n", numLoops);
+            printf("%-22s %10s %10s %7s\n",
+                   "Case", "printf(us)", "fmt(us)", "ratio");
+            for (int i = 0; i < FMB_NUM_CASES; i++)
+            {
+                UINT32 printfTime, formatterTime;
+
+                RunPrintf(i, 1);
+                RunFormatter(i, 1);
+                printfTime = RunPrintf(i, numLoops);
+                formatterTime = RunFormatter(i, numLoops);
+                printf("%-22s %10.3f %10.3f %7.3f\n",
+                       g_FormatBenchCaseNames[i],
+                       (double)printfTime/numLoops,
+                       (double)formatterTime/numLoops,
+                       (printfTime > 0)?
+                           (double)formatterTime/printfTime: 0.0);
+            }
+            //
+            // Print the checksum so the formatting cannot be optimized away.
+            //
+            printf("Checksum=%u\n", m_checksum);
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //Run
+
+    /**
+     * This function runs the benchmark from the console command.
+     *
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    RunCmd(
+        char **apszArgs,
+        int    cArgs
+        )
+    {
+        int rc;
+
+        TLevel(CALLBK);
+        TEnterMsg(("pArgs=%p,cArgs=%d", apszArgs, cArgs));
+
+        if (cArgs > 1)
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            rc = Run((cArgs == 1)? atoi(apszArgs[0]): FMB_DEF_LOOPS);
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //RunCmd
+
+};  //class FormatBench
+
+#endif  //ifndef _FORMATBENCH_H
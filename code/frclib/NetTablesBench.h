@@ -0,0 +1,1066 @@
+#if 0
+/// Copyright (c) Titan Robotics Club. All rights reserved.
+///
+/// <module name="NetTablesBench.h" />
+///
+/// <summary>
+///     This module contains the definitions and implementation of the
+///     NetTablesBench class.
+/// </summary>
+///
+/// <remarks>
+///     Environment: Wind River C++ for National Instrument cRIO based Robot.
+/// </remarks>
+#endif
+
+#ifndef _NETTABLESBENCH_H
+#define _NETTABLESBENCH_H
+
+#ifdef MOD_ID
+#undef MOD_ID
+#endif
+#define MOD_ID                  MOD_NETTABLES
+#ifdef MOD_NAME
+#undef MOD_NAME
+#endif
+#define MOD_NAME                "NetTablesBench"
+
+#define NTB_TABLE_NAME          "NTBench"
+#define NTB_PORT                1735
+#define NTB_MAX_CLIENTS         4
+#define NTB_MAX_KEYS            256
+#define NTB_MAX_SUBTABLES       16
+#define NTB_BUFFER_SIZE         1024
+#define NTB_HIST_BUCKETS        500
+#define NTB_HIST_WIDTH          100     //usec per histogram bucket
+#define NTB_IDLE_PERIOD         100000  //usec between pings when idle
+#define NTB_SETTLE_TIME         200000  //usec without updates to be done
+#define NTB_DRAIN_TIMEOUT       2000000 //usec to wait for the last updates
+
+//
+// Publish patterns.
+//
+#define NTB_PATTERN_DOUBLES     0       //one key updated at a high rate
+#define NTB_PATTERN_KEYS        1       //many keys updated every loop
+#define NTB_PATTERN_TRANSACTION 2       //all keys in one transaction per loop
+#define NTB_PATTERN_SUBTABLES   3       //keys spread over sub-tables
+#define NTB_NUM_PATTERNS        4
+
+#define NTB_DEF_CLIENTS         1
+#define NTB_DEF_KEYS            16
+#define NTB_DEF_LOOPS           1000
+#define NTB_DEF_PERIOD          5       //msec
+
+static const char *g_NetTablesPatternNames[NTB_NUM_PATTERNS] =
+{
+    "doubles",
+    "keys",
+    "trans",
+    "subtables"
+};
+
+static
+void
+NetTablesBenchClientTask(
+    void *client
+    );
+
+/**
+ * This class defines and implements the NetTablesBenchClient object. The
+ * object is a minimal NetworkTables client that connects to the robot's
+ * NetworkTables server over the loopback interface. It requests the
+ * benchmark table, confirms every update it receives and measures the
+ * latency of the double values, which carry the time they were published.
+ */
+class NetTablesBenchClient
+{
+private:
+    int                 m_socket;
+    Task                m_task;
+    volatile bool       m_fRun;
+    bool                m_fError;
+    bool                m_fInTransaction;
+    NetworkTables::Buffer m_output;
+    UINT8               m_input[NTB_BUFFER_SIZE];
+    int                 m_head;
+    int                 m_tail;
+    int                 m_numConfirms;
+    volatile UINT32     m_numUpdates;
+    UINT32              m_numRecvs;
+    UINT32              m_numSends;
+    UINT32              m_maxLatency;
+    UINT32              m_histogram[NTB_HIST_BUCKETS + 1];
+
+    /**
+     * This function sends the buffered output to the server.
+     */
+    void
+    Send(
+        void
+        )
+    {
+        TLevel(UTIL);
+        TEnter();
+
+        if (m_output.GetSize() > 0)
+        {
+            if (!m_output.Flush(m_socket))
+            {
+                m_fError = true;
+            }
+            m_numSends++;
+        }
+
+        TExit();
+    }   //Send
+
+    /**
+     * This function confirms the updates received so far. Each confirmation
+     * byte carries up to 31 confirmations.
+     */
+    void
+    SendConfirmations(
+        void
+        )
+    {
+        TLevel(UTIL);
+        TEnter();
+
+        while (m_numConfirms > 0)
+        {
+            int count = (m_numConfirms < kNetworkTables_CONFIRMATION_MAX)?
+                        m_numConfirms: kNetworkTables_CONFIRMATION_MAX;
+
+            m_output.WriteByte(kNetworkTables_CONFIRMATION | count);
+            m_numConfirms -= count;
+        }
+        Send();
+
+        TExit();
+    }   //SendConfirmations
+
+    /**
+     * This function returns the next byte from the server. Confirmations
+     * are sent whenever the input buffer runs dry, and pings are sent when
+     * the server is quiet so that its watchdog does not drop us.
+     *
+     * @return Success Returns the byte.
+     * @return Failure Returns -1 if the client is stopped or the connection
+     *         failed.
+     */
+    int
+    ReadByte(
+        void
+        )
+    {
+        int value = -1;
+
+        TLevel(UTIL);
+        TEnter();
+
+        while (!m_fError && (m_head == m_tail))
+        {
+            struct timeval timeout;
+            fd_set fdSet;
+
+            SendConfirmations();
+            timeout.tv_sec = 0;
+            timeout.tv_usec = NTB_IDLE_PERIOD;
+            FD_ZERO(&fdSet);
+            FD_SET(m_socket, &fdSet);
+            int rc = select(FD_SETSIZE, &fdSet, NULL, NULL, &timeout);
+            if (rc == ERROR)
+            {
+                m_fError = true;
+            }
+            else if (rc == 0)
+            {
+                if (!m_fRun)
+                {
+                    m_fError = true;
+                }
+                else
+                {
+                    m_output.WriteByte(kNetworkTables_PING);
+                    Send();
+                }
+            }
+            else
+            {
+                rc = recv(m_socket, (char *)m_input, sizeof(m_input), 0);
+                m_numRecvs++;
+                if (rc <= 0)
+                {
+                    m_fError = true;
+                }
+                else
+                {
+                    m_head = 0;
+                    m_tail = rc;
+                }
+            }
+        }
+
+        if (!m_fError)
+        {
+            value = m_input[m_head++];
+        }
+
+        TExitMsg(("=%d", value));
+        return value;
+    }   //ReadByte
+
+    /**
+     * This function reads a variable size ID.
+     *
+     * @param value Specifies the byte that starts the ID.
+     * @param tag Specifies the ID tag.
+     *
+     * @return Returns the ID.
+     */
+    int
+    ReadVariableSize(
+        int value,
+        int tag
+        )
+    {
+        TLevel(UTIL);
+        TEnterMsg(("value=%x,tag=%x", value, tag));
+
+        value ^= tag;
+        if (value >= tag - 4)
+        {
+            int bytes = (value & 3) + 1;
+
+            value = 0;
+            for (int i = 0; i < bytes; i++)
+            {
+                value = (value << 8) | ReadByte();
+            }
+        }
+
+        TExitMsg(("=%d", value));
+        return value;
+    }   //ReadVariableSize
+
+    /**
+     * This function skips over a string.
+     */
+    void
+    SkipString(
+        void
+        )
+    {
+        TLevel(UTIL);
+        TEnter();
+
+        int length = ReadByte();
+        if (length == kNetworkTables_BEGIN_STRING)
+        {
+            while (!m_fError && (ReadByte() != kNetworkTables_END_STRING))
+            {
+            }
+        }
+        else
+        {
+            for (int i = 0; !m_fError && (i < length); i++)
+            {
+                ReadByte();
+            }
+        }
+
+        TExit();
+    }   //SkipString
+
+    /**
+     * This function reads a double in network byte order.
+     *
+     * @return Returns the double.
+     */
+    double
+    ReadDouble(
+        void
+        )
+    {
+        UINT64 bits = 0;
+        double value;
+
+        TLevel(UTIL);
+        TEnter();
+
+        for (unsigned i = 0; i < sizeof(value); i++)
+        {
+            bits = (bits << 8) | (UINT8)ReadByte();
+        }
+        memcpy(&value, &bits, sizeof(value));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //ReadDouble
+
+    /**
+     * This function records the latency of an update.
+     *
+     * @param publishTime Specifies the time the value was published in usec.
+     */
+    void
+    RecordLatency(
+        double publishTime
+        )
+    {
+        TLevel(UTIL);
+        TEnterMsg(("publishTime=%f", publishTime));
+
+        UINT32 latency = GetFPGATime() - (UINT32)publishTime;
+        UINT32 bucket = latency/NTB_HIST_WIDTH;
+
+        m_histogram[(bucket < NTB_HIST_BUCKETS)? bucket: NTB_HIST_BUCKETS]++;
+        if (latency > m_maxLatency)
+        {
+            m_maxLatency = latency;
+        }
+        m_numUpdates++;
+
+        TExit();
+    }   //RecordLatency
+
+    /**
+     * This function decodes one message from the server.
+     *
+     * @param value Specifies the first byte of the message.
+     *
+     * @return Returns true if the message is understood, false otherwise.
+     */
+    bool
+    ProcessMessage(
+        int value
+        )
+    {
+        bool fOk = true;
+
+        TLevel(FUNC);
+        TEnterMsg(("value=%x", value));
+
+        if ((value >= kNetworkTables_ID) ||
+            (value == kNetworkTables_OLD_DATA))
+        {
+            ReadVariableSize((value == kNetworkTables_OLD_DATA)?
+                             ReadByte(): value,
+                             kNetworkTables_ID);
+            value = ReadByte();
+            if (value >= kNetworkTables_TABLE_ID)
+            {
+                ReadVariableSize(value, kNetworkTables_TABLE_ID);
+            }
+            else
+            {
+                switch (value)
+                {
+                    case kNetworkTables_DOUBLE:
+                        RecordLatency(ReadDouble());
+                        break;
+
+                    case kNetworkTables_INT:
+                        for (int i = 0; i < 4; i++)
+                        {
+                            ReadByte();
+                        }
+                        break;
+
+                    case kNetworkTables_BOOLEAN_FALSE:
+                    case kNetworkTables_BOOLEAN_TRUE:
+                        break;
+
+                    case kNetworkTables_STRING:
+                        SkipString();
+                        break;
+
+                    default:
+                        fOk = false;
+                        break;
+                }
+            }
+
+            if (!m_fInTransaction)
+            {
+                m_numConfirms++;
+            }
+        }
+        else if (value >= kNetworkTables_DENIAL)
+        {
+            //
+            // Confirmations, pings and denials: we send nothing that needs
+            // them.
+            //
+        }
+        else if (value == kNetworkTables_TABLE_ASSIGNMENT)
+        {
+            ReadVariableSize(ReadByte(), kNetworkTables_TABLE_ID);
+            ReadVariableSize(ReadByte(), kNetworkTables_TABLE_ID);
+        }
+        else if (value == kNetworkTables_ASSIGNMENT)
+        {
+            ReadVariableSize(ReadByte(), kNetworkTables_TABLE_ID);
+            SkipString();
+            ReadVariableSize(ReadByte(), kNetworkTables_ID);
+        }
+        else if (value == kNetworkTables_TRANSACTION)
+        {
+            m_fInTransaction = !m_fInTransaction;
+            if (!m_fInTransaction)
+            {
+                m_numConfirms++;
+            }
+        }
+        else
+        {
+            fOk = false;
+        }
+
+        TExitMsg(("=%x", fOk));
+        return fOk;
+    }   //ProcessMessage
+
+public:
+    /**
+     * Constructor for the class object.
+     */
+    NetTablesBenchClient(
+        void
+        ): m_socket(ERROR)
+         , m_task("NTBenchClient", (FUNCPTR)NetTablesBenchClientTask)
+         , m_fRun(false)
+         , m_fError(false)
+         , m_fInTransaction(false)
+         , m_output(NTB_BUFFER_SIZE)
+         , m_head(0)
+         , m_tail(0)
+         , m_numConfirms(0)
+    {
+        TLevel(INIT);
+        TEnter();
+
+        ResetStats();
+
+        TExit();
+    }   //NetTablesBenchClient
+
+    /**
+     * Destructor for the class object.
+     */
+    ~NetTablesBenchClient(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+
+        Stop();
+
+        TExit();
+    }   //~NetTablesBenchClient
+
+    /**
+     * This function connects to the server, requests the benchmark table
+     * and starts the client task.
+     *
+     * @return Returns true if successful, false otherwise.
+     */
+    bool
+    Start(
+        void
+        )
+    {
+        bool fStarted = false;
+        struct sockaddr_in serverAddr;
+
+        TLevel(API);
+        TEnter();
+
+        bzero((char *)&serverAddr, sizeof(serverAddr));
+        serverAddr.sin_len = (u_char)sizeof(serverAddr);
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(NTB_PORT);
+        serverAddr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_socket == ERROR)
+        {
+            TErr(("Failed to create client socket."));
+        }
+        else if (connect(m_socket, (struct sockaddr *)&serverAddr,
+                         sizeof(serverAddr)) == ERROR)
+        {
+            TErr(("Failed to connect to the NetworkTables server."));
+            close(m_socket);
+            m_socket = ERROR;
+        }
+        else
+        {
+            m_output.WriteByte(kNetworkTables_TABLE_REQUEST);
+            m_output.WriteString(NTB_TABLE_NAME);
+            m_output.WriteTableId(1);
+            Send();
+            m_fRun = true;
+            fStarted = m_task.Start((INT32)this);
+        }
+
+        TExitMsg(("=%x", fStarted));
+        return fStarted;
+    }   //Start
+
+    /**
+     * This function stops the client task and disconnects from the server.
+     */
+    void
+    Stop(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+
+        m_fRun = false;
+        while (m_task.Verify())
+        {
+            taskDelay(1);
+        }
+        if (m_socket != ERROR)
+        {
+            close(m_socket);
+            m_socket = ERROR;
+        }
+
+        TExit();
+    }   //Stop
+
+    /**
+     * This function clears the statistics.
+     */
+    void
+    ResetStats(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+
+        m_numUpdates = 0;
+        m_numRecvs = 0;
+        m_numSends = 0;
+        m_maxLatency = 0;
+        memset(m_histogram, 0, sizeof(m_histogram));
+
+        TExit();
+    }   //ResetStats
+
+    /**
+     * This function returns the number of double updates received.
+     *
+     * @return Returns the number of updates.
+     */
+    UINT32
+    GetNumUpdates(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%d", m_numUpdates));
+        return m_numUpdates;
+    }   //GetNumUpdates
+
+    /**
+     * This function adds the client statistics to the totals.
+     *
+     * @param histogram Points to the latency histogram to add to.
+     * @param maxLatency Points to the maximum latency to update.
+     * @param numRecvs Points to the recv() count to add to.
+     * @param numSends Points to the send count to add to.
+     */
+    void
+    AddStats(
+        UINT32 *histogram,
+        UINT32 *maxLatency,
+        UINT32 *numRecvs,
+        UINT32 *numSends
+        )
+    {
+        TLevel(API);
+        TEnter();
+
+        for (int i = 0; i <= NTB_HIST_BUCKETS; i++)
+        {
+            histogram[i] += m_histogram[i];
+        }
+        if (m_maxLatency > *maxLatency)
+        {
+            *maxLatency = m_maxLatency;
+        }
+        *numRecvs += m_numRecvs;
+        *numSends += m_numSends;
+
+        TExit();
+    }   //AddStats
+
+    /**
+     * This function decodes the messages from the server until the client
+     * is stopped.
+     */
+    void
+    ClientTask(
+        void
+        )
+    {
+        TLevel(TASK);
+        TEnter();
+
+        while (!m_fError)
+        {
+            int value = ReadByte();
+
+            if ((value != -1) && !ProcessMessage(value))
+            {
+                TErr(("Unexpected message byte %x.", value));
+                m_fError = true;
+            }
+        }
+
+        TExit();
+    }   //ClientTask
+
+};  //class NetTablesBenchClient
+
+/**
+ * This task runs a benchmark client.
+ *
+ * Do not call this function directly.
+ */
+static
+void
+NetTablesBenchClientTask(
+    void *client
+    )
+{
+    TLevel(TASK);
+    TEnter();
+
+    ((NetTablesBenchClient *)client)->ClientTask();
+
+    TExit();
+}   //NetTablesBenchClientTask
+
+/**
+ * This class defines and implements the NetTablesBench object. The object
+ * measures the NetworkTables server with clients connected over the
+ * loopback interface. It publishes doubles in one of several patterns and
+ * reports the publish and delivery rates, the end-to-end latency
+ * percentiles, the socket calls per update and the heap growth, so that
+ * changes to the NetworkTables code can be compared against a baseline.
+ * The benchmark is started from the console:
+ *   NetTablesBench.run <pattern> [<clients> [<keys> [<loops> [<periodms>]]]]
+ */
+class NetTablesBench: public BenchCmd
+{
+private:
+    NetworkTable           *m_table;
+    NetworkTable           *m_subTables[NTB_MAX_SUBTABLES];
+    NetworkTables::Key     *m_keys[NTB_MAX_KEYS];
+    NetTablesBenchClient   *m_clients[NTB_MAX_CLIENTS];
+    UINT32                  m_sequence;
+
+    /**
+     * This function resolves the keys for a pattern.
+     *
+     * @param pattern Specifies the publish pattern.
+     * @param numKeys Specifies the number of keys.
+     */
+    void
+    SetupKeys(
+        int pattern,
+        int numKeys
+        )
+    {
+        char name[16];
+
+        TLevel(FUNC);
+        TEnterMsg(("pattern=%d,numKeys=%d", pattern, numKeys));
+
+        for (int i = 0; i < numKeys; i++)
+        {
+            NetworkTable *table = m_table;
+
+            snprintf(name, sizeof(name), "k%d", i);
+            if (pattern == NTB_PATTERN_SUBTABLES)
+            {
+                int sub = i%NTB_MAX_SUBTABLES;
+
+                if (m_subTables[sub] == NULL)
+                {
+                    char subName[32];
+
+                    snprintf(subName, sizeof(subName), "%s.s%d",
+                             NTB_TABLE_NAME, sub);
+                    m_subTables[sub] = NetworkTable::GetTable(subName);
+                    snprintf(subName, sizeof(subName), "s%d", sub);
+                    m_table->PutSubTable(subName, m_subTables[sub]);
+                }
+                table = m_subTables[sub];
+            }
+            m_keys[i] = table->GetKeyHandle(name);
+        }
+
+        TExit();
+    }   //SetupKeys
+
+    /**
+     * This function publishes one loop of updates. Every value is the
+     * current time in usec, with the sequence number in the fraction so
+     * that no two values are equal.
+     *
+     * @param pattern Specifies the publish pattern.
+     * @param numKeys Specifies the number of keys.
+     */
+    void
+    PublishLoop(
+        int pattern,
+        int numKeys
+        )
+    {
+        TLevel(FUNC);
+        TEnterMsg(("pattern=%d,numKeys=%d", pattern, numKeys));
+
+        if (pattern == NTB_PATTERN_TRANSACTION)
+        {
+            m_table->BeginTransaction();
+        }
+
+        for (int i = 0; i < numKeys; i++)
+        {
+            NetworkTables::Key *key = m_keys[(pattern == NTB_PATTERN_DOUBLES)?
+                                             0: i];
+            NetworkTable *table = (pattern == NTB_PATTERN_SUBTABLES)?
+                                  m_subTables[i%NTB_MAX_SUBTABLES]: m_table;
+
+            m_sequence++;
+            table->PutDouble(key, (double)GetFPGATime() +
+                                  (m_sequence%1000)/1000.0);
+        }
+
+        if (pattern == NTB_PATTERN_TRANSACTION)
+        {
+            m_table->EndTransaction();
+        }
+
+        TExit();
+    }   //PublishLoop
+
+    /**
+     * This function waits until the clients stop receiving updates.
+     *
+     * @param numClients Specifies the number of clients.
+     */
+    void
+    WaitForClients(
+        int numClients
+        )
+    {
+        UINT32 startTime = GetFPGATime();
+        UINT32 lastChangeTime = startTime;
+        UINT32 lastCount = 0;
+
+        TLevel(FUNC);
+        TEnterMsg(("numClients=%d", numClients));
+
+        while ((GetFPGATime() - lastChangeTime < NTB_SETTLE_TIME) &&
+               (GetFPGATime() - startTime < NTB_DRAIN_TIMEOUT))
+        {
+            UINT32 count = 0;
+
+            for (int i = 0; i < numClients; i++)
+            {
+                count += m_clients[i]->GetNumUpdates();
+            }
+            if (count != lastCount)
+            {
+                lastCount = count;
+                lastChangeTime = GetFPGATime();
+            }
+            taskDelay(1);
+        }
+
+        TExit();
+    }   //WaitForClients
+
+    /**
+     * This function returns a latency percentile from the histogram.
+     *
+     * @param histogram Points to the latency histogram.
+     * @param total Specifies the number of samples in the histogram.
+     * @param percent Specifies the percentile.
+     *
+     * @return Returns the upper bound of the bucket holding the percentile
+     *         in usec.
+     */
+    UINT32
+    GetPercentile(
+        UINT32 *histogram,
+        UINT32 total,
+        int percent
+        )
+    {
+        UINT32 threshold = (UINT32)((UINT64)total*percent/100);
+        UINT32 count = 0;
+        int i;
+
+        TLevel(UTIL);
+        TEnterMsg(("total=%d,percent=%d", total, percent));
+
+        for (i = 0; i < NTB_HIST_BUCKETS; i++)
+        {
+            count += histogram[i];
+            if (count > threshold)
+            {
+                break;
+            }
+        }
+
+        TExitMsg(("=%d", (i + 1)*NTB_HIST_WIDTH));
+        return (i + 1)*NTB_HIST_WIDTH;
+    }   //GetPercentile
+
+public:
+    /**
+     * Constructor for the class object.
+     */
+    NetTablesBench(
+        void
+        ): BenchCmd(MOD_NAME,
+                    "doubles|keys|trans|subtables "
+                    "[<clients> [<keys> [<loops> [<periodms>]]]]",
+                    "Benchmark NetworkTables over loopback: run <pattern> "
+                    "[<clients> [<keys> [<loops> [<periodms>]]]]")
+         , m_table(NULL)
+         , m_sequence(0)
+    {
+        TLevel(INIT);
+        TEnter();
+
+        memset(m_subTables, 0, sizeof(m_subTables));
+        memset(m_keys, 0, sizeof(m_keys));
+        memset(m_clients, 0, sizeof(m_clients));
+
+        TExit();
+    }   //NetTablesBench
+
+    /**
+     * Destructor for the class object.
+     */
+    virtual
+    ~NetTablesBench(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+        TExit();
+    }   //~NetTablesBench
+
+    /**
+     * This function runs the benchmark. One untimed loop is published
+     * first so that the key assignments are not counted. The server
+     * socket calls are those of the server side connections only.
+     *
+     * @param pattern Specifies the publish pattern.
+     * @param numClients Specifies the number of loopback clients.
+     * @param numKeys Specifies the number of keys.
+     * @param numLoops Specifies the number of publish loops.
+     * @param period Specifies the time between loops in msec. If zero,
+     *        the loops only yield to tasks of the same priority.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    Run(
+        int pattern,
+        int numClients,
+        int numKeys,
+        int numLoops,
+        int period
+        )
+    {
+        int rc = ERR_SUCCESS;
+        int numStarted = 0;
+
+        TLevel(API);
+        TEnterMsg(("pattern=%d,clients=%d,keys=%d,loops=%d,period=%d",
+                   pattern, numClients, numKeys, numLoops, period));
+
+        if ((pattern < 0) || (pattern >= NTB_NUM_PATTERNS) ||
+            (numClients < 1) || (numClients > NTB_MAX_CLIENTS) ||
+            (numKeys < 1) || (numKeys > NTB_MAX_KEYS) ||
+            (numLoops < 1) || (period < 0))
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            if (m_table == NULL)
+            {
+                m_table = NetworkTable::GetTable(NTB_TABLE_NAME);
+            }
+            SetupKeys(pattern, numKeys);
+
+            for (numStarted = 0; numStarted < numClients; numStarted++)
+            {
+                m_clients[numStarted] = new NetTablesBenchClient();
+                if (!m_clients[numStarted]->Start())
+                {
+                    delete m_clients[numStarted];
+                    m_clients[numStarted] = NULL;
+                    rc = ERR_ASSERT;
+                    break;
+                }
+            }
+        }
+
+        if (rc == ERR_SUCCESS)
+        {
+            int periodTicks = period*sysClkRateGet()/1000;
+            UINT32 histogram[NTB_HIST_BUCKETS + 1];
+            UINT32 maxLatency = 0;
+            UINT32 numRecvs = 0;
+            UINT32 numSends = 0;
+            UINT32 numUpdates = 0;
+            UINT32 numPuts = (UINT32)numLoops*numKeys;
+            UINT32 startWrites, startReads, endWrites, endReads;
+            UINT32 startTime, publishTime, endTime;
+            MEM_PART_STATS startMem;
+            MEM_PART_STATS endMem;
+
+            //
+            // Give the server time to accept the clients, then send the
+            // key assignments and the first values.
+            //
+            Wait(0.5);
+            PublishLoop(pattern, numKeys);
+            WaitForClients(numClients);
+            for (int i = 0; i < numClients; i++)
+            {
+                m_clients[i]->ResetStats();
+            }
+
+            memPartInfoGet(memSysPartId, &startMem);
+            NetworkTables::ConnectionManager::GetInstance()->GetSocketCalls(
+                &startWrites, &startReads);
+            startTime = GetFPGATime();
+            for (int loop = 0; loop < numLoops; loop++)
+            {
+                PublishLoop(pattern, numKeys);
+                taskDelay(periodTicks);
+            }
+            publishTime = GetFPGATime();
+            WaitForClients(numClients);
+            endTime = GetFPGATime() - NTB_SETTLE_TIME;
+            memPartInfoGet(memSysPartId, &endMem);
+            NetworkTables::ConnectionManager::GetInstance()->GetSocketCalls(
+                &endWrites, &endReads);
+
+            memset(histogram, 0, sizeof(histogram));
+            for (int i = 0; i < numClients; i++)
+            {
+                numUpdates += m_clients[i]->GetNumUpdates();
+                m_clients[i]->AddStats(histogram, &maxLatency,
+                                       &numRecvs, &numSends);
+            }
+
+            printf("NetTablesBench: %s, %d clients x %d keys x %d loops, period=%dms\n",
+                   g_NetTablesPatternNames[pattern], numClients, numKeys,
+                   numLoops, period);
+            printf("Puts=%d (%.0f/s), Delivered=%d (%.0f/s), Delivered/Put=%.2f\n",
+                   numPuts, numPuts*1e6/(publishTime - startTime),
+                   numUpdates, numUpdates*1e6/(endTime - startTime),
+                   (double)numUpdates/(numPuts*numClients));
+            if (numUpdates > 0)
+            {
+                printf("Latency(us): p50<%d p90<%d p99<%d max=%d\n",
+                       GetPercentile(histogram, numUpdates, 50),
+                       GetPercentile(histogram, numUpdates, 90),
+                       GetPercentile(histogram, numUpdates, 99),
+                       maxLatency);
+                printf("Server writes/update=%.3f, reads/update=%.3f, "
+                       "Client recvs/update=%.3f, sends/update=%.3f\n",
+                       (double)(endWrites - startWrites)/numUpdates,
+                       (double)(endReads - startReads)/numUpdates,
+                       (double)numRecvs/numUpdates,
+                       (double)numSends/numUpdates);
+            }
+            printf("HeapBlocks=%+d, HeapBytes=%+d\n",
+                   (int)(endMem.numBlocksAlloc - startMem.numBlocksAlloc),
+                   (int)(endMem.numBytesAlloc - startMem.numBytesAlloc));
+            NetworkTables::FreeList::PrintStats();
+        }
+
+        for (int i = 0; i < numStarted; i++)
+        {
+            delete m_clients[i];
+            m_clients[i] = NULL;
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //Run
+
+    /**
+     * This function runs the benchmark from the console command.
+     *
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    RunCmd(
+        char **apszArgs,
+        int    cArgs
+        )
+    {
+        int rc;
+        int pattern = NTB_NUM_PATTERNS;
+
+        TLevel(CALLBK);
+        TEnterMsg(("pArgs=%p,cArgs=%d", apszArgs, cArgs));
+
+        if ((cArgs >= 1) && (cArgs <= 5))
+        {
+            for (pattern = 0; pattern < NTB_NUM_PATTERNS; pattern++)
+            {
+                if (strcmp(apszArgs[0], g_NetTablesPatternNames[pattern]) == 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (pattern == NTB_NUM_PATTERNS)
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            rc = Run(pattern,
+                     (cArgs >= 2)? atoi(apszArgs[1]): NTB_DEF_CLIENTS,
+                     (cArgs >= 3)? atoi(apszArgs[2]): NTB_DEF_KEYS,
+                     (cArgs >= 4)? atoi(apszArgs[3]): NTB_DEF_LOOPS,
+                     (cArgs >= 5)? atoi(apszArgs[4]): NTB_DEF_PERIOD);
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //RunCmd
+
+};  //class NetTablesBench
+
+#endif  //ifndef _NETTABLESBENCH_H
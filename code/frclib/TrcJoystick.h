@@ -135,6 +135,7 @@ private:
     ButtonNotify   *m_notify;
     DriverStation  *m_ds;
     UINT16          m_prevBtn;
+    DriverStation::ControlData m_controlData;
 #ifdef _LOGDATA_JOYSTICK
     float           m_xAxis;
     float           m_yAxis;
@@ -161,7 +162,8 @@ public:
         TEnterMsg(("Joystick=%d,notify=%p", port, notify));
 
         m_ds = DriverStation::GetInstance();
-        m_prevBtn = m_ds->GetStickButtons(port);
+        m_ds->GetControlData(&m_controlData);
+        m_prevBtn = GetLatchedButtons();
 
 #ifdef _LOGDATA_JOYSTICK
         DataLogger *dataLogger = DataLogger::GetInstance();
@@ -199,6 +201,112 @@ public:
         TExit();
     }   //~TrcJoystick
 
+    /**
+     * This function gets the X value of the joystick from the control data
+     * latched at the start of this loop.
+     *
+     * @param hand Specifies the handedness of the joystick (default to right
+     *        hand).
+     */
+    float
+    GetX(
+        JoystickHand hand = kRightHand
+        )
+    {
+        float value;
+
+        TLevel(HIFREQ);
+        TEnterMsg(("hand=%d", hand));
+
+        value = GetLatchedAxis(GetAxisChannel(kXAxis));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetX
+
+    /**
+     * This function gets the Y value of the joystick from the control data
+     * latched at the start of this loop.
+     *
+     * @param hand Specifies the handedness of the joystick (default to right
+     *        hand).
+     */
+    float
+    GetY(
+        JoystickHand hand = kRightHand
+        )
+    {
+        float value;
+
+        TLevel(HIFREQ);
+        TEnterMsg(("hand=%d", hand));
+
+        value = GetLatchedAxis(GetAxisChannel(kYAxis));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetY
+
+    /**
+     * This function gets the Z value of the joystick from the control data
+     * latched at the start of this loop.
+     */
+    float
+    GetZ(
+        void
+        )
+    {
+        float value;
+
+        TLevel(HIFREQ);
+        TEnter();
+
+        value = GetLatchedAxis(GetAxisChannel(kZAxis));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetZ
+
+    /**
+     * This function gets the twist value of the joystick from the control
+     * data latched at the start of this loop.
+     */
+    float
+    GetTwist(
+        void
+        )
+    {
+        float value;
+
+        TLevel(HIFREQ);
+        TEnter();
+
+        value = GetLatchedAxis(GetAxisChannel(kTwistAxis));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetTwist
+
+    /**
+     * This function gets the throttle value of the joystick from the control
+     * data latched at the start of this loop.
+     */
+    float
+    GetThrottle(
+        void
+        )
+    {
+        float value;
+
+        TLevel(HIFREQ);
+        TEnter();
+
+        value = GetLatchedAxis(GetAxisChannel(kThrottleAxis));
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetThrottle
+
     /**
      * This function gets the X value of the joystick with deadband.
      *
@@ -371,7 +479,13 @@ public:
         TLevel(TASK);
         TEnterMsg(("mode=%d", mode));
 
-        UINT16 currBtn = m_ds->GetStickButtons(m_port);
+        //
+        // Latch one coherent copy of the driver station packet so that the
+        // buttons and every axis read during this loop come from the same
+        // packet.
+        //
+        m_ds->GetControlData(&m_controlData);
+        UINT16 currBtn = GetLatchedButtons();
         if (m_notify != NULL)
         {
             UINT16 changedBtn = m_prevBtn^currBtn;
@@ -413,6 +527,58 @@ public:
         TExit();
     }   //TaskPrePeriodic
 
+private:
+    /**
+     * This function returns an axis value from the latched control data.
+     *
+     * @param axis Specifies the axis channel (1-based).
+     *
+     * @return Returns the axis value, or 0.0 if the axis is out of range.
+     */
+    float
+    GetLatchedAxis(
+        UINT32 axis
+        )
+    {
+        float value = 0.0;
+
+        TLevel(HIFREQ);
+        TEnterMsg(("axis=%d", axis));
+
+        if (m_port >= 1 && m_port <= DriverStation::kJoystickPorts &&
+            axis >= 1 && axis <= DriverStation::kJoystickAxes)
+        {
+            value = m_controlData.stickAxes[m_port - 1][axis - 1];
+        }
+
+        TExitMsg(("=%f", value));
+        return value;
+    }   //GetLatchedAxis
+
+    /**
+     * This function returns the button states from the latched control data.
+     *
+     * @return Returns the button states, or 0 if the port is out of range.
+     */
+    UINT16
+    GetLatchedButtons(
+        void
+        )
+    {
+        UINT16 buttons = 0;
+
+        TLevel(HIFREQ);
+        TEnter();
+
+        if (m_port >= 1 && m_port <= DriverStation::kJoystickPorts)
+        {
+            buttons = m_controlData.stickButtons[m_port - 1];
+        }
+
+        TExitMsg(("=%x", buttons));
+        return buttons;
+    }   //GetLatchedButtons
+
 };  //class TrcJoystick
 
 #endif  //ifndef _TRCJOYSTICK_H
@@ -0,0 +1,624 @@
+#if 0
+/// Copyright (c) Titan Robotics Club. All rights reserved.
+///
+/// <module name="VisionBench.h" />
+///
+/// <summary>
+///     This module contains the definitions and implementation of the
+///     VisionBench class.
+/// </summary>
+///
+/// <remarks>
+///     Environment: Wind River C++ for National Instrument cRIO based Robot.
+/// </remarks>
+#endif
+
+#ifndef _VISIONBENCH_H
+#define _VISIONBENCH_H
+
+#ifdef MOD_ID
+#undef MOD_ID
+#endif
+#define MOD_ID                  MOD_VISION
+#ifdef MOD_NAME
+#undef MOD_NAME
+#endif
+#define MOD_NAME                "VisionBench"
+
+#define VB_MAX_FRAMES           64
+#define VB_MAX_RESULTS          8
+#define VB_MAX_PATH             128
+#define VB_GOLDEN_FILE          "golden.txt"
+#define VB_GOLDEN_TOLERANCE     0.01
+#define VB_DEF_ITERATIONS       10
+
+typedef struct _VisionBenchFrame
+{
+    char    fileName[VB_MAX_PATH];
+    bool    fHasGolden;
+    int     numGolden;
+    float   golden[VB_MAX_RESULTS];
+    int     numResults;
+    float   results[VB_MAX_RESULTS];
+    int     numMismatches;
+} VB_FRAME, *PVB_FRAME;
+
+static const char *g_VisionStageNames[VT_NUM_STAGES] =
+{
+    "Acquire",
+    "Threshold",
+    "BigObj",
+    "ConvexHull",
+    "Filter",
+    "Report"
+};
+
+/**
+ * This abstract class defines the VisionBenchNotify object. The object is
+ * a callback interface. It is not meant to be created as an object.
+ * Instead, it should be inherited by a subclass who interprets the targets
+ * found by the vision task, so that the benchmark covers the same path the
+ * robot uses.
+ */
+class VisionBenchNotify
+{
+public:
+    /**
+     * This function is provided by the subclass to retrieve the targets
+     * found in the last processed image and return the detection results.
+     *
+     * @param results Points to the array to hold the detection results.
+     * @param maxResults Specifies the size of the results array.
+     *
+     * @return Returns the number of detection results.
+     */
+    virtual
+    int
+    GetBenchResults(
+        float *results,
+        int    maxResults
+        ) = 0;
+};  //class VisionBenchNotify
+
+/**
+ * This class defines and implements the VisionBench object. The object
+ * runs the vision pipeline over a directory of recorded JPEG images. It
+ * reports the time spent in each pipeline stage, the frame rate, the
+ * number of allocations and the detection results. The detection results
+ * are checked against a golden file in the same directory. If there is no
+ * golden file, one is written from the first pass so that later runs can
+ * detect regressions. The benchmark is started from the console:
+ *   VisionBench.run <dir> [<iterations>]
+ */
+class VisionBench: public BenchCmd
+{
+private:
+    VisionTask         *m_visionTask;
+    VisionBenchNotify  *m_notify;
+    PVB_FRAME           m_frames;
+    int                 m_numFrames;
+    PerfData            m_stagePerf[VT_NUM_STAGES];
+    PerfData            m_framePerf;
+
+    /**
+     * This function checks if the file name has a JPEG extension.
+     *
+     * @param fileName Specifies the file name.
+     *
+     * @return Returns true if it is a JPEG file, false otherwise.
+     */
+    bool
+    IsJpegFile(
+        const char *fileName
+        )
+    {
+        static const char *ext = ".jpg";
+        bool fJpeg = true;
+        int len = strlen(fileName);
+        int extLen = strlen(ext);
+
+        TLevel(UTIL);
+        TEnterMsg(("file=%s", fileName));
+
+        if (len <= extLen)
+        {
+            fJpeg = false;
+        }
+        else
+        {
+            for (int i = 0; i < extLen; i++)
+            {
+                if (tolower(fileName[len - extLen + i]) != ext[i])
+                {
+                    fJpeg = false;
+                    break;
+                }
+            }
+        }
+
+        TExitMsg(("=%x", fJpeg));
+        return fJpeg;
+    }   //IsJpegFile
+
+    /**
+     * This function builds the list of JPEG files in the directory, sorted
+     * by name so that every run processes them in the same order.
+     *
+     * @param dirPath Specifies the directory path.
+     *
+     * @return Returns the number of image files found.
+     */
+    int
+    LoadFrameList(
+        const char *dirPath
+        )
+    {
+        DIR *dir;
+        struct dirent *entry;
+
+        TLevel(FUNC);
+        TEnterMsg(("dir=%s", dirPath));
+
+        m_numFrames = 0;
+        dir = opendir(dirPath);
+        if (dir == NULL)
+        {
+            TErr(("Failed to open directory %s.", dirPath));
+        }
+        else
+        {
+            while ((m_numFrames < VB_MAX_FRAMES) &&
+                   ((entry = readdir(dir)) != NULL))
+            {
+                if (IsJpegFile(entry->d_name) &&
+                    (strlen(entry->d_name) < VB_MAX_PATH))
+                {
+                    //
+                    // Insertion sort by name.
+                    //
+                    int i = m_numFrames;
+                    while ((i > 0) &&
+                           (strcmp(m_frames[i - 1].fileName,
+                                   entry->d_name) > 0))
+                    {
+                        m_frames[i] = m_frames[i - 1];
+                        i--;
+                    }
+                    memset(&m_frames[i], 0, sizeof(VB_FRAME));
+                    strcpy(m_frames[i].fileName, entry->d_name);
+                    m_numFrames++;
+                }
+            }
+            closedir(dir);
+        }
+
+        TExitMsg(("=%d", m_numFrames));
+        return m_numFrames;
+    }   //LoadFrameList
+
+    /**
+     * This function finds the frame with the given file name.
+     *
+     * @param fileName Specifies the file name.
+     *
+     * @return Returns the frame if found, NULL otherwise.
+     */
+    PVB_FRAME
+    FindFrame(
+        const char *fileName
+        )
+    {
+        PVB_FRAME frame = NULL;
+
+        TLevel(UTIL);
+        TEnterMsg(("file=%s", fileName));
+
+        for (int i = 0; i < m_numFrames; i++)
+        {
+            if (strcmp(m_frames[i].fileName, fileName) == 0)
+            {
+                frame = &m_frames[i];
+                break;
+            }
+        }
+
+        TExitMsg(("=%p", frame));
+        return frame;
+    }   //FindFrame
+
+    /**
+     * This function loads the golden results of the frames. Each line of
+     * the golden file contains a file name, the number of results and the
+     * results.
+     *
+     * @param goldenPath Specifies the path of the golden file.
+     *
+     * @return Returns true if the golden file is loaded, false otherwise.
+     */
+    bool
+    LoadGolden(
+        const char *goldenPath
+        )
+    {
+        bool fLoaded = false;
+        FILE *file;
+
+        TLevel(FUNC);
+        TEnterMsg(("file=%s", goldenPath));
+
+        file = fopen(goldenPath, "r");
+        if (file != NULL)
+        {
+            char fileName[VB_MAX_PATH];
+            int numResults;
+
+            while (fscanf(file, "%127s %d", fileName, &numResults) == 2)
+            {
+                PVB_FRAME frame = FindFrame(fileName);
+                float value;
+
+                for (int i = 0; i < numResults; i++)
+                {
+                    if (fscanf(file, "%f", &value) != 1)
+                    {
+                        break;
+                    }
+                    if ((frame != NULL) && (i < VB_MAX_RESULTS))
+                    {
+                        frame->golden[i] = value;
+                    }
+                }
+
+                if (frame != NULL)
+                {
+                    frame->numGolden = (numResults < VB_MAX_RESULTS)?
+                                       numResults: VB_MAX_RESULTS;
+                    frame->fHasGolden = true;
+                }
+            }
+            fclose(file);
+            fLoaded = true;
+        }
+
+        TExitMsg(("=%x", fLoaded));
+        return fLoaded;
+    }   //LoadGolden
+
+    /**
+     * This function writes the results of the frames as the golden file.
+     *
+     * @param goldenPath Specifies the path of the golden file.
+     *
+     * @return Returns true if the golden file is written, false otherwise.
+     */
+    bool
+    WriteGolden(
+        const char *goldenPath
+        )
+    {
+        bool fWritten = false;
+        FILE *file;
+
+        TLevel(FUNC);
+        TEnterMsg(("file=%s", goldenPath));
+
+        file = fopen(goldenPath, "w");
+        if (file == NULL)
+        {
+            TErr(("Failed to create golden file %s.", goldenPath));
+        }
+        else
+        {
+            for (int i = 0; i < m_numFrames; i++)
+            {
+                fprintf(file, "%s %d",
+                        m_frames[i].fileName, m_frames[i].numResults);
+                for (int j = 0; j < m_frames[i].numResults; j++)
+                {
+                    fprintf(file, " %f", m_frames[i].results[j]);
+                }
+                fprintf(file, "\n");
+            }
+            fclose(file);
+            fWritten = true;
+        }
+
+        TExitMsg(("=%x", fWritten));
+        return fWritten;
+    }   //WriteGolden
+
+    /**
+     * This function runs one frame through the pipeline and checks its
+     * detection results against the golden results if there are any.
+     *
+     * @param frame Points to the frame.
+     * @param dirPath Specifies the directory path.
+     */
+    void
+    RunFrame(
+        PVB_FRAME frame,
+        const char *dirPath
+        )
+    {
+        char filePath[2*VB_MAX_PATH];
+
+        TLevel(FUNC);
+        TEnterMsg(("frame=%s", frame->fileName));
+
+        snprintf(filePath, sizeof(filePath), "%s/%s",
+                 dirPath, frame->fileName);
+        m_framePerf.StartPerf();
+        if (m_visionTask->ProcessImageFile(filePath))
+        {
+            frame->numResults = m_notify->GetBenchResults(frame->results,
+                                                          VB_MAX_RESULTS);
+        }
+        else
+        {
+            //
+            // Don't let the targets of the previous image count for this
+            // one.
+            //
+            frame->numResults = 0;
+        }
+        m_framePerf.EndPerf();
+
+        if (frame->fHasGolden)
+        {
+            bool fMatch = frame->numResults == frame->numGolden;
+
+            for (int i = 0; fMatch && (i < frame->numResults); i++)
+            {
+                fMatch = fabs(frame->results[i] - frame->golden[i]) <=
+                         VB_GOLDEN_TOLERANCE;
+            }
+
+            if (!fMatch)
+            {
+                frame->numMismatches++;
+            }
+        }
+
+        TExit();
+    }   //RunFrame
+
+public:
+    /**
+     * Constructor for the class object.
+     *
+     * @param visionTask Points to the vision task to benchmark.
+     * @param notify Points to the object that returns the detection results.
+     */
+    VisionBench(
+        VisionTask *visionTask,
+        VisionBenchNotify *notify
+        ): BenchCmd(MOD_NAME, "<dir> [<iterations>]",
+                    "Benchmark vision on recorded images: run <dir> [<iterations>]")
+         , m_visionTask(visionTask)
+         , m_notify(notify)
+         , m_frames(NULL)
+         , m_numFrames(0)
+    {
+        TLevel(INIT);
+        TEnterMsg(("visionTask=%p,notify=%p", visionTask, notify));
+        TExit();
+    }   //VisionBench
+
+    /**
+     * Destructor for the class object.
+     */
+    virtual
+    ~VisionBench(
+        void
+        )
+    {
+        TLevel(INIT);
+        TEnter();
+
+        if (m_frames != NULL)
+        {
+            delete [] m_frames;
+            m_frames = NULL;
+        }
+
+        TExit();
+    }   //~VisionBench
+
+    /**
+     * This function runs the benchmark. The first pass warms up the
+     * pipeline and is not timed. Camera images are not processed while the
+     * benchmark runs.
+     *
+     * @param dirPath Specifies the directory of the recorded images.
+     * @param numIterations Specifies the number of timed passes over the
+     *        images.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    Run(
+        const char *dirPath,
+        int numIterations
+        )
+    {
+        int rc = ERR_SUCCESS;
+        char goldenPath[2*VB_MAX_PATH];
+        bool fHasGolden;
+        MEM_PART_STATS startMem;
+        MEM_PART_STATS endMem;
+        UINT32 startAllocs;
+        UINT32 numAllocs;
+        UINT32 numTimedFrames;
+        int numMismatches = 0;
+
+        TLevel(API);
+        TEnterMsg(("dir=%s,iterations=%d", dirPath, numIterations));
+
+        if (m_frames == NULL)
+        {
+            m_frames = new VB_FRAME[VB_MAX_FRAMES];
+        }
+
+        if (numIterations <= 0)
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else if (LoadFrameList(dirPath) == 0)
+        {
+            printf("Error: no JPEG images found in %s.\n", dirPath);
+            rc = ERR_OBJ_NOT_FOUND;
+        }
+        else
+        {
+            snprintf(goldenPath, sizeof(goldenPath), "%s/%s",
+                     dirPath, VB_GOLDEN_FILE);
+            fHasGolden = LoadGolden(goldenPath);
+
+            m_visionTask->SetBenchmarkMode(true);
+            //
+            // Warm up pass, NI vision allocates some of its buffers on
+            // first use.
+            //
+            for (int i = 0; i < m_numFrames; i++)
+            {
+                RunFrame(&m_frames[i], dirPath);
+            }
+            if (!fHasGolden && WriteGolden(goldenPath))
+            {
+                printf("Golden results written to %s.\n", goldenPath);
+            }
+
+            for (int i = 0; i < VT_NUM_STAGES; i++)
+            {
+                m_stagePerf[i].StartPerfPeriod();
+            }
+            m_framePerf.StartPerfPeriod();
+            m_visionTask->SetStagePerfData(m_stagePerf);
+            startAllocs = m_visionTask->GetAllocCount();
+            memPartInfoGet(memSysPartId, &startMem);
+
+            for (int n = 0; n < numIterations; n++)
+            {
+                for (int i = 0; i < m_numFrames; i++)
+                {
+                    RunFrame(&m_frames[i], dirPath);
+                }
+            }
+
+            memPartInfoGet(memSysPartId, &endMem);
+            numAllocs = m_visionTask->GetAllocCount() - startAllocs;
+            m_visionTask->SetStagePerfData(NULL);
+            m_framePerf.EndPerfPeriod();
+            for (int i = 0; i < VT_NUM_STAGES; i++)
+            {
+                m_stagePerf[i].EndPerfPeriod();
+            }
+            m_visionTask->SetBenchmarkMode(false);
+
+            //
+            // Report results.
+            //
+            numTimedFrames = m_framePerf.GetPerfCount();
+            printf("VisionBench: %d images x %d iterations\n",
+                   m_numFrames, numIterations);
+            printf("%10s %8s %8s %8s\n", "Stage", "Min(us)", "Avg(us)",
+                   "Max(us)");
+            for (int i = 0; i < VT_NUM_STAGES; i++)
+            {
+                UINT32 count = m_stagePerf[i].GetPerfCount();
+
+                printf("%10s %8d %8d %8d\n",
+                       g_VisionStageNames[i],
+                       m_stagePerf[i].GetPerfMinTime(),
+                       (count > 0)?
+                            m_stagePerf[i].GetPerfTotalTime()/count: 0,
+                       m_stagePerf[i].GetPerfMaxTime());
+            }
+            printf("%10s %8d %8d %8d\n",
+                   "Frame",
+                   m_framePerf.GetPerfMinTime(),
+                   (numTimedFrames > 0)?
+                        m_framePerf.GetPerfTotalTime()/numTimedFrames: 0,
+                   m_framePerf.GetPerfMaxTime());
+            printf("FPS=%5.1f, Allocs/frame=%5.2f, HeapBlocks=%+d, HeapBytes=%+d\n",
+                   (m_framePerf.GetPerfPeriodTime() > 0)?
+                        numTimedFrames*1000000.0/
+                        m_framePerf.GetPerfPeriodTime(): 0.0,
+                   (numTimedFrames > 0)?
+                        (float)numAllocs/numTimedFrames: 0.0,
+                   (int)(endMem.numBlocksAlloc - startMem.numBlocksAlloc),
+                   (int)(endMem.numBytesAlloc - startMem.numBytesAlloc));
+
+            for (int i = 0; i < m_numFrames; i++)
+            {
+                printf("%s:", m_frames[i].fileName);
+                for (int j = 0; j < m_frames[i].numResults; j++)
+                {
+                    printf(" %7.2f", m_frames[i].results[j]);
+                }
+                if (!m_frames[i].fHasGolden)
+                {
+                    printf(" (no golden)\n");
+                }
+                else if (m_frames[i].numMismatches > 0)
+                {
+                    printf(" MISMATCH (%d of %d passes)\n",
+                           m_frames[i].numMismatches, numIterations + 1);
+                    numMismatches++;
+                }
+                else
+                {
+                    printf(" OK\n");
+                }
+            }
+
+            if (fHasGolden && (numMismatches > 0))
+            {
+                printf("%d of %d images do not match golden results.\n",
+                       numMismatches, m_numFrames);
+                rc = ERR_ASSERT;
+            }
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //Run
+
+    /**
+     * This function runs the benchmark from the console command.
+     *
+     * @param apszArgs Points to the array of command arguments.
+     * @param cArgs Specifies the number of command arguments.
+     *
+     * @return Success Returns ERR_SUCCESS.
+     * @return Failure Returns error code.
+     */
+    int
+    RunCmd(
+        char **apszArgs,
+        int    cArgs
+        )
+    {
+        int rc;
+
+        TLevel(CALLBK);
+        TEnterMsg(("pArgs=%p,cArgs=%d", apszArgs, cArgs));
+
+        if ((cArgs < 1) || (cArgs > 2))
+        {
+            rc = ERR_INVALID_PARAM;
+        }
+        else
+        {
+            rc = Run(apszArgs[0],
+                     (cArgs == 2)? atoi(apszArgs[1]): VB_DEF_ITERATIONS);
+        }
+
+        TExitMsg(("=%d", rc));
+        return rc;
+    }   //RunCmd
+
+};  //class VisionBench
+
+#endif  //ifndef _VISIONBENCH_H
@@ -30,6 +30,75 @@
 
 #define VTF_ENABLED             0x00000001
 #define VTF_ONE_SHOT            0x00000002
+#define VTF_ADAPTIVE_RATE       0x00000004
+#define VTF_FAST_TRACKING       0x00000008
+#define VTF_BENCHMARK           0x00000010
+
+//
+// Pipeline stages that can be timed.
+//
+#define VT_STAGE_ACQUIRE        0
+#define VT_STAGE_THRESHOLD      1
+#define VT_STAGE_BIGOBJ         2
+#define VT_STAGE_CONVEXHULL     3
+#define VT_STAGE_FILTER         4
+#define VT_STAGE_REPORT         5
+#define VT_NUM_STAGES           6
+
+#define VT_MAX_TARGETS          8
+
+/**
+ * The targets found in a frame. Frame number and capture time tell how old
+ * the targets are. Latency is the time from capture to publication.
+ */
+typedef struct _VisionTargets
+{
+    UINT32                  frameNumber;
+    UINT32                  frameTime;
+    UINT32                  latency;
+    int                     numTargets;
+    ParticleAnalysisReport  targets[VT_MAX_TARGETS];
+} VISION_TARGETS, *PVISION_TARGETS;
+
+//
+// Adaptive rate control parameters.
+//
+#define VT_SMOOTHING            0.25    //weight of the newest time sample
+#define VT_STEP_DOWN_DELAY      500     //msec of overload before stepping down
+#define VT_STEP_UP_DELAY        2000    //msec of headroom before stepping up
+#define VT_HEADROOM_RATIO       0.5     //step up below this portion of budget
+#define VT_LOOP_LOAD_HIGH       0.9
+#define VT_LOOP_LOAD_LOW        0.7
+#define VT_TRACKING_LOAD_HIGH   1.0     //leave tracking rate above this
+#define VT_TRACKING_LOAD_LOW    0.8     //return to tracking rate below this
+#define VT_TRACKING_DWELL       1000    //msec before returning to tracking rate
+
+/**
+ * An operating point of the vision subsystem. The resolution is given as a
+ * divisor of the reference resolution the camera was configured with.
+ */
+typedef struct _VisionOpPoint
+{
+    int     resDivisor;
+    int     maxFPS;
+    float   waitPeriod;
+} VISION_OPPOINT, *PVISION_OPPOINT;
+
+//
+// Operating points in increasing order of CPU cost. The last one is only
+// used while fast tracking a target.
+//
+static const VISION_OPPOINT g_VisionOpPoints[] =
+{
+    {2, 5,  0.20},
+    {2, 10, 0.10},
+    {1, 10, 0.05},
+    {1, 15, 0.02},
+    {1, 30, 0.01}
+};
+#define VT_NUM_OPPOINTS         ((int)ARRAYSIZE(g_VisionOpPoints))
+#define VT_TRACKING_OPPOINT     (VT_NUM_OPPOINTS - 1)
+#define VT_NORMAL_OPPOINT       (VT_NUM_OPPOINTS - 2)
 
 static
 void
@@ -54,240 +123,803 @@ private:
     int                      m_numCriteria;
     float                    m_taskWaitPeriod;
 
-    vector<ParticleAnalysisReport> *m_targets;
+    //
+    // Published targets are double buffered. m_publishSeq selects the buffer
+    // with the latest targets, m_writeSeq tells readers that a buffer is
+    // being overwritten.
+    //
+    VISION_TARGETS           m_targetBuffers[2];
+    volatile UINT32          m_writeSeq;
+    volatile UINT32          m_publishSeq;
+    UINT32                   m_fileFrameNumber;
     UINT32                   m_vtFlags;
     Task                     m_task;
     SEM_ID                   m_semaphore;
+    SEM_ID                   m_frameSemaphore;
     ColorImage               m_cameraImage;
+    PerfData                *m_stagePerf;
+    UINT32                   m_allocCount;
+    //
+    // Adaptive rate control.
+    //
+    AxisCamera::Resolution_t m_refResolution;
+    ParticleFilterCriteria2 *m_scaledCriteria;
+    int                      m_scaledDivisor;
+    int                      m_opPoint;
+    float                    m_cpuBudget;
+    float                    m_loopLoad;
+    UINT32                   m_procTime;
+    UINT32                   m_latency;
+    UINT32                   m_savedProcTime;
+    UINT32                   m_savedLatency;
+    UINT32                   m_overloadStartTime;
+    UINT32                   m_headroomStartTime;
+    UINT32                   m_trackingDropTime;
 
-public:
+    /**
+     * This function returns the image width of a camera resolution.
+     *
+     * @param resolution Specifies the camera resolution.
+     *
+     * @return Returns the image width in pixels.
+     */
+    int
+    GetResolutionWidth(
+        AxisCamera::Resolution_t resolution
+        )
+    {
+        int width;
+
+        TLevel(UTIL);
+        TEnterMsg(("resolution=%d", resolution));
+
+        switch (resolution)
+        {
+        case AxisCamera::kResolution_640x480:
+        case AxisCamera::kResolution_640x360:
+            width = 640;
+            break;
+
+        case AxisCamera::kResolution_160x120:
+            width = 160;
+            break;
+
+        default:
+            width = 320;
+            break;
+        }
+
+        TExitMsg(("=%d", width));
+        return width;
+    }   //GetResolutionWidth
 
     /**
-     * This function checks for a fresh image and search for targets.
+     * This function returns the reference resolution reduced by the given
+     * divisor. Only halving 640x480 and 320x240 is supported, any other
+     * combination returns the reference resolution.
+     *
+     * @param resDivisor Specifies the resolution divisor.
+     *
+     * @return Returns the reduced resolution.
+     */
+    AxisCamera::Resolution_t
+    GetScaledResolution(
+        int resDivisor
+        )
+    {
+        AxisCamera::Resolution_t resolution = m_refResolution;
+
+        TLevel(UTIL);
+        TEnterMsg(("divisor=%d", resDivisor));
+
+        if (resDivisor == 2)
+        {
+            if (m_refResolution == AxisCamera::kResolution_640x480)
+            {
+                resolution = AxisCamera::kResolution_320x240;
+            }
+            else if (m_refResolution == AxisCamera::kResolution_320x240)
+            {
+                resolution = AxisCamera::kResolution_160x120;
+            }
+        }
+
+        TExitMsg(("=%d", resolution));
+        return resolution;
+    }   //GetScaledResolution
+
+    /**
+     * This function returns the filter criteria adjusted for an image that
+     * is reduced from the reference resolution by the given divisor. Only
+     * the pixel position and size criteria are scaled.
+     *
+     * @param divisor Specifies the resolution divisor of the image.
+     *
+     * @return Returns the filter criteria to use.
+     */
+    ParticleFilterCriteria2 *
+    GetScaledCriteria(
+        int divisor
+        )
+    {
+        TLevel(FUNC);
+        TEnterMsg(("divisor=%d", divisor));
+
+        if ((divisor > 1) && (m_scaledCriteria != NULL))
+        {
+            if (divisor != m_scaledDivisor)
+            {
+                for (int i = 0; i < m_numCriteria; i++)
+                {
+                    m_scaledCriteria[i] = m_filterCriteria[i];
+                    switch (m_filterCriteria[i].parameter)
+                    {
+                    case IMAQ_MT_CENTER_OF_MASS_X:
+                    case IMAQ_MT_CENTER_OF_MASS_Y:
+                    case IMAQ_MT_BOUNDING_RECT_LEFT:
+                    case IMAQ_MT_BOUNDING_RECT_TOP:
+                    case IMAQ_MT_BOUNDING_RECT_RIGHT:
+                    case IMAQ_MT_BOUNDING_RECT_BOTTOM:
+                    case IMAQ_MT_BOUNDING_RECT_WIDTH:
+                    case IMAQ_MT_BOUNDING_RECT_HEIGHT:
+                        m_scaledCriteria[i].lower /= divisor;
+                        m_scaledCriteria[i].upper /= divisor;
+                        break;
+
+                    default:
+                        break;
+                    }
+                }
+                m_scaledDivisor = divisor;
+            }
+            TExitMsg(("=%p", m_scaledCriteria));
+            return m_scaledCriteria;
+        }
+
+        TExitMsg(("=%p", m_filterCriteria));
+        return m_filterCriteria;
+    }   //GetScaledCriteria
+
+    /**
+     * This function switches the camera and the task to the given operating
+     * point. Camera parameters are only written if they change because a
+     * resolution change restarts the image stream.
+     *
+     * @param opPoint Specifies the operating point index.
      */
     void
-    ProcessImage(
+    SetOperatingPoint(
+        int opPoint
+        )
+    {
+        const VISION_OPPOINT *op;
+        AxisCamera::Resolution_t resolution;
+
+        TLevel(FUNC);
+        TEnterMsg(("opPoint=%d", opPoint));
+
+        op = &g_VisionOpPoints[opPoint];
+        resolution = GetScaledResolution(op->resDivisor);
+        if (m_camera->GetMaxFPS() != op->maxFPS)
+        {
+            m_camera->WriteMaxFPS(op->maxFPS);
+        }
+        if (m_camera->GetResolution() != resolution)
+        {
+            m_camera->WriteResolution(resolution);
+        }
+        m_taskWaitPeriod = op->waitPeriod;
+        m_opPoint = opPoint;
+        m_overloadStartTime = 0;
+        m_headroomStartTime = 0;
+        TInfo(("OpPoint=%d (res=%d,fps=%d,wait=%4.2f),procTime=%d,loopLoad=%4.2f",
+               opPoint, resolution, op->maxFPS, op->waitPeriod,
+               m_procTime, m_loopLoad));
+
+        TExit();
+    }   //SetOperatingPoint
+
+    /**
+     * This function adjusts the operating point to keep the vision pipeline
+     * within its CPU budget and the main loop within its period. The vision
+     * load is estimated from the smoothed pipeline time and the frame rate
+     * of the current operating point. A step down or up is only taken after
+     * the condition has persisted for a while so that the camera is not
+     * reconfigured on every frame. While fast tracking, the tracking
+     * operating point is used unless the main loop is overrunning. Once
+     * it is given up, it is only taken back after the main loop has had
+     * clear headroom for a while, so a load hovering around the limit
+     * does not restart the camera stream on every frame.
+     */
+    void
+    AdjustOperatingPoint(
         void
         )
     {
+        const VISION_OPPOINT *op = &g_VisionOpPoints[m_opPoint];
+        float procTime = (float)m_procTime/1000000.0;
+        float frameRate = 1.0/(procTime + op->waitPeriod);
+        int opPoint = m_opPoint;
+        UINT32 currTime = GetMsecTime();
+
         TLevel(FUNC);
         TEnter();
 
+        if (frameRate > op->maxFPS)
+        {
+            frameRate = op->maxFPS;
+        }
+        float visionLoad = procTime*frameRate;
+
+        if (m_vtFlags & VTF_FAST_TRACKING)
+        {
+            if (opPoint == VT_TRACKING_OPPOINT)
+            {
+                if (m_loopLoad > VT_TRACKING_LOAD_HIGH)
+                {
+                    opPoint = VT_TRACKING_OPPOINT - 1;
+                    m_trackingDropTime = currTime;
+                }
+            }
+            else if (m_trackingDropTime == 0)
+            {
+                //
+                // Just started tracking.
+                //
+                if (m_loopLoad > VT_TRACKING_LOAD_HIGH)
+                {
+                    opPoint = VT_TRACKING_OPPOINT - 1;
+                    m_trackingDropTime = currTime;
+                }
+                else
+                {
+                    opPoint = VT_TRACKING_OPPOINT;
+                }
+            }
+            else if ((m_loopLoad < VT_TRACKING_LOAD_LOW) &&
+                     (currTime - m_trackingDropTime >= VT_TRACKING_DWELL))
+            {
+                opPoint = VT_TRACKING_OPPOINT;
+            }
+        }
+        else if (opPoint > VT_NORMAL_OPPOINT)
+        {
+            //
+            // Done tracking, drop back to the normal operating points.
+            //
+            opPoint = VT_NORMAL_OPPOINT;
+        }
+        else if ((visionLoad > m_cpuBudget) ||
+                 (m_loopLoad > VT_LOOP_LOAD_HIGH))
+        {
+            m_headroomStartTime = 0;
+            if (m_overloadStartTime == 0)
+            {
+                m_overloadStartTime = currTime;
+            }
+            else if ((currTime - m_overloadStartTime >= VT_STEP_DOWN_DELAY) &&
+                     (opPoint > 0))
+            {
+                opPoint--;
+            }
+        }
+        else if ((visionLoad < m_cpuBudget*VT_HEADROOM_RATIO) &&
+                 (m_loopLoad < VT_LOOP_LOAD_LOW))
+        {
+            m_overloadStartTime = 0;
+            if (m_headroomStartTime == 0)
+            {
+                m_headroomStartTime = currTime;
+            }
+            else if ((currTime - m_headroomStartTime >= VT_STEP_UP_DELAY) &&
+                     (opPoint < VT_NORMAL_OPPOINT))
+            {
+                opPoint++;
+            }
+        }
+        else
+        {
+            m_overloadStartTime = 0;
+            m_headroomStartTime = 0;
+        }
+
+        if (!(m_vtFlags & VTF_FAST_TRACKING))
+        {
+            m_trackingDropTime = 0;
+        }
+
+        if (opPoint != m_opPoint)
+        {
+            SetOperatingPoint(opPoint);
+        }
+
+        TExit();
+    }   //AdjustOperatingPoint
+
+    /**
+     * This function records the start time of a pipeline stage if stage
+     * timing is enabled.
+     *
+     * @param stage Specifies the pipeline stage.
+     */
+    void
+    StartStage(
+        int stage
+        )
+    {
+        TLevel(UTIL);
+        TEnterMsg(("stage=%d", stage));
+
+        if (m_stagePerf != NULL)
+        {
+            m_stagePerf[stage].StartPerf();
+        }
+
+        TExit();
+    }   //StartStage
+
+    /**
+     * This function records the end time of a pipeline stage if stage
+     * timing is enabled and counts the object allocated by the stage.
+     *
+     * @param stage Specifies the pipeline stage.
+     * @param obj Points to the object allocated by the stage, NULL if none.
+     */
+    void
+    EndStage(
+        int stage,
+        void *obj
+        )
+    {
+        TLevel(UTIL);
+        TEnterMsg(("stage=%d,obj=%p", stage, obj));
+
+        if (m_stagePerf != NULL)
+        {
+            m_stagePerf[stage].EndPerf();
+        }
+        if (obj != NULL)
+        {
+            m_allocCount++;
+        }
+
+        TExit();
+    }   //EndStage
+
+    /**
+     * This function publishes the targets of a frame without locking. The
+     * targets are written to the buffer not holding the latest targets and
+     * the buffer is then made the latest. There is only one writer because
+     * frames are processed under m_frameSemaphore.
+     *
+     * @param reports Points to the particle reports of the frame, ordered
+     *        by size.
+     * @param frameNumber Specifies the frame number.
+     * @param frameTime Specifies the time the frame was received in usec.
+     */
+    void
+    PublishTargets(
+        vector<ParticleAnalysisReport> *reports,
+        UINT32 frameNumber,
+        UINT32 frameTime
+        )
+    {
+        UINT32 seq = m_publishSeq + 1;
+        PVISION_TARGETS targets = &m_targetBuffers[seq & 1];
+        int numTargets = reports->size();
+
+        TLevel(FUNC);
+        TEnterMsg(("reports=%p,frame=%d,time=%d",
+                   reports, frameNumber, frameTime));
+
+        if (numTargets > VT_MAX_TARGETS)
+        {
+            numTargets = VT_MAX_TARGETS;
+        }
+
+        m_writeSeq = seq;
+        MemoryBarrier();
+        targets->frameNumber = frameNumber;
+        targets->frameTime = frameTime;
+        targets->numTargets = numTargets;
+        for (int i = 0; i < numTargets; i++)
+        {
+            targets->targets[i] = reports->at(i);
+        }
+        targets->latency = GetUsecTime() - frameTime;
+        MemoryBarrier();
+        m_publishSeq = seq;
+
+        if (m_vtFlags & VTF_ONE_SHOT)
+        {
+            CRITICAL_REGION(m_semaphore)
+            {
+                m_vtFlags &= ~VTF_ONE_SHOT;
+            }
+            END_REGION;
+        }
+
+        TExit();
+    }   //PublishTargets
+
+    /**
+     * This function searches the image in m_cameraImage for targets and
+     * publishes the target reports.
+     *
+     * @param procStartTime Specifies the time processing of the frame
+     *        started in usec.
+     * @param frameNumber Specifies the frame number.
+     * @param frameTime Specifies the time the frame was received in usec.
+     *
+     * @return Returns true if the target reports are published, false
+     *         otherwise.
+     */
+    bool
+    ProcessFrame(
+        UINT32 procStartTime,
+        UINT32 frameNumber,
+        UINT32 frameTime
+        )
+    {
+        bool fSuccess = false;
+        int err = ERR_SUCCESS;
+        BinaryImage *image = NULL;
+        BinaryImage *thresholdImage = NULL;
+        BinaryImage *bigObjImage = NULL;
+        BinaryImage *convexHullImage = NULL;
+        BinaryImage *filteredImage = NULL;
+        int divisor = 1;
 #ifdef _WRITE_IMAGES
         static bool fWroteImages = false;
 #endif
-        if (((m_vtFlags & (VTF_ENABLED | VTF_ONE_SHOT)) != 0) &&
-            m_camera->IsFreshImage())
-        {
-            int err = ERR_SUCCESS;
-            BinaryImage *image = NULL;
-            BinaryImage *thresholdImage = NULL;
-            BinaryImage *bigObjImage = NULL;
-            BinaryImage *convexHullImage = NULL;
-            BinaryImage *filteredImage = NULL;
 #ifdef _VISION_PERF
-            UINT32 totalTime = 0;
-            UINT32 startTime;
-            UINT32 deltaTime;
+        UINT32 totalTime = 0;
+        UINT32 startTime;
+        UINT32 deltaTime;
 #endif
 
+        TLevel(FUNC);
+        TEnterMsg(("startTime=%d,frame=%d,frameTime=%d",
+                   procStartTime, frameNumber, frameTime));
+
+        if (m_vtFlags & VTF_ADAPTIVE_RATE)
+        {
+            //
+            // The image may be smaller than the reference resolution, so
+            // pixel thresholds and results have to be scaled.
+            //
+            int width = m_cameraImage.GetWidth();
+            if (width > 0)
+            {
+                divisor = GetResolutionWidth(m_refResolution)/width;
+                if (divisor < 1)
+                {
+                    divisor = 1;
+                }
+            }
+        }
+        //
+        // Filter the image by color.
+        //
 #ifdef _VISION_PERF
-            startTime = GetMsecTime();
+        startTime = GetMsecTime();
 #endif
-            m_camera->GetImage(&m_cameraImage);
+        StartStage(VT_STAGE_THRESHOLD);
+        switch (m_imageType)
+        {
+        case IMAQ_IMAGE_RGB:
+            thresholdImage =
+                m_cameraImage.ThresholdRGB(*m_colorThresholds);
+            break;
+
+        case IMAQ_IMAGE_HSL:
+            thresholdImage =
+                m_cameraImage.ThresholdHSL(*m_colorThresholds);
+            break;
+
+        default:
+            TErr(("Unsupported image type (type=%d).", m_imageType));
+            break;
+        }
+        EndStage(VT_STAGE_THRESHOLD, thresholdImage);
 #ifdef _VISION_PERF
-            deltaTime = GetMsecTime() - startTime;
-            totalTime += deltaTime;
-            TInfo(("AcquireImageTime = %d", deltaTime));
+        deltaTime = GetMsecTime() - startTime;
+        totalTime += deltaTime;
+        TInfo(("ColorThresholdTime = %d", deltaTime));
 #endif
+        image = thresholdImage;
+
+        if (thresholdImage == NULL)
+        {
+            err = imaqGetLastError();
+            TErr(("Failed to filter image with thresholds (err=%d).",
+                  err));
+        }
+        else if (m_sizeThreshold > 0)
+        {
             //
-            // Filter the image by color.
+            // Remove small objects
             //
 #ifdef _VISION_PERF
             startTime = GetMsecTime();
 #endif
-            switch (m_imageType)
-            {
-            case IMAQ_IMAGE_RGB:
-                thresholdImage =
-                    m_cameraImage.ThresholdRGB(*m_colorThresholds);
-                break;
-
-            case IMAQ_IMAGE_HSL:
-                thresholdImage =
-                    m_cameraImage.ThresholdHSL(*m_colorThresholds);
-                break;
-
-            default:
-                TErr(("Unsupported image type (type=%d).", m_imageType));
-                break;
-            }
+            // Erosions are counted in pixels, so scale them with the resolution.
+            int erosions = m_sizeThreshold/divisor;
+            StartStage(VT_STAGE_BIGOBJ);
+            bigObjImage = image->RemoveSmallObjects(
+                            false, (erosions > 0)? erosions: 1);
+            EndStage(VT_STAGE_BIGOBJ, bigObjImage);
 #ifdef _VISION_PERF
             deltaTime = GetMsecTime() - startTime;
             totalTime += deltaTime;
-            TInfo(("ColorThresholdTime = %d", deltaTime));
+            TInfo(("BigObjFilterTime = %d", deltaTime));
 #endif
-            image = thresholdImage;
+            image = bigObjImage;
 
-            if (thresholdImage == NULL)
+            if (bigObjImage == NULL)
             {
                 err = imaqGetLastError();
-                TErr(("Failed to filter image with thresholds (err=%d).",
-                      err));
+                TErr(("Failed to filter image with size (err=%d).", err));
             }
-            else if (m_sizeThreshold > 0)
-            {
-                //
-                // Remove small objects
-                //
+        }
+
+        if (err == ERR_SUCCESS)
+        {
 #ifdef _VISION_PERF
-                startTime = GetMsecTime();
+            startTime = GetMsecTime();
 #endif
-                bigObjImage = image->RemoveSmallObjects(
-                                false, m_sizeThreshold);
+            StartStage(VT_STAGE_CONVEXHULL);
+            convexHullImage = image->ConvexHull(false);
+            EndStage(VT_STAGE_CONVEXHULL, convexHullImage);
 #ifdef _VISION_PERF
-                deltaTime = GetMsecTime() - startTime;
-                totalTime += deltaTime;
-                TInfo(("BigObjFilterTime = %d", deltaTime));
+            deltaTime = GetMsecTime() - startTime;
+            totalTime += deltaTime;
+            TInfo(("ConvexHullTime = %d", deltaTime));
 #endif
-                image = bigObjImage;
+            image = convexHullImage;
 
-                if (bigObjImage == NULL)
-                {
-                    err = imaqGetLastError();
-                    TErr(("Failed to filter image with size (err=%d).", err));
-                }
+            if (convexHullImage == NULL)
+            {
+                err = imaqGetLastError();
+                TErr(("Failed to generate Convex Hull image (err=%d).",
+                      err));
             }
+        }
 
-            if (err == ERR_SUCCESS)
-            {
+        if ((err == ERR_SUCCESS) && (m_filterCriteria != NULL))
+        {
 #ifdef _VISION_PERF
-                startTime = GetMsecTime();
+            startTime = GetMsecTime();
 #endif
-                convexHullImage = image->ConvexHull(false);
+            StartStage(VT_STAGE_FILTER);
+            filteredImage = image->ParticleFilter(
+                                GetScaledCriteria(divisor),
+                                m_numCriteria);
+            EndStage(VT_STAGE_FILTER, filteredImage);
 #ifdef _VISION_PERF
-                deltaTime = GetMsecTime() - startTime;
-                totalTime += deltaTime;
-                TInfo(("ConvexHullTime = %d", deltaTime));
+            deltaTime = GetMsecTime() - startTime;
+            totalTime += deltaTime;
+            TInfo(("ParticleFilterTime = %d", deltaTime));
 #endif
-                image = convexHullImage;
+            image = filteredImage;
 
-                if (convexHullImage == NULL)
-                {
-                    err = imaqGetLastError();
-                    TErr(("Failed to generate Convex Hull image (err=%d).",
-                          err));
-                }
+            if (filteredImage == NULL)
+            {
+                err = imaqGetLastError();
+                TErr(("Failed to filter image based on criteria (err=%d).",
+                      err));
             }
+        }
 
-            if ((err == ERR_SUCCESS) && (m_filterCriteria != NULL))
-            {
+        if (err == ERR_SUCCESS)
+        {
 #ifdef _VISION_PERF
-                startTime = GetMsecTime();
+            startTime = GetMsecTime();
 #endif
-                filteredImage = image->ParticleFilter(m_filterCriteria,
-                                                      m_numCriteria);
+            StartStage(VT_STAGE_REPORT);
+            vector<ParticleAnalysisReport> *reports =
+                    image->GetOrderedParticleAnalysisReports();
+            EndStage(VT_STAGE_REPORT, reports);
 #ifdef _VISION_PERF
-                deltaTime = GetMsecTime() - startTime;
-                totalTime += deltaTime;
-                TInfo(("ParticleFilterTime = %d", deltaTime));
+            deltaTime = GetMsecTime() - startTime;
+            totalTime += deltaTime;
+            TInfo(("GetReportTime = %d", deltaTime));
 #endif
-                image = filteredImage;
 
-                if (filteredImage == NULL)
-                {
-                    err = imaqGetLastError();
-                    TErr(("Failed to filter image based on criteria (err=%d).",
-                          err));
-                }
+            if (reports == NULL)
+            {
+                err = imaqGetLastError();
+                TErr(("Failed to get particle analysis reports (err=%d).",
+                      err));
             }
-
-            if (err == ERR_SUCCESS)
+            else
             {
-#ifdef _VISION_PERF
-                startTime = GetMsecTime();
-#endif
-                vector<ParticleAnalysisReport> *reports =
-                        image->GetOrderedParticleAnalysisReports();
-#ifdef _VISION_PERF
-                deltaTime = GetMsecTime() - startTime;
-                totalTime += deltaTime;
-                TInfo(("GetReportTime = %d", deltaTime));
-#endif
-
-                if (reports == NULL)
+                if (divisor > 1)
                 {
-                    err = imaqGetLastError();
-                    TErr(("Failed to get particle analysis reports (err=%d).",
-                          err));
+                    //
+                    // Report positions and sizes in reference resolution
+                    // pixels.
+                    //
+                    for (unsigned i = 0; i < reports->size(); i++)
+                    {
+                        ParticleAnalysisReport *p = &(reports->at(i));
+                        p->imageWidth *= divisor;
+                        p->imageHeight *= divisor;
+                        p->center_mass_x *= divisor;
+                        p->center_mass_y *= divisor;
+                        p->boundingRect.left *= divisor;
+                        p->boundingRect.top *= divisor;
+                        p->boundingRect.width *= divisor;
+                        p->boundingRect.height *= divisor;
+                        p->particleArea *= divisor*divisor;
+                    }
                 }
-                else
-                {
 #ifdef _DUMP_REPORTS
-                    TInfo(("NumParticles = %d", reports->size()));
+                TInfo(("NumParticles = %d", reports->size()));
 #endif
 #ifdef _WRITE_IMAGES
-                    if (!fWroteImages)
+                if (!fWroteImages)
+                {
+                    m_cameraImage.Write("/colorImage.bmp");
+                    if (thresholdImage != NULL)
                     {
-                        m_cameraImage.Write("/colorImage.bmp");
-                        if (thresholdImage != NULL)
-                        {
-                            thresholdImage->Write("/thresholdImage.bmp");
-                        }
-                        if (bigObjImage != NULL)
-                        {
-                            bigObjImage->Write("/bigObjImage.bmp");
-                        }
-                        if (convexHullImage != NULL)
-                        {
-                            convexHullImage->Write("/convexHullImage.bmp");
-                        }
-                        if (filteredImage != NULL)
-                        {
-                            filteredImage->Write("/filteredImage.bmp");
-                        }
-                        fWroteImages = true;
+                        thresholdImage->Write("/thresholdImage.bmp");
                     }
-#endif
-#ifdef _DUMP_REPORTS
-                    for (unsigned i = 0; i < reports->size(); i++)
+                    if (bigObjImage != NULL)
                     {
-                        ParticleAnalysisReport *p = &(reports->at(i));
-                        TInfo(("%d: (%d,%d) [%d,%d/%d,%d]: AR=%5.2f,Q=%5.2f,Per=%4.2f",
-                               i,
-                               p->center_mass_x,
-                               p->center_mass_y,
-                               p->boundingRect.left,
-                               p->boundingRect.top,
-                               p->boundingRect.width,
-                               p->boundingRect.height,
-                               (float)p->boundingRect.width/(float)p->boundingRect.height,
-                               p->particleQuality,
-                               p->particleToImagePercent));
+                        bigObjImage->Write("/bigObjImage.bmp");
                     }
-#endif
-                    CRITICAL_REGION(m_semaphore)
+                    if (convexHullImage != NULL)
                     {
-                        SAFE_DELETE(m_targets);
-                        m_targets = reports;
-                        reports = NULL;
-                        m_vtFlags &= ~VTF_ONE_SHOT;
+                        convexHullImage->Write("/convexHullImage.bmp");
                     }
-                    END_REGION;
+                    if (filteredImage != NULL)
+                    {
+                        filteredImage->Write("/filteredImage.bmp");
+                    }
+                    fWroteImages = true;
                 }
+#endif
+#ifdef _DUMP_REPORTS
+                for (unsigned i = 0; i < reports->size(); i++)
+                {
+                    ParticleAnalysisReport *p = &(reports->at(i));
+                    TInfo(("%d: (%d,%d) [%d,%d/%d,%d]: AR=%5.2f,Q=%5.2f,Per=%4.2f",
+                           i,
+                           p->center_mass_x,
+                           p->center_mass_y,
+                           p->boundingRect.left,
+                           p->boundingRect.top,
+                           p->boundingRect.width,
+                           p->boundingRect.height,
+                           (float)p->boundingRect.width/(float)p->boundingRect.height,
+                           p->particleQuality,
+                           p->particleToImagePercent));
+                }
+#endif
+                PublishTargets(reports, frameNumber, frameTime);
+                SAFE_DELETE(reports);
+                fSuccess = true;
             }
+        }
+#ifdef _VISION_PERF
+        TInfo(("Total Elapsed Time = %d", totalTime));
+#endif
+        UINT32 currTime = GetUsecTime();
+        m_procTime = (UINT32)(VT_SMOOTHING*(currTime - procStartTime) +
+                              (1.0 - VT_SMOOTHING)*m_procTime);
+        m_latency = (UINT32)(VT_SMOOTHING*(currTime - frameTime) +
+                             (1.0 - VT_SMOOTHING)*m_latency);
+        if ((m_vtFlags & (VTF_ADAPTIVE_RATE | VTF_BENCHMARK)) ==
+            VTF_ADAPTIVE_RATE)
+        {
+            AdjustOperatingPoint();
+        }
+        SAFE_DELETE(filteredImage);
+        SAFE_DELETE(convexHullImage);
+        SAFE_DELETE(bigObjImage);
+        SAFE_DELETE(thresholdImage);
+
+        TExitMsg(("=%x", fSuccess));
+        return fSuccess;
+    }   //ProcessFrame
+
+public:
+
+    /**
+     * This function checks for a fresh image and search for targets.
+     */
+    void
+    ProcessImage(
+        void
+        )
+    {
+        TLevel(FUNC);
+        TEnter();
+
+        if (((m_vtFlags & (VTF_ENABLED | VTF_ONE_SHOT)) != 0) &&
+            ((m_vtFlags & VTF_BENCHMARK) == 0) &&
+            m_camera->IsFreshImage())
+        {
+            CRITICAL_REGION(m_frameSemaphore)
+            {
+                UINT32 procStartTime = GetUsecTime();
+                UINT32 frameNumber = 0;
+                UINT32 frameTime = procStartTime;
 #ifdef _VISION_PERF
-            TInfo(("Total Elapsed Time = %d", totalTime));
+                UINT32 startTime = GetMsecTime();
 #endif
-            SAFE_DELETE(filteredImage);
-            SAFE_DELETE(convexHullImage);
-            SAFE_DELETE(bigObjImage);
-            SAFE_DELETE(thresholdImage);
+
+                StartStage(VT_STAGE_ACQUIRE);
+                m_camera->GetImage(&m_cameraImage, &frameNumber, &frameTime);
+                EndStage(VT_STAGE_ACQUIRE, NULL);
+#ifdef _VISION_PERF
+                TInfo(("AcquireImageTime = %d", GetMsecTime() - startTime));
+#endif
+                ProcessFrame(procStartTime, frameNumber, frameTime);
+            }
+            END_REGION;
         }
         
         TExit();
     }   //ProcessImage
 
+    /**
+     * This function loads a recorded image from a file and searches it for
+     * targets the same way as a camera image. It is only allowed in
+     * benchmark mode so that camera images are not processed at the same
+     * time.
+     *
+     * @param fileName Specifies the path of the image file.
+     *
+     * @return Returns true if the target reports are published, false
+     *         otherwise.
+     */
+    bool
+    ProcessImageFile(
+        const char *fileName
+        )
+    {
+        bool fSuccess = false;
+
+        TLevel(API);
+        TEnterMsg(("file=%s", fileName));
+
+        if (m_vtFlags & VTF_BENCHMARK)
+        {
+            CRITICAL_REGION(m_frameSemaphore)
+            {
+                UINT32 procStartTime = GetUsecTime();
+                int rc;
+
+                StartStage(VT_STAGE_ACQUIRE);
+                rc = imaqReadFile(m_cameraImage.GetImaqImage(),
+                                  fileName, NULL, NULL);
+                EndStage(VT_STAGE_ACQUIRE, NULL);
+                if (rc == 0)
+                {
+                    TErr(("Failed to read image file %s (err=%d).",
+                          fileName, imaqGetLastError()));
+                }
+                else
+                {
+                    m_fileFrameNumber++;
+                    fSuccess = ProcessFrame(procStartTime,
+                                            m_fileFrameNumber,
+                                            procStartTime);
+                }
+            }
+            END_REGION;
+        }
+        else
+        {
+            TErr(("Benchmark mode is not enabled."));
+        }
+
+        TExitMsg(("=%x", fSuccess));
+        return fSuccess;
+    }   //ProcessImageFile
+
     /**
      * This function checks if the vision task is enabled.
      *
@@ -368,6 +1000,227 @@ public:
         TExit();
     }   //SetTaskWaitPeriod
 
+    /**
+     * This function enables or disables adaptive rate control. When enabled,
+     * the camera frame rate, the camera resolution and the task wait period
+     * are adjusted to keep the vision pipeline within the given portion of
+     * the CPU and the main loop within its period. The camera resolution at
+     * the time of the call is the reference resolution; target reports are
+     * always given in reference resolution pixels.
+     *
+     * @param fEnable If true, enables adaptive rate control, disables
+     *        otherwise.
+     * @param cpuBudget Specifies the portion of the CPU the vision pipeline
+     *        may use (0.0 to 1.0).
+     */
+    void
+    SetAdaptiveRate(
+        bool fEnable,
+        float cpuBudget = 0.3
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("fEnable=%x,budget=%f", fEnable, cpuBudget));
+
+        if (fEnable)
+        {
+            if ((m_vtFlags & VTF_ADAPTIVE_RATE) == 0)
+            {
+                m_refResolution = m_camera->GetResolution();
+                SetOperatingPoint(VT_NORMAL_OPPOINT);
+            }
+            m_cpuBudget = cpuBudget;
+            m_vtFlags |= VTF_ADAPTIVE_RATE;
+        }
+        else
+        {
+            m_vtFlags &= ~VTF_ADAPTIVE_RATE;
+        }
+
+        TExit();
+    }   //SetAdaptiveRate
+
+    /**
+     * This function enables or disables fast tracking. While fast tracking,
+     * adaptive rate control runs the camera at its highest rate so that a
+     * target can be followed closely.
+     *
+     * @param fEnable If true, enables fast tracking, disables otherwise.
+     */
+    void
+    SetFastTracking(
+        bool fEnable
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("fEnable=%x", fEnable));
+
+        if (fEnable)
+        {
+            m_vtFlags |= VTF_FAST_TRACKING;
+        }
+        else
+        {
+            m_vtFlags &= ~VTF_FAST_TRACKING;
+        }
+
+        TExit();
+    }   //SetFastTracking
+
+    /**
+     * This function reports the load of the main robot loop to adaptive rate
+     * control.
+     *
+     * @param loopLoad Specifies the loop execution time over the loop period.
+     */
+    void
+    SetLoopLoad(
+        float loopLoad
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("loopLoad=%f", loopLoad));
+
+        m_loopLoad = loopLoad;
+
+        TExit();
+    }   //SetLoopLoad
+
+    /**
+     * This function gets the current operating point of adaptive rate
+     * control.
+     *
+     * @return Returns the operating point index, higher is faster.
+     */
+    int
+    GetOperatingPoint(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%d", m_opPoint));
+        return m_opPoint;
+    }   //GetOperatingPoint
+
+    /**
+     * This function gets the smoothed time the vision pipeline takes to
+     * process a frame.
+     *
+     * @return Returns the processing time in usec.
+     */
+    UINT32
+    GetProcessTime(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%d", m_procTime));
+        return m_procTime;
+    }   //GetProcessTime
+
+    /**
+     * This function gets the smoothed latency from the time a frame is
+     * received from the camera to the time its targets are available.
+     *
+     * @return Returns the latency in usec.
+     */
+    UINT32
+    GetLatency(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%d", m_latency));
+        return m_latency;
+    }   //GetLatency
+
+    /**
+     * This function enables or disables benchmark mode. In benchmark mode,
+     * camera images are not processed and images are fed to the pipeline
+     * with ProcessImageFile instead. Enabling it waits for the frame in
+     * progress to finish. Disabling it withdraws the targets of the
+     * recorded images.
+     *
+     * @param fEnable If true, enables benchmark mode, disables otherwise.
+     */
+    void
+    SetBenchmarkMode(
+        bool fEnable
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("fEnable=%x", fEnable));
+
+        if (fEnable)
+        {
+            m_vtFlags |= VTF_BENCHMARK;
+            semTake(m_frameSemaphore, WAIT_FOREVER);
+            semGive(m_frameSemaphore);
+            //
+            // Recorded frames feed the smoothed times too, keep the camera
+            // values to put back afterwards.
+            //
+            m_savedProcTime = m_procTime;
+            m_savedLatency = m_latency;
+        }
+        else
+        {
+            //
+            // Withdraw the targets of the recorded images. A reader in the
+            // middle of a copy sees m_writeSeq change and retries.
+            //
+            m_publishSeq = 0;
+            MemoryBarrier();
+            m_writeSeq = 0;
+            m_procTime = m_savedProcTime;
+            m_latency = m_savedLatency;
+            m_vtFlags &= ~VTF_BENCHMARK;
+        }
+
+        TExit();
+    }   //SetBenchmarkMode
+
+    /**
+     * This function sets up the perfdata objects to collect the time spent
+     * in each pipeline stage.
+     *
+     * @param stagePerf Points to an array of VT_NUM_STAGES perfdata objects,
+     *        NULL to stop collecting.
+     */
+    void
+    SetStagePerfData(
+        PerfData *stagePerf
+        )
+    {
+        TLevel(API);
+        TEnterMsg(("stagePerf=%p", stagePerf));
+
+        m_stagePerf = stagePerf;
+
+        TExit();
+    }   //SetStagePerfData
+
+    /**
+     * This function gets the number of images and report lists the
+     * pipeline has allocated so far. Each processed frame allocates up to
+     * one object per stage.
+     *
+     * @return Returns the allocation count.
+     */
+    UINT32
+    GetAllocCount(
+        void
+        )
+    {
+        TLevel(API);
+        TEnter();
+        TExitMsg(("=%d", m_allocCount));
+        return m_allocCount;
+    }   //GetAllocCount
+
     /**
      * Constructor for the class object.
      * Create instances of all the components.
@@ -396,18 +1249,43 @@ public:
          , m_filterCriteria(filterCriteria)
          , m_numCriteria(numCriteria)
          , m_taskWaitPeriod(taskWaitPeriod)
-         , m_targets(NULL)
+         , m_writeSeq(0)
+         , m_publishSeq(0)
+         , m_fileFrameNumber(0)
          , m_vtFlags(0)
          , m_task("VisionTask", (FUNCPTR)ProcessImageTask)
          , m_semaphore(0)
+         , m_frameSemaphore(0)
          , m_cameraImage(imageType)
+         , m_stagePerf(NULL)
+         , m_allocCount(0)
+         , m_refResolution(AxisCamera::kResolution_320x240)
+         , m_scaledCriteria(NULL)
+         , m_scaledDivisor(0)
+         , m_opPoint(VT_NORMAL_OPPOINT)
+         , m_cpuBudget(0.0)
+         , m_loopLoad(0.0)
+         , m_procTime(0)
+         , m_latency(0)
+         , m_savedProcTime(0)
+         , m_savedLatency(0)
+         , m_overloadStartTime(0)
+         , m_headroomStartTime(0)
+         , m_trackingDropTime(0)
     {
         TLevel(INIT);
         TEnterMsg(("camera=%p,type=%d,colorTh=%p,sizeTh=%d,criteria=%p,numCrit=%d,waitPeriod=%4.2f",
                     camera, imageType, colorThresholds, sizeThreshold,
                     filterCriteria, numCriteria, taskWaitPeriod));
 
+        if ((filterCriteria != NULL) && (numCriteria > 0))
+        {
+            m_scaledCriteria = new ParticleFilterCriteria2[numCriteria];
+        }
         m_semaphore = semBCreate(SEM_Q_PRIORITY, SEM_FULL);
+        m_frameSemaphore = semMCreate(SEM_Q_PRIORITY |
+                                      SEM_DELETE_SAFE |
+                                      SEM_INVERSION_SAFE);
  
         if (!m_task.Start((INT32)this))
         {
@@ -431,45 +1309,65 @@ public:
 
         SetTaskEnabled(false);
         m_task.Stop();
-        SAFE_DELETE(m_targets);
+        if (m_scaledCriteria != NULL)
+        {
+            delete [] m_scaledCriteria;
+            m_scaledCriteria = NULL;
+        }
         semFlush(m_semaphore);
+        semDelete(m_frameSemaphore);
 
         TExit();
     }   //~VisionTask
 
     /**
-     * This function returns the array of targets found.
+     * This function copies the latest targets found. It does not block or
+     * allocate, so any number of tasks may call it. If the vision task is
+     * not enabled, one frame is processed so that a later call returns
+     * fresh targets.
      *
-     * @return Returns the array of targets found.
+     * @param targets Points to the structure to hold the targets.
+     *
+     * @return Returns true if targets have been published, false otherwise.
      */
-    vector<ParticleAnalysisReport> *
+    bool
     VisionGetTargets(
-        void
+        PVISION_TARGETS targets
         )
     {
-        vector<ParticleAnalysisReport> *targets;
+        UINT32 seq;
 
         TLevel(API);
-        TEnter();
+        TEnterMsg(("targets=%p", targets));
 
-        CRITICAL_REGION(m_semaphore)
+        if ((m_vtFlags & (VTF_ENABLED | VTF_ONE_SHOT)) == 0)
         {
-            if (((m_vtFlags & VTF_ENABLED) == 0) && (m_targets == NULL))
+            CRITICAL_REGION(m_semaphore)
             {
-                //
-                // If vision task is not enabled and we don't have any targets,
-                // let's just do this one shot.
-                //
                 m_vtFlags |= VTF_ONE_SHOT;
             }
-
-            targets = m_targets;
-            m_targets = NULL;
+            END_REGION;
         }
-        END_REGION;
 
-        TExitMsg(("=%p", targets));
-        return targets;
+        //
+        // The buffer we copy is only overwritten once the writer has moved
+        // two frames past it, so a copy is retried only if the writer ran in
+        // the middle of it.
+        //
+        do
+        {
+            seq = m_publishSeq;
+            MemoryBarrier();
+            if (seq == 0)
+            {
+                break;
+            }
+            *targets = m_targetBuffers[seq & 1];
+            MemoryBarrier();
+        } while (m_writeSeq - seq >= 2);
+
+        TExitMsg(("=%x", seq != 0));
+        return seq != 0;
     }   //VisionGetTargets
 
 };  //class VisionTask
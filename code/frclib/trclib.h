@@ -18,6 +18,16 @@
 
 #include <math.h>
 #include <hostlib.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <memLib.h>
+#ifdef _BENCH_PERF
+#include <sockLib.h>
+#include <inetLib.h>
+#include <selectLib.h>
+#include "NetworkTables/ConnectionManager.h"
+#include "NetworkTables/FreeList.h"
+#endif
 //
 // Common and Debugging modules.
 //
@@ -27,6 +37,7 @@
 #include "Console.h"
 #include "DataLogger.h"
 #include "PerfData.h"
+#include "BenchCmd.h"
 //
 // Tasks, Events and State Machines.
 //
@@ -46,6 +57,12 @@
 #include "DSEnhDin.h"
 #include "TrcAccel.h"
 #include "VisionTask.h"
+#ifdef _BENCH_PERF
+#include "VisionBench.h"
+#include "NetTablesBench.h"
+#include "FormatBench.h"
+#include "CameraBench.h"
+#endif
 //
 // Outputs.
 //